@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <PyImathAllocator.h>
+#include <cstdlib>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace PyImath {
+
+namespace {
+
+//
+// Every block carries a header in front of the element storage that
+// records its size class, so that freeArrayMemory does not need to be
+// told the size.  The header is a full alignment unit, which keeps the
+// element storage 64-byte aligned as well.
+//
+const size_t blockAlignment  = 64;
+const size_t headerBytes     = 64;
+
+//
+// Size classes: 64 bytes, then four classes per power of two up to
+// 16MB (80, 96, 112, 128, 160, ...).  Rounding a request up to its
+// class wastes at most a quarter of the block.
+//
+const unsigned minClassLog2  = 6;
+const unsigned maxClassLog2  = 24;
+const size_t   numClasses    = (maxClassLog2 - minClassLog2) * 4 + 1;
+const size_t   unpooledClass = size_t(-1);
+
+//
+// Limits on what a thread keeps on its free lists.
+//
+const size_t   maxCachedBlocks = 8;
+const size_t   maxCachedBytes  = size_t(64) << 20;
+
+struct BlockHeader
+{
+    size_t sizeClass;
+    size_t bytes;
+};
+
+unsigned
+floorLog2 (size_t x)
+{
+    unsigned lg = 0;
+    while (x >>= 1)
+        ++lg;
+    return lg;
+}
+
+size_t
+sizeClassOf (size_t bytes)
+{
+    if (bytes <= (size_t(1) << minClassLog2))
+        return 0;
+    if (bytes > (size_t(1) << maxClassLog2))
+        return unpooledClass;
+
+    // bytes-1 lies in [2^lg, 2^(lg+1)); the classes above 2^lg are
+    // spaced 2^(lg-2) apart
+    unsigned lg = floorLog2 (bytes - 1);
+    size_t steps = (bytes + (size_t(1) << (lg - 2)) - 1) >> (lg - 2);
+    return (lg - minClassLog2) * 4 + steps - 4;
+}
+
+size_t
+classBytes (size_t sizeClass)
+{
+    if (sizeClass == 0)
+        return size_t(1) << minClassLog2;
+
+    unsigned lg = minClassLog2 + unsigned((sizeClass - 1) / 4);
+    return ((sizeClass - 1) % 4 + 5) << (lg - 2);
+}
+
+void *
+alignedAlloc (size_t bytes)
+{
+#if defined(_MSC_VER)
+    void *ptr = _aligned_malloc (bytes, blockAlignment);
+#else
+    void *ptr = 0;
+    if (posix_memalign (&ptr, blockAlignment, bytes) != 0)
+        ptr = 0;
+#endif
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void
+alignedFree (void *ptr)
+{
+#if defined(_MSC_VER)
+    _aligned_free (ptr);
+#else
+    free (ptr);
+#endif
+}
+
+struct ThreadCache
+{
+    void *   blocks[numClasses][maxCachedBlocks];
+    size_t   count[numClasses];
+    size_t   cachedBytes;
+
+    ThreadCache () : cachedBytes (0)
+    {
+        for (size_t c = 0; c < numClasses; ++c)
+            count[c] = 0;
+    }
+
+    ~ThreadCache () { release(); }
+
+    void release ()
+    {
+        for (size_t c = 0; c < numClasses; ++c)
+        {
+            while (count[c] > 0)
+                alignedFree (blocks[c][--count[c]]);
+        }
+        cachedBytes = 0;
+    }
+};
+
+//
+// The cache pointer and the flag are trivially destructible, so they
+// can still be looked at while the thread is exiting; the reaper frees
+// the cache at thread exit, after which blocks go straight back to the
+// system.
+//
+thread_local ThreadCache *threadCache = 0;
+thread_local bool threadCacheReleased = false;
+
+struct ThreadCacheReaper
+{
+    ~ThreadCacheReaper ()
+    {
+        delete threadCache;
+        threadCache = 0;
+        threadCacheReleased = true;
+    }
+};
+
+ThreadCache *
+getThreadCache ()
+{
+    if (threadCacheReleased)
+        return 0;
+    if (!threadCache)
+    {
+        static thread_local ThreadCacheReaper reaper;
+        (void) reaper;
+        threadCache = new ThreadCache;
+    }
+    return threadCache;
+}
+
+} // namespace
+
+void *
+allocateArrayMemory (size_t bytes)
+{
+    size_t sizeClass = sizeClassOf (bytes);
+
+    void *block = 0;
+    if (sizeClass != unpooledClass)
+    {
+        bytes = classBytes (sizeClass);
+        ThreadCache *cache = getThreadCache();
+        if (cache && cache->count[sizeClass] > 0)
+        {
+            block = cache->blocks[sizeClass][--cache->count[sizeClass]];
+            cache->cachedBytes -= bytes;
+        }
+    }
+
+    if (!block)
+    {
+        if (bytes > size_t(-1) - headerBytes)
+            throw std::bad_alloc();
+        block = alignedAlloc (headerBytes + bytes);
+    }
+
+    BlockHeader *header = static_cast<BlockHeader *>(block);
+    header->sizeClass = sizeClass;
+    header->bytes = bytes;
+    return static_cast<char *>(block) + headerBytes;
+}
+
+void
+freeArrayMemory (void *ptr)
+{
+    if (!ptr)
+        return;
+
+    void *block = static_cast<char *>(ptr) - headerBytes;
+    const BlockHeader *header = static_cast<const BlockHeader *>(block);
+
+    if (header->sizeClass != unpooledClass)
+    {
+        ThreadCache *cache = getThreadCache();
+        if (cache &&
+            cache->count[header->sizeClass] < maxCachedBlocks &&
+            cache->cachedBytes + header->bytes <= maxCachedBytes)
+        {
+            cache->blocks[header->sizeClass][cache->count[header->sizeClass]++] = block;
+            cache->cachedBytes += header->bytes;
+            return;
+        }
+    }
+
+    alignedFree (block);
+}
+
+void
+releaseArrayMemoryCache ()
+{
+    if (threadCache)
+        threadCache->release();
+}
+
+} // namespace PyImath
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef _PyImathAllocator_h_
+#define _PyImathAllocator_h_
+
+#include <PyImathExport.h>
+#include <boost/shared_array.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <cstddef>
+#include <new>
+
+namespace PyImath {
+
+//
+// Storage for the element buffers of the array types.  Blocks are 64-byte
+// aligned and come in a fixed set of size classes (four per power of two);
+// freed blocks are kept on a small per-thread free list for their class so
+// that the temporaries created by chains of array operations are recycled
+// instead of going back to the system allocator every time.  Blocks above
+// the largest class are allocated and freed directly.
+//
+PYIMATH_EXPORT void *allocateArrayMemory (size_t bytes);
+PYIMATH_EXPORT void  freeArrayMemory (void *ptr);
+
+//
+// Release the blocks cached on the calling thread's free lists.
+//
+PYIMATH_EXPORT void  releaseArrayMemoryCache ();
+
+//
+// Typed helpers: allocate and default-initialize (i.e. leave builtin
+// types uninitialized, as new T[n] does) length elements, and destroy
+// and free them again.
+//
+template <class T>
+T *
+newArrayElements (size_t length)
+{
+    if (length > size_t(-1) / sizeof(T))
+        throw std::bad_alloc();
+
+    T *ptr = static_cast<T *>(allocateArrayMemory (length * sizeof(T)));
+    if (boost::has_trivial_destructor<T>::value)
+    {
+        for (size_t i = 0; i < length; ++i)
+            new (ptr + i) T;
+        return ptr;
+    }
+
+    size_t i = 0;
+    try
+    {
+        for (; i < length; ++i)
+            new (ptr + i) T;
+    }
+    catch (...)
+    {
+        while (i > 0)
+            ptr[--i].~T();
+        freeArrayMemory (ptr);
+        throw;
+    }
+    return ptr;
+}
+
+template <class T>
+void
+deleteArrayElements (T *ptr, size_t length)
+{
+    if (!ptr) return;
+    if (!boost::has_trivial_destructor<T>::value)
+    {
+        for (size_t i = length; i > 0; --i)
+            ptr[i-1].~T();
+    }
+    freeArrayMemory (ptr);
+}
+
+template <class T>
+class ArrayElementsDeleter
+{
+    size_t _length;
+
+  public:
+    explicit ArrayElementsDeleter (size_t length) : _length (length) {}
+    void operator () (T *ptr) const { deleteArrayElements (ptr, _length); }
+};
+
+template <class T>
+boost::shared_array<T>
+allocateArray (size_t length)
+{
+    // shared_array calls the deleter itself if it fails to allocate its count
+    return boost::shared_array<T> (newArrayElements<T> (length),
+                                   ArrayElementsDeleter<T> (length));
+}
+
+} // namespace PyImath
+
+#endif // _PyImathAllocator_h_
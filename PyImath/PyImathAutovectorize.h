@@ -37,6 +37,12 @@
 
 #include "python_include.h"
 #include <boost/mpl/size.hpp>
+#include <boost/mpl/at.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/fold.hpp>
+#include <boost/mpl/long.hpp>
+#include <boost/mpl/push_back.hpp>
 #include <boost/mpl/pop_front.hpp>
 #include <boost/mpl/push_front.hpp>
 #include <boost/mpl/front.hpp>
@@ -51,28 +57,61 @@
 #include <boost/mpl/count.hpp>
 #include <boost/mpl/or.hpp>
 #include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_reference.hpp>
 #include <boost/type_traits/function_traits.hpp>
 #include <boost/static_assert.hpp>
-#include <boost/python/args.hpp>
+#include <array>
 #include <iostream>
 #include <string>
 #include <PyImathFixedArray.h>
 #include <PyImathTask.h>
 #include <PyImathUtil.h>
-#include <IexMathFloatExc.h>
+#include <PyImathMathExc.h>
 
 
-template<int N>
+namespace PyImath {
+
+//
+// Keyword argument names for a vectorized binding, built with args(...)
+// below.  These stand in for the boost::python::args keywords the bindings
+// originally took.
+//
+template <int N>
 struct keywords
 {
     std::array<py::arg, N> elements;
 };
 
+inline keywords<1> args(const char *a0)
+{
+    keywords<1> k = {{{ py::arg(a0) }}};
+    return k;
+}
 
-namespace PyImath {
+inline keywords<2> args(const char *a0, const char *a1)
+{
+    keywords<2> k = {{{ py::arg(a0), py::arg(a1) }}};
+    return k;
+}
+
+inline keywords<3> args(const char *a0, const char *a1, const char *a2)
+{
+    keywords<3> k = {{{ py::arg(a0), py::arg(a1), py::arg(a2) }}};
+    return k;
+}
 
 struct op_with_precomputation {};
 
+//
+// Rough per-element cost of an op, in the units of Task::elementCost().
+// Ops much heavier than a scalar arithmetic op specialize this so that
+// dispatchTask() splits their arrays across workers at shorter lengths.
+//
+template <class Op> struct op_cost { static const size_t value = 1; };
+
 namespace detail {
 
 
@@ -254,6 +293,46 @@ struct direct_access_value<const PyImath::FixedArray<T> &>
     static inline const T & apply(const PyImath::FixedArray<T> &arg, size_t i) { return arg.direct_index(i); }
 };
 
+//
+// sequential_access steps through the elements start, start+1, ... of an
+// argument.  The loops over masked arrays use it rather than
+// access_value, so that a run-length encoded mask is walked with a
+// cursor instead of being searched for every element.
+//
+template <class T>
+struct sequential_access
+{
+    T &arg;
+    sequential_access(T &a, size_t start) : arg(a) {}
+    inline T & next() { return arg; }
+};
+
+template <class T>
+struct sequential_access<T &>
+{
+    T &arg;
+    sequential_access(T &a, size_t start) : arg(a) {}
+    inline T & next() { return arg; }
+};
+
+template <class T>
+struct sequential_access<PyImath::FixedArray<T> &>
+{
+    PyImath::FixedArray<T> &arg;
+    PyImath::FixedArrayMask::Cursor cursor;
+    sequential_access(PyImath::FixedArray<T> &a, size_t start) : arg(a), cursor(a.mask(), start) {}
+    inline T & next() { return arg.direct_index(cursor.next()); }
+};
+
+template <class T>
+struct sequential_access<const PyImath::FixedArray<T> &>
+{
+    const PyImath::FixedArray<T> &arg;
+    PyImath::FixedArrayMask::Cursor cursor;
+    sequential_access(const PyImath::FixedArray<T> &a, size_t start) : arg(a), cursor(a.mask(), start) {}
+    inline const T & next() { return arg.direct_index(cursor.next()); }
+};
+
 
 //-----------------------------------------------------------------------------------------
 
@@ -324,6 +403,26 @@ measure_arguments(const arg1_type &arg1, const arg2_type &arg2, const arg3_type
     return len.first;
 }
 
+//
+// unaliased_argument returns the argument of an in-place operation, or a
+// copy of it if it overlaps the array being modified (e.g. a[1:] += a[:-1],
+// where both sides are views of a), so that every element is read before
+// it is written.
+//
+template <class class_type, class arg_type>
+inline const arg_type &
+unaliased_argument(const class_type &cls, const arg_type &arg)
+{
+    return arg;
+}
+
+template <class class_type, class T>
+inline PyImath::FixedArray<T>
+unaliased_argument(const class_type &cls, const PyImath::FixedArray<T> &arg)
+{
+    return cls.overlaps(arg) ? arg.copy() : arg;
+}
+
 //-----------------------------------------------------------------------------------------
 
 template <class T>
@@ -365,11 +464,15 @@ struct VectorizedOperation1 : public Task
 
     VectorizedOperation1(result_type &r, arg1_type a1) : retval(r), arg1(a1) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(retval,arg1)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
             for (size_t i=start; i<end; ++i) {
-                access_value<result_type &>::apply(retval,i) = Op::apply(access_value<arg1_type>::apply(arg1,i));
+                r.next() = Op::apply(a1.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -388,12 +491,16 @@ struct VectorizedOperation2 : public Task
 
     VectorizedOperation2(result_type &r, arg1_type a1, arg2_type a2) : retval(r), arg1(a1), arg2(a2) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(retval,arg1,arg2)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            sequential_access<arg2_type> a2(arg2,start);
             for (size_t i=start; i<end; ++i) {
-                access_value<result_type &>::apply(retval,i) = Op::apply(access_value<arg1_type>::apply(arg1,i),
-                                                                         access_value<arg2_type>::apply(arg2,i));
+                r.next() = Op::apply(a1.next(), a2.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -414,13 +521,17 @@ struct VectorizedOperation3 : public Task
 
     VectorizedOperation3(result_type &r, arg1_type a1, arg2_type a2, arg3_type a3) : retval(r), arg1(a1), arg2(a2), arg3(a3) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(retval,arg1,arg2,arg3)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            sequential_access<arg2_type> a2(arg2,start);
+            sequential_access<arg3_type> a3(arg3,start);
             for (size_t i=start; i<end; ++i) {
-                access_value<result_type &>::apply(retval,i) = Op::apply(access_value<arg1_type>::apply(arg1,i),
-                                                                         access_value<arg2_type>::apply(arg2,i),
-                                                                         access_value<arg3_type>::apply(arg3,i));
+                r.next() = Op::apply(a1.next(), a2.next(), a3.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -445,7 +556,7 @@ struct VectorizedFunction1 {
     static result_type
     apply(arg1_type arg1)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(arg1);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -477,7 +588,7 @@ struct VectorizedFunction2 {
     static result_type
     apply(arg1_type arg1, arg2_type arg2)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(arg1,arg2);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -510,7 +621,7 @@ struct VectorizedFunction3 {
     static result_type
     apply(arg1_type arg1, arg2_type arg2, arg3_type arg3)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(arg1,arg2,arg3);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -528,15 +639,57 @@ struct VectorizedFunction3 {
     }
 };
 
+//
+// def_with_keywords expands the keyword names into individual py::arg
+// annotations, for either a py::module or a py::class_ target.
+//
+template <class Target, class Func, class... Extra>
+void
+def_with_keywords(Target &target, const std::string &name, Func func, const std::string &doc,
+                  const keywords<1> &args, const Extra &... extra)
+{
+    target.def(name.c_str(), func, doc.c_str(), args.elements[0], extra...);
+}
+
+template <class Target, class Func, class... Extra>
+void
+def_with_keywords(Target &target, const std::string &name, Func func, const std::string &doc,
+                  const keywords<2> &args, const Extra &... extra)
+{
+    target.def(name.c_str(), func, doc.c_str(), args.elements[0], args.elements[1], extra...);
+}
+
+template <class Target, class Func, class... Extra>
+void
+def_with_keywords(Target &target, const std::string &name, Func func, const std::string &doc,
+                  const keywords<3> &args, const Extra &... extra)
+{
+    target.def(name.c_str(), func, doc.c_str(), args.elements[0], args.elements[1], args.elements[2], extra...);
+}
+
+//
+// the void vectorizations modify the array in place and return a reference
+// to self, which must keep referring to the same python object.
+//
+template <class Func>
+inline py::return_value_policy
+vectorized_return_policy()
+{
+    return is_same<void,typename function_traits<Func>::result_type>::value
+        ? py::return_value_policy::reference_internal
+        : py::return_value_policy::automatic;
+}
+
 template <class Op, class Func, class Keywords>
 struct function_binding
 {
+    py::module &_module;
     std::string _name, _doc;
     const Keywords &_args;
 
 
-    function_binding(const std::string &name, const std::string &doc,const Keywords &args)
-        : _name(name), _doc(doc), _args(args)
+    function_binding(py::module &module, const std::string &name, const std::string &doc,const Keywords &args)
+        : _module(module), _name(name), _doc(doc), _args(args)
     {}
 
     template <class Vectorize>
@@ -550,24 +703,24 @@ struct function_binding
             >,
             long_<function_traits<Func>::arity> >::type vectorized_function_type;
         std::string doc = _name + vectorized_function_type::format_arguments(_args) + _doc;
-        py::def(_name.c_str(),&vectorized_function_type::apply,doc.c_str(),_args);
+        def_with_keywords(_module,_name,&vectorized_function_type::apply,doc,_args);
     }
 };
 
 template <class Op,class Func,class Keywords>
 function_binding<Op,Func,Keywords>
-build_function_binding(Func *func,const std::string &name,const std::string &doc,const Keywords &args)
+build_function_binding(py::module &module,Func *func,const std::string &name,const std::string &doc,const Keywords &args)
 {
-    return function_binding<Op,Func,Keywords>(name,doc,args);
+    return function_binding<Op,Func,Keywords>(module,name,doc,args);
 }
 
 template <class Op,class Vectorizable,class Keywords>
 struct generate_bindings_struct
 {
     //BOOST_STATIC_ASSERT(size<Vectorizable>::value == function_traits<Op::apply>::arity);
-    static void apply(const std::string &name,const std::string &doc,const Keywords &args) {
+    static void apply(py::module &module,const std::string &name,const std::string &doc,const Keywords &args) {
         for_each<typename allowable_vectorizations<Vectorizable>::type>(
-            build_function_binding<Op>(Op::apply,name,doc,args)
+            build_function_binding<Op>(module,Op::apply,name,doc,args)
             );
     }
 };
@@ -587,11 +740,14 @@ struct VectorizedVoidOperation0 : public Task
 
     VectorizedVoidOperation0(class_type c) : cls(c) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(cls)) {
+            sequential_access<class_type> c(cls,start);
             for (size_t i=start; i<end; ++i) {
-                Op::apply(access_value<class_type>::apply(cls,i));
+                Op::apply(c.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -609,12 +765,15 @@ struct VectorizedVoidOperation1 : public Task
 
     VectorizedVoidOperation1(class_type c, arg1_type a1) : cls(c), arg1(a1) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(cls,arg1)) {
+            sequential_access<class_type> c(cls,start);
+            sequential_access<arg1_type> a1(arg1,start);
             for (size_t i=start; i<end; ++i) {
-                Op::apply(access_value<class_type>::apply(cls,i),
-                          access_value<arg1_type>::apply(arg1,i));
+                Op::apply(c.next(), a1.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -633,17 +792,22 @@ struct VectorizedMaskedVoidOperation1 : public Task
 
     VectorizedMaskedVoidOperation1(class_type c, arg1_type a1) : cls(c), arg1(a1) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
+        PyImath::FixedArrayMask::Cursor raw(cls.mask(),start);
         if (any_masked(arg1)) {
             for (size_t i=start; i<end; ++i) {
-                Op::apply(access_value<class_type>::apply(cls,i),
-                          access_value<arg1_type>::apply(arg1,cls.raw_ptr_index(i)));
+                size_t ri = raw.next();
+                Op::apply(cls.direct_index(ri),
+                          access_value<arg1_type>::apply(arg1,ri));
             }
         } else {
             for (size_t i=start; i<end; ++i) {
-                Op::apply(access_value<class_type>::apply(cls,i),
-                          direct_access_value<arg1_type>::apply(arg1,cls.raw_ptr_index(i)));
+                size_t ri = raw.next();
+                Op::apply(cls.direct_index(ri),
+                          direct_access_value<arg1_type>::apply(arg1,ri));
             }
         }
     }
@@ -658,13 +822,16 @@ struct VectorizedVoidOperation2 : public Task
 
     VectorizedVoidOperation2(class_type c, arg1_type a1, arg2_type a2) : cls(c), arg1(a1), arg2(a2) {}
 
+    size_t elementCost() const { return op_cost<Op>::value; }
+
     void execute(size_t start, size_t end)
     {
         if (any_masked(cls,arg1,arg2)) {
+            sequential_access<class_type> c(cls,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            sequential_access<arg2_type> a2(arg2,start);
             for (size_t i=start; i<end; ++i) {
-                Op::apply(access_value<class_type>::apply(cls,i),
-                          access_value<arg1_type>::apply(arg1,i),
-                          access_value<arg2_type>::apply(arg2,i));
+                Op::apply(c.next(), a1.next(), a2.next());
             }
         } else {
             for (size_t i=start; i<end; ++i) {
@@ -688,7 +855,7 @@ struct VectorizedVoidMemberFunction0 {
     static class_type
     apply(class_type cls)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls);
         op_precompute<Op>::apply(len);
         VectorizedVoidOperation0<Op,class_type> vop(cls);
@@ -710,10 +877,11 @@ struct VectorizedVoidMemberFunction1 {
     static class_type
     apply(class_type cls, arg1_type arg1)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls,arg1);
         op_precompute<Op>::apply(len);
-        VectorizedVoidOperation1<Op,class_type,arg1_type> vop(cls,arg1);
+        const auto &a1 = unaliased_argument(cls,arg1);
+        VectorizedVoidOperation1<Op,class_type,arg1_type> vop(cls,a1);
         dispatchTask(vop,len);
         mathexcon.handleOutstandingExceptions();
         return cls;
@@ -745,20 +913,21 @@ struct VectorizedVoidMaskableMemberFunction1 {
     static class_type
     apply(class_type cls, arg1_type arg1)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = cls.match_dimension(arg1, false);
         op_precompute<Op>::apply(len);
+        const auto &a1 = unaliased_argument(cls,arg1);
 
         if (cls.isMaskedReference() && arg1.len() == cls.unmaskedLength())
         {
             // class is masked, and the unmasked length matches the right hand side
-            VectorizedMaskedVoidOperation1<Op,class_type,arg1_type> vop(cls,arg1);
+            VectorizedMaskedVoidOperation1<Op,class_type,arg1_type> vop(cls,a1);
             dispatchTask(vop,len);
         }
         else
         {
             // the two arrays match length (masked or otherwise), use the standard path.
-            VectorizedVoidOperation1<Op,class_type,arg1_type> vop(cls,arg1);
+            VectorizedVoidOperation1<Op,class_type,arg1_type> vop(cls,a1);
             dispatchTask(vop,len);
         }
            
@@ -787,10 +956,12 @@ struct VectorizedVoidMemberFunction2 {
     static class_type
     apply(class_type cls, arg1_type arg1, arg2_type arg2)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls,arg1,arg2);
         op_precompute<Op>::apply(len);
-        VectorizedVoidOperation2<Op,class_type,arg1_type,arg2_type> vop(cls,arg1,arg2);
+        const auto &a1 = unaliased_argument(cls,arg1);
+        const auto &a2 = unaliased_argument(cls,arg2);
+        VectorizedVoidOperation2<Op,class_type,arg1_type,arg2_type> vop(cls,a1,a2);
         dispatchTask(vop,len);
         mathexcon.handleOutstandingExceptions();
         return cls;
@@ -817,7 +988,7 @@ struct VectorizedMemberFunction0 {
     static result_type
     apply(class_type cls)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -841,7 +1012,7 @@ struct VectorizedMemberFunction1 {
     static result_type
     apply(class_type cls, arg1_type arg1)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls,arg1);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -873,7 +1044,7 @@ struct VectorizedMemberFunction2 {
     static result_type
     apply(class_type cls, arg1_type arg1, arg2_type arg2)
     {
-        PY_IMATH_LEAVE_PYTHON;
+        MATH_EXC_ON;
         size_t len = measure_arguments(cls,arg1,arg2);
         op_precompute<Op>::apply(len);
         result_type retval = create_uninitalized_return_value<result_type>::apply(len);
@@ -916,10 +1087,6 @@ struct member_function_binding
                          VectorizedVoidMemberFunction2<Op,Vectorize,Func>,
                          VectorizedMemberFunction2<Op,Vectorize,Func> >::type member_func2_type;
 
-        typedef typename if_<is_same<void,typename function_traits<Func>::result_type>,
-                         py::return_internal_reference<>,  // the void vectorizations return a reference to self
-                         py::default_call_policies>::type call_policies;
-
         typedef typename at<vector<
             int,  // unused, arity 0
             int,  // unused, arity 1 - first argument corresponds to the class type
@@ -928,7 +1095,7 @@ struct member_function_binding
             >,
             long_<function_traits<Func>::arity> >::type vectorized_function_type;
         std::string doc = _name + vectorized_function_type::format_arguments(_args) + _doc;
-        _cls.def(_name.c_str(),&vectorized_function_type::apply,doc.c_str(),_args,call_policies());
+        def_with_keywords(_cls,_name,&vectorized_function_type::apply,doc,_args,vectorized_return_policy<Func>());
     }
 };
 
@@ -956,32 +1123,28 @@ generate_single_member_binding(Cls &cls,Func *func,const std::string &name,const
                          VectorizedVoidMemberFunction0<Op,boost::mpl::vector<>,Func>,
                          VectorizedMemberFunction0<Op,boost::mpl::vector<>,Func> >::type vectorized_function_type;
 
-    typedef typename if_<is_same<void,typename function_traits<Func>::result_type>,
-                         py::return_internal_reference<>,  // the void vectorizations return a reference to self
-                         py::default_call_policies>::type call_policies;
-
-    cls.def(name.c_str(),&vectorized_function_type::apply,doc.c_str(),call_policies());
+    cls.def(name.c_str(),&vectorized_function_type::apply,doc.c_str(),vectorized_return_policy<Func>());
 }
 
 } // namespace detail
 
 // TODO: update for arg("name")=default_value syntax
 template <class Op,class Vectorizable0>
-void generate_bindings(const std::string &name,const std::string &doc,const keywords<1> &args) {
+void generate_bindings(py::module &m,const std::string &name,const std::string &doc,const keywords<1> &args) {
     using namespace detail;
-    generate_bindings_struct<Op,vector<Vectorizable0>,keywords<1> >::apply(name,doc,args);
+    generate_bindings_struct<Op,vector<Vectorizable0>,keywords<1> >::apply(m,name,doc,args);
 }
 
 template <class Op,class Vectorizable0, class Vectorizable1>
-void generate_bindings(const std::string &name,const std::string &doc,const keywords<2> &args) {
+void generate_bindings(py::module &m,const std::string &name,const std::string &doc,const keywords<2> &args) {
     using namespace detail;
-    generate_bindings_struct<Op,vector<Vectorizable0,Vectorizable1>,keywords<2> >::apply(name,doc,args);
+    generate_bindings_struct<Op,vector<Vectorizable0,Vectorizable1>,keywords<2> >::apply(m,name,doc,args);
 }
 
 template <class Op,class Vectorizable0, class Vectorizable1, class Vectorizable2>
-void generate_bindings(const std::string &name,const std::string &doc,const keywords<3> &args) {
+void generate_bindings(py::module &m,const std::string &name,const std::string &doc,const keywords<3> &args) {
     using namespace detail;
-    generate_bindings_struct<Op,vector<Vectorizable0,Vectorizable1,Vectorizable2>,keywords<3> >::apply(name,doc,args);
+    generate_bindings_struct<Op,vector<Vectorizable0,Vectorizable1,Vectorizable2>,keywords<3> >::apply(m,name,doc,args);
 }
 
 template <class Op,class Cls>
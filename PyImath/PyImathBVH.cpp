@@ -0,0 +1,514 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "python_include.h"
+#include <PyImathBVH.h>
+#include "PyImathDecorators.h"
+#include "PyImathExport.h"
+#include <PyImath.h>
+#include <PyImathMathExc.h>
+#include <PyImathBox.h>
+#include <PyImathTask.h>
+#include <PyImathUtil.h>
+#include <ImathBoxAlgo.h>
+#include <Iex.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace PyImath{
+
+using namespace IMATH_NAMESPACE;
+
+template <class T> struct BVHName {static const char *value;};
+template <> const char *BVHName<float>::value = "BVHf";
+template <> const char *BVHName<double>::value = "BVHd";
+
+//
+// Building blocks of the tree build and refit.  Everything that touches
+// each primitive or each leaf runs through dispatchTask; the sort of the
+// Morton codes and the emission of the nodes are serial.
+//
+
+template <class T>
+static inline Box<Vec3<T> >
+primitiveBox(const Box<Vec3<T> > &b)
+{
+    return b;
+}
+
+template <class T>
+static inline Box<Vec3<T> >
+primitiveBox(const Vec3<T> &p)
+{
+    return Box<Vec3<T> >(p, p);
+}
+
+template <class T, class S>
+struct BVH_CopyPrimitives : public Task
+{
+    const FixedArray<S> &src;
+    std::vector<Box<Vec3<T> > > &dst;
+
+    BVH_CopyPrimitives(const FixedArray<S> &s, std::vector<Box<Vec3<T> > > &d)
+        : src(s), dst(d) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            dst[i] = primitiveBox(src[i]);
+    }
+};
+
+// Spread the low 10 bits of v so that there are two zero bits between
+// each of them.
+static inline unsigned int
+expandBits(unsigned int v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+template <class T>
+struct BVH_MortonCodes : public Task
+{
+    const std::vector<Box<Vec3<T> > > &boxes;
+    const Box<Vec3<T> > &centerBounds;
+    std::vector<unsigned int> &codes;
+
+    BVH_MortonCodes(const std::vector<Box<Vec3<T> > > &b,
+                    const Box<Vec3<T> > &c,
+                    std::vector<unsigned int> &r)
+        : boxes(b), centerBounds(c), codes(r) {}
+
+    size_t elementCost() const { return 8; }
+
+    void execute(size_t start, size_t end)
+    {
+        Vec3<T> size = centerBounds.size();
+        Vec3<T> scale;
+        for (int j = 0; j < 3; ++j)
+            scale[j] = size[j] > T(0) ? T(1023) / size[j] : T(0);
+
+        for (size_t i = start; i < end; ++i)
+        {
+            const Box<Vec3<T> > &b = boxes[i];
+            if (b.isEmpty())
+            {
+                codes[i] = 0;
+                continue;
+            }
+
+            Vec3<T> c = (b.min + b.max) * T(0.5) - centerBounds.min;
+            unsigned int q[3];
+            for (int j = 0; j < 3; ++j)
+                q[j] = (unsigned int) std::min(std::max(c[j] * scale[j], T(0)), T(1023));
+
+            codes[i] = (expandBits(q[0]) << 2) | (expandBits(q[1]) << 1) | expandBits(q[2]);
+        }
+    }
+};
+
+template <class T>
+struct BVH_RefitLeaves : public Task
+{
+    typedef typename BoundingVolumeHierarchy<T>::Node Node;
+
+    const std::vector<Box<Vec3<T> > > &boxes;
+    const std::vector<int> &order;
+    std::vector<Node> &nodes;
+
+    BVH_RefitLeaves(const std::vector<Box<Vec3<T> > > &b,
+                    const std::vector<int> &o,
+                    std::vector<Node> &n)
+        : boxes(b), order(o), nodes(n) {}
+
+    size_t elementCost() const { return 4; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            Node &node = nodes[i];
+            if (node.count == 0)
+                continue;
+
+            node.bounds.makeEmpty();
+            for (int p = node.start; p < node.start + node.count; ++p)
+                node.bounds.extendBy(boxes[order[p]]);
+        }
+    }
+};
+
+struct MortonLess
+{
+    const std::vector<unsigned int> &codes;
+    MortonLess(const std::vector<unsigned int> &c) : codes(c) {}
+    bool operator()(int a, int b) const { return codes[a] < codes[b] || (codes[a] == codes[b] && a < b); }
+};
+
+struct MortonBitClear
+{
+    unsigned int bit;
+    MortonBitClear(unsigned int b) : bit(b) {}
+    bool operator()(unsigned int code) const { return (code & bit) == 0; }
+};
+
+template <class T>
+BoundingVolumeHierarchy<T>::BoundingVolumeHierarchy(const FixedArray<Box> &boxes)
+    : _boxes(boxes.len())
+{
+    BVH_CopyPrimitives<T,Box> task(boxes, _boxes);
+    dispatchTask(task, _boxes.size());
+    build();
+}
+
+template <class T>
+BoundingVolumeHierarchy<T>::BoundingVolumeHierarchy(const FixedArray<Vec> &points)
+    : _boxes(points.len())
+{
+    BVH_CopyPrimitives<T,Vec> task(points, _boxes);
+    dispatchTask(task, _boxes.size());
+    build();
+}
+
+template <class T>
+void
+BoundingVolumeHierarchy<T>::build()
+{
+    size_t len = _boxes.size();
+    if (len > size_t(std::numeric_limits<int>::max()))
+        throw IEX_NAMESPACE::ArgExc("Too many primitives for a bounding volume hierarchy");
+
+    Box centerBounds;
+    for (size_t i = 0; i < len; ++i)
+        if (!_boxes[i].isEmpty())
+            centerBounds.extendBy((_boxes[i].min + _boxes[i].max) * T(0.5));
+
+    std::vector<unsigned int> codes(len);
+    BVH_MortonCodes<T> task(_boxes, centerBounds, codes);
+    dispatchTask(task, len);
+
+    PyReleaseLock pyunlock(worthReleasingLock(len * 16));
+
+    _order.resize(len);
+    for (size_t i = 0; i < len; ++i)
+        _order[i] = int(i);
+    std::sort(_order.begin(), _order.end(), MortonLess(codes));
+
+    std::vector<unsigned int> sorted(len);
+    for (size_t i = 0; i < len; ++i)
+        sorted[i] = codes[_order[i]];
+
+    _nodes.clear();
+    if (len == 0)
+        return;
+
+    _nodes.reserve(2 * ((len + LeafSize - 1) / LeafSize));
+    emit(sorted, 0, int(len));
+    updateBounds();
+}
+
+template <class T>
+int
+BoundingVolumeHierarchy<T>::emit(const std::vector<unsigned int> &codes, int first, int last)
+{
+    int index = int(_nodes.size());
+    _nodes.push_back(Node());
+    _nodes[index].start = first;
+
+    if (last - first <= int(LeafSize))
+    {
+        _nodes[index].count = last - first;
+        _nodes[index].right = -1;
+        return index;
+    }
+
+    //
+    // Split where the highest bit that differs across the range turns on.
+    // Primitives with identical codes are split in the middle.
+    //
+
+    int split;
+    unsigned int diff = codes[first] ^ codes[last - 1];
+    if (diff == 0)
+    {
+        split = (first + last) / 2;
+    }
+    else
+    {
+        unsigned int bit = 1u << 31;
+        while ((bit & diff) == 0)
+            bit >>= 1;
+        split = int(std::partition_point(codes.begin() + first, codes.begin() + last,
+                                         MortonBitClear(bit)) - codes.begin());
+    }
+
+    emit(codes, first, split);
+    int right = emit(codes, split, last);
+
+    _nodes[index].count = 0;
+    _nodes[index].right = right;
+    return index;
+}
+
+template <class T>
+void
+BoundingVolumeHierarchy<T>::updateBounds()
+{
+    BVH_RefitLeaves<T> task(_boxes, _order, _nodes);
+    dispatchTask(task, _nodes.size());
+
+    // children always follow their parent, so a reverse sweep sees both
+    // children of an interior node before the node itself
+    for (size_t i = _nodes.size(); i-- > 0; )
+    {
+        Node &node = _nodes[i];
+        if (node.count != 0)
+            continue;
+
+        node.bounds = _nodes[i + 1].bounds;
+        node.bounds.extendBy(_nodes[node.right].bounds);
+    }
+}
+
+template <class T>
+typename BoundingVolumeHierarchy<T>::Box
+BoundingVolumeHierarchy<T>::bounds() const
+{
+    return _nodes.empty() ? Box() : _nodes[0].bounds;
+}
+
+template <class T>
+void
+BoundingVolumeHierarchy<T>::refit(const FixedArray<Box> &boxes)
+{
+    if (size_t(boxes.len()) != _boxes.size())
+        throw IEX_NAMESPACE::ArgExc("Dimensions of source do not match destination");
+
+    BVH_CopyPrimitives<T,Box> task(boxes, _boxes);
+    dispatchTask(task, _boxes.size());
+    updateBounds();
+}
+
+template <class T>
+void
+BoundingVolumeHierarchy<T>::refit(const FixedArray<Vec> &points)
+{
+    if (size_t(points.len()) != _boxes.size())
+        throw IEX_NAMESPACE::ArgExc("Dimensions of source do not match destination");
+
+    BVH_CopyPrimitives<T,Vec> task(points, _boxes);
+    dispatchTask(task, _boxes.size());
+    updateBounds();
+}
+
+//
+// Queries.  A visitor decides whether a node or primitive box passes; the
+// traversal descends into the nodes that pass and collects the primitives
+// that do.
+//
+
+template <class T>
+template <class Visitor>
+void
+BoundingVolumeHierarchy<T>::traverse(Visitor &visitor, std::vector<int> &result) const
+{
+    if (_nodes.empty())
+        return;
+
+    PyReleaseLock pyunlock(worthReleasingLock(_boxes.size()));
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        const Node &node = _nodes[stack.back()];
+        int index = stack.back();
+        stack.pop_back();
+
+        if (!visitor(node.bounds))
+            continue;
+
+        if (node.count == 0)
+        {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (int p = node.start; p < node.start + node.count; ++p)
+            if (visitor(_boxes[_order[p]]))
+                result.push_back(_order[p]);
+    }
+
+    std::sort(result.begin(), result.end());
+}
+
+static FixedArray<int>
+toIndexArray(const std::vector<int> &indices)
+{
+    FixedArray<int> result(indices.size(), PyImath::UNINITIALIZED);
+    for (size_t i = 0; i < indices.size(); ++i)
+        result.direct_index(i) = indices[i];
+    return result;
+}
+
+template <class T>
+struct BVH_BoxVisitor
+{
+    const Box<Vec3<T> > &box;
+    BVH_BoxVisitor(const Box<Vec3<T> > &b) : box(b) {}
+    bool operator()(const Box<Vec3<T> > &b) const { return box.intersects(b); }
+};
+
+template <class T>
+struct BVH_RayVisitor
+{
+    const Line3<T> &ray;
+    BVH_RayVisitor(const Line3<T> &r) : ray(r) {}
+    bool operator()(const Box<Vec3<T> > &b) const { Vec3<T> ip; return IMATH_NAMESPACE::intersects(b, ray, ip); }
+};
+
+template <class T>
+struct BVH_FrustumVisitor
+{
+    const FrustumTest<T> &frustumTest;
+    BVH_FrustumVisitor(const FrustumTest<T> &f) : frustumTest(f) {}
+    bool operator()(const Box<Vec3<T> > &b) const { return !b.isEmpty() && frustumTest.isVisible(b); }
+};
+
+template <class T>
+FixedArray<int>
+BoundingVolumeHierarchy<T>::intersect(const Box &box) const
+{
+    MATH_EXC_ON;
+    std::vector<int> result;
+    BVH_BoxVisitor<T> visitor(box);
+    traverse(visitor, result);
+    return toIndexArray(result);
+}
+
+template <class T>
+FixedArray<int>
+BoundingVolumeHierarchy<T>::intersectRay(const Line3<T> &ray) const
+{
+    MATH_EXC_ON;
+    std::vector<int> result;
+    BVH_RayVisitor<T> visitor(ray);
+    traverse(visitor, result);
+    return toIndexArray(result);
+}
+
+template <class T>
+FixedArray<int>
+BoundingVolumeHierarchy<T>::visible(const FrustumTest<T> &frustumTest) const
+{
+    MATH_EXC_ON;
+    std::vector<int> result;
+    BVH_FrustumVisitor<T> visitor(frustumTest);
+    traverse(visitor, result);
+    return toIndexArray(result);
+}
+
+template <class T>
+static void
+BVH_refitBoxes(BoundingVolumeHierarchy<T> &bvh, const FixedArray<Box<Vec3<T> > > &boxes)
+{
+    MATH_EXC_ON;
+    bvh.refit(boxes);
+}
+
+template <class T>
+static void
+BVH_refitPoints(BoundingVolumeHierarchy<T> &bvh, const FixedArray<Vec3<T> > &points)
+{
+    MATH_EXC_ON;
+    bvh.refit(points);
+}
+
+template <class T>
+static std::string
+BVH_repr(const BoundingVolumeHierarchy<T> &bvh)
+{
+    std::stringstream stream;
+    stream << BVHName<T>::value << "(" << bvh.size() << " primitives, "
+           << bvh.nodeCount() << " nodes)";
+    return stream.str();
+}
+
+template <class T>
+py::class_<BoundingVolumeHierarchy<T> >
+register_BVH(py::module &m)
+{
+    const char *name = BVHName<T>::value;
+
+    py::class_< BoundingVolumeHierarchy<T> > bvh_class(m, name,
+        "bounding volume hierarchy over an array of 3D boxes or points");
+    bvh_class
+        .def(py::init<const FixedArray<Box<Vec3<T> > >&>(),
+             "build a hierarchy over an array of boxes")
+        .def(py::init<const FixedArray<Vec3<T> >&>(),
+             "build a hierarchy over an array of points")
+        .def("__len__",&BoundingVolumeHierarchy<T>::size)
+        .def("__repr__",&BVH_repr<T>)
+        .def("nodeCount",&BoundingVolumeHierarchy<T>::nodeCount,
+             "nodeCount() -- the number of nodes in the hierarchy")
+        .def("bounds",&BoundingVolumeHierarchy<T>::bounds,
+             "bounds() -- the bounding box of all primitives")
+        .def("refit",&BVH_refitBoxes<T>,
+             "refit(boxes) -- replace the primitive boxes and update the node bounds, keeping the tree topology")
+        .def("refit",&BVH_refitPoints<T>,
+             "refit(points) -- replace the primitive points and update the node bounds, keeping the tree topology")
+        .def("intersect",&BoundingVolumeHierarchy<T>::intersect,
+             "intersect(box) -- the indices of the primitives that overlap the box")
+        .def("intersectRay",&BoundingVolumeHierarchy<T>::intersectRay,
+             "intersectRay(line) -- the indices of the primitives hit by the ray from line.pos along line.dir")
+        .def("visible",&BoundingVolumeHierarchy<T>::visible,
+             "visible(frustumTest) -- the indices of the primitives that may be visible")
+        ;
+
+    return bvh_class;
+}
+
+template class PYIMATH_EXPORT BoundingVolumeHierarchy<float>;
+template class PYIMATH_EXPORT BoundingVolumeHierarchy<double>;
+
+template PYIMATH_EXPORT py::class_<BoundingVolumeHierarchy<float> > register_BVH<float>(py::module &m);
+template PYIMATH_EXPORT py::class_<BoundingVolumeHierarchy<double> > register_BVH<double>(py::module &m);
+}
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathBVH_h_
+#define _PyImathBVH_h_
+
+#include "python_include.h"
+#include <ImathVec.h>
+#include <ImathBox.h>
+#include <ImathLine.h>
+#include <ImathFrustumTest.h>
+#include <PyImathFixedArray.h>
+#include <vector>
+
+
+namespace PyImath {
+
+//
+// A bounding volume hierarchy over an array of 3D boxes (or points, which
+// are treated as degenerate boxes).  The tree is a linear BVH: primitives
+// are sorted along a 30-bit Morton curve of their centers and split on the
+// highest differing bit, with up to LeafSize primitives per leaf.
+//
+// Nodes are stored in depth-first order, so the left child of an interior
+// node is the node that follows it and a child always comes after its
+// parent.  Queries return the indices of the matching primitives in the
+// array the tree was built from, in increasing order.
+//
+
+template <class T>
+class BoundingVolumeHierarchy
+{
+  public:
+
+    typedef IMATH_NAMESPACE::Vec3<T>    Vec;
+    typedef IMATH_NAMESPACE::Box<Vec>   Box;
+
+    enum { LeafSize = 4 };
+
+    struct Node
+    {
+        Box bounds;
+        int start;      // first entry of _order, for leaves
+        int count;      // number of primitives, 0 for interior nodes
+        int right;      // index of the right child, for interior nodes
+    };
+
+    explicit BoundingVolumeHierarchy (const FixedArray<Box> &boxes);
+    explicit BoundingVolumeHierarchy (const FixedArray<Vec> &points);
+
+    size_t      size () const       { return _boxes.size(); }
+    size_t      nodeCount () const  { return _nodes.size(); }
+    Box         bounds () const;
+
+    // Replace the primitive boxes and recompute the node bounds without
+    // changing the topology of the tree.
+    void        refit (const FixedArray<Box> &boxes);
+    void        refit (const FixedArray<Vec> &points);
+
+    FixedArray<int> intersect (const Box &box) const;
+    FixedArray<int> intersectRay (const IMATH_NAMESPACE::Line3<T> &ray) const;
+    FixedArray<int> visible (const IMATH_NAMESPACE::FrustumTest<T> &frustumTest) const;
+
+    const std::vector<Node> &   nodes () const  { return _nodes; }
+    const std::vector<int> &    order () const  { return _order; }
+    const std::vector<Box> &    boxes () const  { return _boxes; }
+
+  private:
+
+    void        build ();
+    int         emit (const std::vector<unsigned int> &codes, int first, int last);
+    void        updateBounds ();
+
+    template <class Visitor>
+    void        traverse (Visitor &visitor, std::vector<int> &result) const;
+
+    std::vector<Box>    _boxes;
+    std::vector<int>    _order;
+    std::vector<Node>   _nodes;
+};
+
+template <class T> py::class_<BoundingVolumeHierarchy<T> > register_BVH(py::module &m);
+
+}
+
+#endif
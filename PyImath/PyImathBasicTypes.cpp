@@ -37,6 +37,9 @@
 #include <PyImath.h>
 #include <PyImathFixedArray.h>
 #include <PyImathFixedVArray.h>
+#include <PyImathFixedVArrayOps.h>
+#include <PyImathVec.h>
+#include <PyImathFixedArrayExpr.h>
 
 
 
@@ -53,30 +56,38 @@ register_basicTypes(py::module &m)
     add_mod_math_functions(scclass);
     add_comparison_functions(scclass);
     add_ordered_comparison_functions(scclass);
+    add_reduction_functions(scclass);
 
     py::class_<UnsignedCharArray> ucclass = UnsignedCharArray::register_(m, "Fixed length array of unsigned chars");
     add_arithmetic_math_functions(ucclass);
     add_mod_math_functions(ucclass);
     add_comparison_functions(ucclass);
     add_ordered_comparison_functions(ucclass);
+    add_reduction_functions(ucclass);
+    add_lazy_arithmetic_functions(m, ucclass);
 
     py::class_<ShortArray> sclass = ShortArray::register_(m, "Fixed length array of shorts");
     add_arithmetic_math_functions(sclass);
     add_mod_math_functions(sclass);
     add_comparison_functions(sclass);
     add_ordered_comparison_functions(sclass);
+    add_reduction_functions(sclass);
+    add_lazy_arithmetic_functions(m, sclass);
 
     py::class_<UnsignedShortArray> usclass = UnsignedShortArray::register_(m, "Fixed length array of unsigned shorts");
     add_arithmetic_math_functions(usclass);
     add_mod_math_functions(usclass);
     add_comparison_functions(usclass);
     add_ordered_comparison_functions(usclass);
+    add_reduction_functions(usclass);
 
     py::class_<IntArray> iclass = IntArray::register_(m, "Fixed length array of ints");
     add_arithmetic_math_functions(iclass);
     add_mod_math_functions(iclass);
     add_comparison_functions(iclass);
     add_ordered_comparison_functions(iclass);
+    add_reduction_functions(iclass);
+    add_lazy_arithmetic_functions(m, iclass);
     add_explicit_construction_from_type<float>(iclass);
     add_explicit_construction_from_type<double>(iclass);
 
@@ -85,6 +96,7 @@ register_basicTypes(py::module &m)
     add_mod_math_functions(uiclass);
     add_comparison_functions(uiclass);
     add_ordered_comparison_functions(uiclass);
+    add_reduction_functions(uiclass);
     add_explicit_construction_from_type<float>(uiclass);
     add_explicit_construction_from_type<double>(uiclass);
 
@@ -93,6 +105,8 @@ register_basicTypes(py::module &m)
     add_pow_math_functions(fclass);
     add_comparison_functions(fclass);
     add_ordered_comparison_functions(fclass);
+    add_reduction_functions(fclass);
+    add_lazy_arithmetic_functions(m, fclass);
     add_explicit_construction_from_type<int>(fclass);
     add_explicit_construction_from_type<double>(fclass);
 
@@ -101,11 +115,26 @@ register_basicTypes(py::module &m)
     add_pow_math_functions(dclass);
     add_comparison_functions(dclass);
     add_ordered_comparison_functions(dclass);
+    add_reduction_functions(dclass);
+    add_lazy_arithmetic_functions(m, dclass);
     add_explicit_construction_from_type<int>(dclass);
     add_explicit_construction_from_type<float>(dclass);
 
     py::class_<VIntArray> ivclass = VIntArray::register_(m, "Variable fixed length array of ints");
-    // Don't add other functionality until its defined better.
+    add_varray_reduction_functions(ivclass);
+    add_varray_index_functions<int>(ivclass);
+    add_varray_index_functions<float>(ivclass);
+    add_varray_index_functions<IMATH_NAMESPACE::V2f>(ivclass);
+    add_varray_index_functions<IMATH_NAMESPACE::V3f>(ivclass);
+
+    py::class_<VFloatArray> fvclass = VFloatArray::register_(m, "Variable fixed length array of floats");
+    add_varray_reduction_functions(fvclass);
+
+    py::class_<VV2fArray> v2fvclass = VV2fArray::register_(m, "Variable fixed length array of V2fs");
+    add_varray_reduction_functions(v2fvclass);
+
+    py::class_<VV3fArray> v3fvclass = VV3fArray::register_(m, "Variable fixed length array of V3fs");
+    add_varray_reduction_functions(v3fvclass);
 }
 
 } // namespace PyImath
@@ -311,7 +311,7 @@ PyImath::FixedArray<int>
 box_intersects(IMATH_NAMESPACE::Box<T>& box, const PyImath::FixedArray<T>& points)
 {
     size_t numPoints = points.len();
-    PyImath::FixedArray<int> mask(numPoints);
+    PyImath::FixedArray<int> mask(numPoints, PyImath::UNINITIALIZED);
 
     IntersectsTask<T> task(box,points,mask);
     dispatchTask(task,numPoints);
@@ -0,0 +1,447 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathBufferProtocol_h_
+#define _PyImathBufferProtocol_h_
+
+#include "python_include.h"
+#include <boost/any.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <Iex.h>
+#include <ImathVec.h>
+#include <ImathColor.h>
+#include <ImathQuat.h>
+#include <ImathMatrix.h>
+#include <PyImathUtil.h>
+
+namespace PyImath {
+
+template <class T> class FixedArray;
+template <class T> class FixedArray2D;
+
+//
+// Buffer protocol support for the fixed arrays.
+//
+// An element type is exportable if it is a scalar, or a packed block
+// of scalars such as a vector, color, quaternion or matrix.  Such an
+// array is exported with the element's dimensions appended to the
+// array's own, so a V3fArray appears as an (n,3) float buffer and an
+// M44dArray as (n,4,4) doubles.  Arrays can also be constructed around
+// an incoming buffer of that shape without copying it.
+//
+template <class T, class Enable = void>
+struct FixedArrayBufferLayout
+{
+    static const bool exportable = false;
+};
+
+template <class T>
+struct FixedArrayBufferLayout<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+    static const bool exportable = true;
+    typedef T BaseType;
+    static void appendDims(std::vector<Py_ssize_t> &shape) {}
+};
+
+template <class S, int N>
+struct VectorBufferLayout
+{
+    static const bool exportable = true;
+    typedef S BaseType;
+    static void appendDims(std::vector<Py_ssize_t> &shape) { shape.push_back(N); }
+};
+
+template <class S, int N>
+struct MatrixBufferLayout
+{
+    static const bool exportable = true;
+    typedef S BaseType;
+    static void appendDims(std::vector<Py_ssize_t> &shape) { shape.push_back(N); shape.push_back(N); }
+};
+
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Vec2<T> > : VectorBufferLayout<T,2> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Vec3<T> > : VectorBufferLayout<T,3> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Vec4<T> > : VectorBufferLayout<T,4> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Color3<T> > : VectorBufferLayout<T,3> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Color4<T> > : VectorBufferLayout<T,4> {};
+// stored as r followed by v.x, v.y, v.z
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Quat<T> > : VectorBufferLayout<T,4> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Matrix33<T> > : MatrixBufferLayout<T,3> {};
+template <class T> struct FixedArrayBufferLayout<IMATH_NAMESPACE::Matrix44<T> > : MatrixBufferLayout<T,4> {};
+
+//
+// Whether a buffer's struct-module format describes the scalar S.
+// Sizes are compared rather than codes, since e.g. 'l' and 'q' are both
+// 64 bit on some platforms.  Only native byte order is accepted.
+//
+template <class S>
+bool
+bufferFormatMatches(const char *format, Py_ssize_t itemsize)
+{
+    if (itemsize != Py_ssize_t(sizeof(S)) || format == 0)
+        return false;
+    if (*format == '@' || *format == '=')
+        ++format;
+    if (std::strlen(format) != 1)
+        return false;
+
+    const char code = *format;
+    if (std::is_same<S,bool>::value)
+        return code == '?';
+    if (std::is_floating_point<S>::value)
+        return std::strchr("efdg", code) != 0;
+    if (std::is_signed<S>::value)
+        return std::strchr("bhilq", code) != 0;
+    return std::strchr("BHILQ", code) != 0;
+}
+
+//
+// Masked arrays have no strided layout to export.  Each exporting array
+// type registers a test for them here, so that a buffer is never asked
+// of a masked array while probing constructor arguments.
+//
+typedef bool (*MaskedArrayTest)(PyObject *obj);
+
+inline std::vector<std::pair<PyTypeObject *, MaskedArrayTest> > &
+maskedArrayTests()
+{
+    static std::vector<std::pair<PyTypeObject *, MaskedArrayTest> > tests;
+    return tests;
+}
+
+inline bool
+isMaskedArray(PyObject *obj)
+{
+    const std::vector<std::pair<PyTypeObject *, MaskedArrayTest> > &tests = maskedArrayTests();
+    for (PyTypeObject *type = Py_TYPE(obj); type != 0; type = type->tp_base)
+    {
+        for (size_t i = 0; i < tests.size(); ++i)
+        {
+            if (tests[i].first == type)
+                return tests[i].second(obj);
+        }
+    }
+    return false;
+}
+
+//
+// Owns an exported Py_buffer for as long as any array refers to its
+// memory.  The last reference may be dropped on a worker thread, so
+// the release takes the python lock.
+//
+class PyBufferHandle
+{
+    Py_buffer _view;
+
+    PyBufferHandle() {}
+    PyBufferHandle(const PyBufferHandle &);
+    PyBufferHandle &operator = (const PyBufferHandle &);
+
+  public:
+    // returns null, with no python error set, if obj does not export a
+    // writable strided buffer
+    static PyBufferHandle * acquire(PyObject *obj)
+    {
+        if (!PyObject_CheckBuffer(obj) || isMaskedArray(obj))
+            return 0;
+        PyBufferHandle *handle = new PyBufferHandle;
+        if (PyObject_GetBuffer(obj, &handle->_view, PyBUF_RECORDS) != 0)
+        {
+            PyErr_Clear();
+            delete handle;
+            return 0;
+        }
+        return handle;
+    }
+
+    ~PyBufferHandle()
+    {
+        if (Py_IsInitialized())
+        {
+            PyAcquireLock pylock;
+            PyBuffer_Release(&_view);
+        }
+    }
+
+    const Py_buffer & view() const { return _view; }
+};
+
+//
+// A buffer whose memory is laid out as an N dimensional array of T.
+// Binding a BufferView argument only succeeds for such buffers, so an
+// object of any other layout falls through to the remaining overloads
+// (e.g. the converting constructors) rather than failing outright.
+//
+template <class T, int N>
+struct BufferView
+{
+    typedef FixedArrayBufferLayout<T> Layout;
+    typedef typename Layout::BaseType S;
+
+    boost::shared_ptr<PyBufferHandle> handle;
+    T *      ptr;
+    size_t   shape[N];
+    size_t   strides[N]; // in units of T
+
+    bool load(PyObject *obj)
+    {
+        boost::shared_ptr<PyBufferHandle> h(PyBufferHandle::acquire(obj));
+        if (!h)
+            return false;
+
+        const Py_buffer &view = h->view();
+        std::vector<Py_ssize_t> dims;
+        Layout::appendDims(dims);
+
+        if (!bufferFormatMatches<S>(view.format, view.itemsize) ||
+            view.ndim != N + int(dims.size()))
+            return false;
+
+        // the elements themselves must be packed
+        Py_ssize_t expected = sizeof(S);
+        for (int d = int(dims.size())-1; d >= 0; --d)
+        {
+            if (view.shape[N+d] != dims[d] || view.strides[N+d] != expected)
+                return false;
+            expected *= dims[d];
+        }
+
+        for (int d = 0; d < N; ++d)
+        {
+            if (view.strides[d] <= 0 || view.strides[d] % Py_ssize_t(sizeof(T)) != 0)
+                return false;
+            shape[d] = view.shape[d];
+            strides[d] = view.strides[d] / sizeof(T);
+        }
+
+        ptr = static_cast<T *>(view.buf);
+        handle = h;
+        return true;
+    }
+};
+
+template <class T>
+py::buffer_info
+makeBufferInfo(T *ptr, std::vector<Py_ssize_t> shape, std::vector<Py_ssize_t> strides)
+{
+    typedef FixedArrayBufferLayout<T> Layout;
+    typedef typename Layout::BaseType S;
+
+    const size_t ndim = shape.size();
+    Layout::appendDims(shape);
+
+    Py_ssize_t stride = sizeof(S);
+    strides.resize(shape.size());
+    for (size_t d = shape.size(); d-- > ndim;)
+    {
+        strides[d] = stride;
+        stride *= shape[d];
+    }
+
+    return py::buffer_info(ptr, sizeof(S), py::format_descriptor<S>::format(),
+                           Py_ssize_t(shape.size()), shape, strides);
+}
+
+//
+// The buffer slot of an exporting array type.  pybind11's own slot
+// can't report an error from the getter (older versions let the
+// exception escape into CPython), so masked arrays are turned away
+// here with a BufferError before it is reached.
+//
+template <class T>
+struct FixedArrayBufferSlot
+{
+    static getbufferproc &next()
+    {
+        static getbufferproc slot = 0;
+        return slot;
+    }
+
+    static bool isMasked(PyObject *obj)
+    {
+        try
+        {
+            return py::cast<const FixedArray<T> &>(py::handle(obj)).isMaskedReference();
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    static int getBuffer(PyObject *obj, Py_buffer *view, int flags)
+    {
+        if (isMasked(obj))
+        {
+            if (view)
+                view->obj = 0;
+            PyErr_SetString(PyExc_BufferError, "A masked array can not be exported as a buffer");
+            return -1;
+        }
+        return next()(obj, view, flags);
+    }
+
+    template <class Cls>
+    static void install(Cls &c)
+    {
+        PyTypeObject *type = reinterpret_cast<PyTypeObject *>(c.ptr());
+        next() = type->tp_as_buffer->bf_getbuffer;
+        type->tp_as_buffer->bf_getbuffer = &getBuffer;
+        maskedArrayTests().push_back(std::make_pair(type, &isMasked));
+    }
+};
+
+// masked arrays never get here; see FixedArrayBufferSlot
+template <class T>
+py::buffer_info
+FixedArray_getBuffer(FixedArray<T> &a)
+{
+    return makeBufferInfo<T>(&a.direct_index(0),
+                             std::vector<Py_ssize_t>(1, a.len()),
+                             std::vector<Py_ssize_t>(1, a.stride()*sizeof(T)));
+}
+
+template <class T>
+FixedArray<T> *
+FixedArray_fromBuffer(const BufferView<T,1> &buffer)
+{
+    return new FixedArray<T>(buffer.ptr, buffer.shape[0], buffer.strides[0], boost::any(buffer.handle));
+}
+
+template <class T>
+py::buffer_info
+FixedArray2D_getBuffer(FixedArray2D<T> &a)
+{
+    // element (i,j) lives at stride.x*(j*stride.y + i), so j is the
+    // outer (row) dimension
+    IMATH_NAMESPACE::Vec2<size_t> len = a.len();
+    IMATH_NAMESPACE::Vec2<size_t> stride = a.stride();
+
+    std::vector<Py_ssize_t> shape(2), strides(2);
+    shape[0] = len.y;
+    shape[1] = len.x;
+    strides[0] = stride.x*stride.y*sizeof(T);
+    strides[1] = stride.x*sizeof(T);
+
+    return makeBufferInfo<T>(&a(0,0), shape, strides);
+}
+
+template <class T>
+FixedArray2D<T> *
+FixedArray2D_fromBuffer(const BufferView<T,2> &buffer)
+{
+    if (buffer.strides[0] % buffer.strides[1] != 0)
+        throw IEX_NAMESPACE::ArgExc("Buffer's row stride must be a multiple of its column stride");
+
+    return new FixedArray2D<T>(buffer.ptr, buffer.shape[1], buffer.shape[0],
+                               buffer.strides[1], buffer.strides[0] / buffer.strides[1],
+                               boost::any(buffer.handle));
+}
+
+//
+// Creates the python class for an array of T, and adds the buffer
+// export and the wrapping constructor to it; the latter is a no-op for
+// element types that can't be described as a buffer.
+//
+template <class T, bool Exportable = FixedArrayBufferLayout<T>::exportable>
+struct FixedArrayBuffer
+{
+    template <class A>
+    static py::class_<A> make_class(py::module &m, const char *name, const char *doc)
+    {
+        return py::class_<A>(m, name, doc);
+    }
+
+    template <class Cls> static void add(Cls &c) {}
+    template <class Cls> static void add2D(Cls &c) {}
+};
+
+template <class T>
+struct FixedArrayBuffer<T, true>
+{
+    template <class A>
+    static py::class_<A> make_class(py::module &m, const char *name, const char *doc)
+    {
+        return py::class_<A>(m, name, doc, py::buffer_protocol());
+    }
+
+    template <class Cls>
+    static void add(Cls &c)
+    {
+        c
+            .def_buffer(&FixedArray_getBuffer<T>)
+            .def(py::init(&FixedArray_fromBuffer<T>), "wrap the memory of a buffer such as a numpy array without copying it")
+            ;
+        FixedArrayBufferSlot<T>::install(c);
+    }
+
+    template <class Cls>
+    static void add2D(Cls &c)
+    {
+        c
+            .def_buffer(&FixedArray2D_getBuffer<T>)
+            .def(py::init(&FixedArray2D_fromBuffer<T>), "wrap the memory of a 2d buffer such as a numpy array without copying it")
+            ;
+    }
+};
+
+} // namespace PyImath
+
+namespace pybind11 { namespace detail {
+
+template <class T, int N>
+struct type_caster<PyImath::BufferView<T,N> >
+{
+    PYBIND11_TYPE_CASTER(PyImath::BufferView<T PYBIND11_COMMA N>, _("buffer"));
+
+    bool load(handle src, bool)
+    {
+        return value.load(src.ptr());
+    }
+
+    static handle cast(const PyImath::BufferView<T,N> &, return_value_policy, handle)
+    {
+        return none().release();
+    }
+};
+
+}} // namespace pybind11::detail
+
+#endif // _PyImathBufferProtocol_h_
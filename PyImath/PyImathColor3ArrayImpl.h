@@ -47,6 +47,7 @@
 #include <PyImath.h>
 #include <Iex.h>
 #include <PyImathMathExc.h>
+#include <PyImathFixedArraySoA.h>
 
 namespace PyImath {
 
@@ -74,6 +75,8 @@ register_Color3Array(py::module &m)
         .def_property_readonly("b",&Color3Array_get<T,2>)
         ;
 
+    add_soa_functions(m, color3Array_class);
+
     return color3Array_class;
 }
 
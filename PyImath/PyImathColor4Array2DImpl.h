@@ -169,7 +169,7 @@ Color4Array_mulT(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, T t)
 {
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len);
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED);
     for (size_t j = 0; j < len.y; ++j)
         for (size_t i = 0; i < len.x; ++i)
             f(i,j) = va(i,j) * t; 
@@ -194,7 +194,7 @@ Color4Array_mulArrayT(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j)
         for (size_t i = 0; i < len.x; ++i)
             f(i,j) = va(i,j) * vb(i,j);
@@ -231,7 +231,7 @@ Color4Array_divT(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, T t)
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len(); 
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) / t; 
@@ -244,7 +244,7 @@ Color4Array_divArrayT(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) / vb(i,j); 
@@ -281,7 +281,7 @@ Color4Array_add(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const Fixed
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) + vb(i,j); 
@@ -294,7 +294,7 @@ Color4Array_addColor(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) + vb; 
@@ -307,7 +307,7 @@ Color4Array_sub(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const Fixed
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) - vb(i,j); 
@@ -320,7 +320,7 @@ Color4Array_subColor(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) - vb; 
@@ -333,7 +333,7 @@ Color4Array_rsubColor(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = vb - va(i,j); 
@@ -346,7 +346,7 @@ Color4Array_mul(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const Fixed
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) * vb(i,j); 
@@ -359,7 +359,7 @@ Color4Array_mulColor(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) * vb; 
@@ -372,7 +372,7 @@ Color4Array_div(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const Fixed
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.match_dimension(vb);
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) / vb(i,j); 
@@ -385,7 +385,7 @@ Color4Array_divColor(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va, const
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = va(i,j) / vb; 
@@ -398,7 +398,7 @@ Color4Array_neg(const FixedArray2D<IMATH_NAMESPACE::Color4<T> > &va)
 { 
     PY_IMATH_LEAVE_PYTHON;
     IMATH_NAMESPACE::Vec2<size_t> len = va.len();
-    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len); 
+    FixedArray2D<IMATH_NAMESPACE::Color4<T> > f(len.x, len.y, UNINITIALIZED); 
     for (size_t j = 0; j < len.y; ++j) 
         for (size_t i = 0; i < len.x; ++i) 
             f(i,j) = -va(i,j);
@@ -47,6 +47,7 @@
 #include <PyImath.h>
 #include <Iex.h>
 #include <PyImathMathExc.h>
+#include <PyImathFixedArraySoA.h>
 
 namespace PyImath {
 
@@ -75,6 +76,8 @@ register_Color4Array(py::module &m)
         .def_property_readonly("a",&Color4Array_get<T,3>)
         ;
 
+    add_soa_functions(m, color4Array_class);
+
     return color4Array_class;
 }
 
@@ -42,6 +42,7 @@
 #include <ImathVec.h>
 #include <Iex.h>
 #include <PyImathOperators.h>
+#include <PyImathTask.h>
 
 // XXX incomplete array wrapping, docstrings missing
 
@@ -763,19 +764,76 @@ EulerArray_get(FixedArray<IMATH_NAMESPACE::Euler<T> > &qa)
 }
 */
 
-template <class T>
+//
+// Batched conversions between Euler arrays and quat and matrix arrays.
+// Each element is extracted into an Euler of the requested order.
+//
+
+template <class T, class S>
+struct EulerArray_Extract : public Task
+{
+    const FixedArray<S>                   &src;
+    FixedArray<IMATH_NAMESPACE::Euler<T> > &result;
+    typename IMATH_NAMESPACE::Euler<T>::Order order;
+
+    EulerArray_Extract (const FixedArray<S> &srcIn,
+                        FixedArray<IMATH_NAMESPACE::Euler<T> > &resultIn,
+                        typename IMATH_NAMESPACE::Euler<T>::Order orderIn)
+        : src (srcIn), result (resultIn), order (orderIn) {}
+
+    size_t elementCost () const { return 64; }
+
+    void execute (size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            IMATH_NAMESPACE::Euler<T> e (order);
+            e.extract (src[i]);
+            result[i] = e;
+        }
+    }
+};
+
+template <class T, class S>
 static FixedArray<IMATH_NAMESPACE::Euler<T> > *
-EulerArray_eulerConstructor7a(const FixedArray<IMATH_NAMESPACE::Quat<T> > &q)
+EulerArray_extract(const FixedArray<S> &src, int order)
 {
     MATH_EXC_ON;
-    size_t len = q.len();
-    FixedArray<IMATH_NAMESPACE::Euler<T> >* result = new FixedArray<IMATH_NAMESPACE::Euler<T> >(len);
-    for (size_t i = 0; i < len; ++i) {
-        (*result)[i].extract(q[i]);
-    }
+    typename IMATH_NAMESPACE::Euler<T>::Order o = eulerOrderFromInt<T> (order);
+    size_t len = src.len();
+    FixedArray<IMATH_NAMESPACE::Euler<T> >* result = new FixedArray<IMATH_NAMESPACE::Euler<T> >(Py_ssize_t(len), UNINITIALIZED);
+
+    EulerArray_Extract<T,S> task (src, *result, o);
+    dispatchTask (task, len);
     return result;
 }
 
+template <class T>
+static FixedArray<IMATH_NAMESPACE::Euler<T> > *
+EulerArray_eulerConstructor7a(const FixedArray<IMATH_NAMESPACE::Quat<T> > &q)
+{
+    return EulerArray_extract<T> (q, int(IMATH_NAMESPACE::Euler<T>::Default));
+}
+
+template <class T>
+struct op_eulerToQuat {
+    static inline IMATH_NAMESPACE::Quat<T> apply(const IMATH_NAMESPACE::Euler<T> &e) { return e.toQuat(); }
+};
+
+template <class T>
+struct op_eulerToMatrix33 {
+    static inline IMATH_NAMESPACE::Matrix33<T> apply(const IMATH_NAMESPACE::Euler<T> &e) { return e.toMatrix33(); }
+};
+
+template <class T>
+struct op_eulerToMatrix44 {
+    static inline IMATH_NAMESPACE::Matrix44<T> apply(const IMATH_NAMESPACE::Euler<T> &e) { return e.toMatrix44(); }
+};
+
+template <class T> struct op_cost<op_eulerToQuat<T> >     { static const size_t value = 32; };
+template <class T> struct op_cost<op_eulerToMatrix33<T> > { static const size_t value = 32; };
+template <class T> struct op_cost<op_eulerToMatrix44<T> > { static const size_t value = 32; };
+
 template <class T>
 py::class_<FixedArray<IMATH_NAMESPACE::Euler<T> > >
 register_EulerArray(py::module &m)
@@ -786,11 +844,21 @@ register_EulerArray(py::module &m)
         //.def_property_readonly("y",&EulerArray_get<T,2>)
         //.def_property_readonly("z",&EulerArray_get<T,3>)
         .def(py::init(&EulerArray_eulerConstructor7a<T>))
+        .def(py::init(&EulerArray_extract<T,IMATH_NAMESPACE::Quat<T> >), py::arg("q"), py::arg("order"),
+             "EulerArray(q,order) -- the rotation of each quat of q, in the given order")
+        .def(py::init(&EulerArray_extract<T,IMATH_NAMESPACE::Matrix33<T> >), py::arg("m"),
+             py::arg("order") = int(IMATH_NAMESPACE::Euler<T>::Default),
+             "EulerArray(m[,order]) -- the rotation of each 3x3 matrix of m, in the given order")
+        .def(py::init(&EulerArray_extract<T,IMATH_NAMESPACE::Matrix44<T> >), py::arg("m"),
+             py::arg("order") = int(IMATH_NAMESPACE::Euler<T>::Default),
+             "EulerArray(m[,order]) -- the rotation of each 4x4 matrix of m, in the given order")
         ;
 
+    generate_member_bindings<op_eulerToQuat<T> >(eulerArray_class,"toQuat","convert each euler into a quaternion");
+    generate_member_bindings<op_eulerToMatrix33<T> >(eulerArray_class,"toMatrix33","convert each euler into a 3x3 matrix");
+    generate_member_bindings<op_eulerToMatrix44<T> >(eulerArray_class,"toMatrix44","convert each euler into a 4x4 matrix");
+
     add_comparison_functions(eulerArray_class);
-    PyImath::add_explicit_construction_from_type<IMATH_NAMESPACE::Matrix33<T> >(eulerArray_class);
-    PyImath::add_explicit_construction_from_type<IMATH_NAMESPACE::Matrix44<T> >(eulerArray_class);
     return eulerArray_class;
 }
 
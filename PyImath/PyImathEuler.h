@@ -48,6 +48,23 @@ template <class T> py::class_<PyImath::FixedArray<IMATH_NAMESPACE::Euler<T> > >
 typedef FixedArray<IMATH_NAMESPACE::Eulerf>  EulerfArray;
 typedef FixedArray<IMATH_NAMESPACE::Eulerd>  EulerdArray;
 
+//
+// Convert a rotation order passed in from python as an int, raising
+// ValueError if it isn't one of the orders Imath accepts.
+//
+template <class T>
+typename IMATH_NAMESPACE::Euler<T>::Order
+eulerOrderFromInt (int order)
+{
+    typename IMATH_NAMESPACE::Euler<T>::Order o = typename IMATH_NAMESPACE::Euler<T>::Order (order);
+    if (!IMATH_NAMESPACE::Euler<T>::legal (o))
+    {
+        PyErr_SetString (PyExc_ValueError, "Invalid Euler rotation order");
+        throw py::error_already_set();
+    }
+    return o;
+}
+
 //
 
 // Other code in the Zeno code base assumes the existance of a class with the
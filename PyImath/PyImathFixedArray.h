@@ -42,8 +42,12 @@
 #include <boost/any.hpp>
 #include <Iex.h>
 #include <iostream>
+#include <functional>
 #include <IexMathFloatExc.h>
 #include <PyImathUtil.h>
+#include <PyImathAllocator.h>
+#include <PyImathFixedArrayMask.h>
+#include <PyImathBufferProtocol.h>
 
 #define PY_IMATH_LEAVE_PYTHON IEX_NAMESPACE::MathExcOn mathexcon (IEX_NAMESPACE::IEEE_OVERFLOW | \
                                                         IEX_NAMESPACE::IEEE_DIVZERO |  \
@@ -74,8 +78,8 @@ class FixedArray
     // so that everything is freed properly on exit.
     boost::any _handle;
 
-    boost::shared_array<size_t> _indices; // non-NULL iff I'm a masked reference
-    size_t                      _unmaskedLength;
+    FixedArrayMask  _indices;       // non-empty iff I'm a masked reference
+    size_t          _unmaskedLength;
 
 
   public:
@@ -115,7 +119,7 @@ class FixedArray
         if (_length < 0) {
             throw IEX_NAMESPACE::LogicExc("Fixed array length must be non-negative");
         }
-        boost::shared_array<T> a(new T[length]);
+        boost::shared_array<T> a(allocateArray<T>(length));
         T tmp = FixedArrayDefaultValue<T>::value();
         for (size_t i=0; i<length; ++i) a[i] = tmp;
         _handle = a;
@@ -128,7 +132,7 @@ class FixedArray
         if (_length < 0) {
             throw IEX_NAMESPACE::LogicExc("Fixed array length must be non-negative");
         }
-        boost::shared_array<T> a(new T[length]);
+        boost::shared_array<T> a(allocateArray<T>(length));
         _handle = a;
         _ptr = a.get();
     }
@@ -139,57 +143,77 @@ class FixedArray
         if (_length < 0) {
             throw IEX_NAMESPACE::LogicExc("Fixed array length must be non-negative");
         }
-        boost::shared_array<T> a(new T[length]);
+        boost::shared_array<T> a(allocateArray<T>(length));
         for (size_t i=0; i<length; ++i) a[i] = initialValue;
         _handle = a;
         _ptr = a.get();
     }
 
+    //
+    // Masked reference to the elements of f selected by mask.  If f is
+    // itself masked, the mask either selects among f's elements (it has
+    // f's length) or among the underlying storage (it has f's unmasked
+    // length), and the result refers to the storage directly.
+    //
     FixedArray(FixedArray& f, const FixedArray<int>& mask) 
         : _ptr(f._ptr), _stride(f._stride), _handle(f._handle)
     {
-        if (f.isMaskedReference())
+        size_t len = f.match_dimension(mask, false);
+        _unmaskedLength = f.isMaskedReference() ? f._unmaskedLength : len;
+
+        if (f.isMaskedReference() && mask.len() != len)
         {
-            throw IEX_NAMESPACE::NoImplExc("Masking an already-masked FixedArray not supported yet (SQ27000)");
-        }
+            // mask over the storage: keep f's elements that it selects
+            size_t reduced_len = 0;
+            for (size_t i = 0; i < len; ++i)
+                if (mask[f.raw_ptr_index(i)])
+                    reduced_len++;
+
+            FixedArrayMask::Builder indices(reduced_len, _unmaskedLength);
+            for (size_t i = 0; i < len; ++i)
+                if (mask[f.raw_ptr_index(i)])
+                    indices.append(f.raw_ptr_index(i));
 
-        size_t len = f.match_dimension(mask);
-        _unmaskedLength = len;
+            _indices = indices.mask();
+            _length = reduced_len;
+            return;
+        }
 
         size_t reduced_len = 0;
         for (size_t i = 0; i < len; ++i)
             if (mask[i])
                 reduced_len++;
 
-        _indices.reset(new size_t[reduced_len]);
-
-        for (size_t i = 0, j = 0; i < len; ++i)
-        {
+        FixedArrayMask::Builder indices(reduced_len, _unmaskedLength);
+        for (size_t i = 0; i < len; ++i)
             if (mask[i])
-            {
-                _indices[j] = i;
-                j++;
-            }
-        }
+                indices.append(f.isMaskedReference() ? f.raw_ptr_index(i) : i);
 
+        _indices = indices.mask();
         _length = reduced_len;
     }
 
+    //
+    // Converting copy.  A masked reference converts to a masked reference
+    // into new storage of the unmasked length, sharing the mask, with the
+    // selected elements converted.
+    //
     template <class S>
     explicit FixedArray(const FixedArray<S> &other)
         : _ptr(0), _length(other.len()), _stride(1), _handle(), _unmaskedLength(other.unmaskedLength())
     {
-        boost::shared_array<T> a(new T[_length]);
-        for (size_t i=0; i<_length; ++i) a[i] = T(other[i]);
+        boost::shared_array<T> a(allocateArray<T>(other.isMaskedReference() ? _unmaskedLength : _length));
         _handle = a;
         _ptr = a.get();
 
-        if (_unmaskedLength)
+        if (other.isMaskedReference())
         {
-            _indices.reset(new size_t[_length]);
-
-            for (size_t i = 0; i < _length; ++i)
-                _indices[i] = other.raw_ptr_index(i);
+            _indices = other.mask();
+            for (size_t i=0; i<_length; ++i) a[raw_ptr_index(i)] = T(other[i]);
+        }
+        else
+        {
+            for (size_t i=0; i<_length; ++i) a[i] = T(other[i]);
         }
     }
 
@@ -271,26 +295,75 @@ class FixedArray
     get_type_const getitem(Py_ssize_t index) const { 
         return (*this)[canonical_index(index)]; 
     }
+    //
+    // Slices are views that share this array's storage and keep it alive
+    // through the handle: the pointer is offset to the first element and
+    // the stride multiplied by the step.  Slices of a masked reference are
+    // masked references to the selected subset of the indices.  Reversed
+    // slices can't be expressed with an unsigned stride and are copied.
+    // Use copy() for a detached array.
+    //
     FixedArray  getslice(py::object index) const
     {
         size_t start=0, end=0, slicelength=0;
         Py_ssize_t step;
         extract_slice_indices(index, start,end,step,slicelength);
-        FixedArray f(slicelength);
 
-        if (_indices)
+        if (_indices.isMask())
         {
+            FixedArrayMask::Builder indices(slicelength, _unmaskedLength);
             for (size_t i=0; i<slicelength; ++i)
-                f._ptr[i] = _ptr[raw_ptr_index(start+i*step)*_stride];
+                indices.append(raw_ptr_index(start+i*step));
+
+            FixedArray f(*this);
+            f._length = slicelength;
+            f._indices = indices.mask();
+            return f;
         }
-        else
+
+        if (step > 0)
         {
-            for (size_t i=0; i<slicelength; ++i)
-                f._ptr[i] = _ptr[(start+i*step)*_stride];
+            T *ptr = slicelength ? _ptr + start*_stride : _ptr;
+            return FixedArray(ptr, slicelength, _stride*step, _handle);
         }
+
+        FixedArray f(slicelength, UNINITIALIZED);
+        for (size_t i=0; i<slicelength; ++i)
+            f._ptr[i] = _ptr[(start+i*step)*_stride];
+        return f;
+    }
+
+    // A detached, contiguous copy of the (unmasked) elements.
+    FixedArray copy() const
+    {
+        FixedArray f(_length, UNINITIALIZED);
+        for (size_t i=0; i<_length; ++i)
+            f._ptr[i] = (*this)[i];
         return f;
     }
 
+    //
+    // True if the storage spanned by the two arrays overlaps, in which
+    // case an elementwise assignment from one into the other must read
+    // from a copy.
+    //
+    template <class S>
+    bool overlaps(const FixedArray<S> &other) const
+    {
+        size_t extent = _indices.isMask() ? _unmaskedLength : _length;
+        size_t otherExtent = other.isMaskedReference() ? other.unmaskedLength() : other.len();
+        if (extent == 0 || otherExtent == 0)
+            return false;
+
+        const char *begin = reinterpret_cast<const char *>(_ptr);
+        const char *end = reinterpret_cast<const char *>(_ptr + (extent-1)*_stride + 1);
+        const char *otherBegin = reinterpret_cast<const char *>(&other.direct_index(0));
+        const char *otherEnd = reinterpret_cast<const char *>(&other.direct_index(otherExtent-1) + 1);
+
+        std::less<const char *> less;
+        return less(begin, otherEnd) && less(otherBegin, end);
+    }
+
     FixedArray getslice_mask(const FixedArray<int>& mask)
     {
         FixedArray f(*this, mask);
@@ -304,7 +377,7 @@ class FixedArray
         Py_ssize_t step;
         extract_slice_indices(index, start,end,step,slicelength);
 
-        if (_indices)
+        if (_indices.isMask())
         {
             for (size_t i=0; i<slicelength; ++i)
                 _ptr[raw_ptr_index(start+i*step)*_stride] = data;
@@ -321,7 +394,7 @@ class FixedArray
     {
         size_t len = match_dimension(mask, false);
 
-        if (_indices)
+        if (_indices.isMask())
         {
             for (size_t i = 0; i < len; ++i)
                 _ptr[raw_ptr_index(i)*_stride] = data;
@@ -346,7 +419,13 @@ class FixedArray
 	    throw py::error_already_set();
         }
 
-        if (_indices)
+        if (overlaps(data))
+        {
+            setitem_vector(index, data.copy());
+            return;
+        }
+
+        if (_indices.isMask())
         {
             for (size_t i=0; i<slicelength; ++i)
                 _ptr[raw_ptr_index(start+i*step)*_stride] = data[i];
@@ -364,11 +443,17 @@ class FixedArray
         // We could relax this but this restriction if there's a good
         // enough reason too.
 
-        if (_indices)
+        if (_indices.isMask())
         {
             throw IEX_NAMESPACE::ArgExc("We don't support setting item masks for masked reference arrays.");
         }
 
+        if (overlaps(data))
+        {
+            setitem_vector_mask(mask, data.copy());
+            return;
+        }
+
         size_t len = match_dimension(mask);
         if (data.len() == len)
         {
@@ -404,13 +489,13 @@ class FixedArray
     // no bounds checking on i!
     T& operator [] (size_t i)
     {
-        return _ptr[(_indices ? raw_ptr_index(i) : i) * _stride];
+        return _ptr[(_indices.isMask() ? raw_ptr_index(i) : i) * _stride];
     }
 
     // no bounds checking on i!
     const T& operator [] (size_t i) const
     {
-        return _ptr[(_indices ? raw_ptr_index(i) : i) * _stride];
+        return _ptr[(_indices.isMask() ? raw_ptr_index(i) : i) * _stride];
     }
 
     // no mask conversion or bounds checking on i!
@@ -425,7 +510,8 @@ class FixedArray
         return _ptr[i*_stride];
     }
 
-    bool isMaskedReference() const {return _indices.get() != 0;}
+    bool isMaskedReference() const {return _indices.isMask();}
+    const FixedArrayMask & mask() const {return _indices;}
     size_t unmaskedLength() const {return _unmaskedLength;}
 
     // Conversion of indices to raw pointer indices.
@@ -435,7 +521,7 @@ class FixedArray
     {
         assert(isMaskedReference());
         assert(i < _length);
-        assert(_indices[i] >= 0 && _indices[i] < _unmaskedLength);
+        assert(_indices[i] < _unmaskedLength);
         return _indices[i];
     }
 
@@ -446,11 +532,12 @@ class FixedArray
         typename FixedArray<T>::get_type (FixedArray<T>::*nonconst_getitem)(Py_ssize_t)= &FixedArray<T>::getitem;
         typename FixedArray<T>::get_type_const (FixedArray<T>::*const_getitem)(Py_ssize_t) const = &FixedArray<T>::getitem;
 
-        py::class_<FixedArray<T> > c(m, name(), doc);
+        py::class_<FixedArray<T> > c = FixedArrayBuffer<T>::template make_class<FixedArray<T> >(m, name(), doc);
         c
             .def(py::init<Py_ssize_t>(/*"construct an array of the specified length initialized to the default value for the type"*/))
             .def(py::init<const FixedArray<T> &>(/*"construct an array with the same values as the given array"*/))
             .def(py::init<const T &, Py_ssize_t>(/*"construct an array of the specified length initialized to the specified default value"*/))
+            .def_static("empty", &FixedArray<T>::empty, "empty(n) construct an array of the specified length without initializing its elements")
             .def("__getitem__", nonconst_getitem, call_policy<T>())
             .def("__getitem__", const_getitem, const_call_policy<T>())
             .def("__getitem__", &FixedArray<T>::getslice_mask)
@@ -460,9 +547,11 @@ class FixedArray
             .def("__setitem__", &FixedArray<T>::setitem_vector)
             .def("__setitem__", &FixedArray<T>::setitem_vector_mask)
             .def("__len__",&FixedArray<T>::len)
+            .def("copy",&FixedArray<T>::copy, "copy() return a detached copy of the array; slices are views of the array they were taken from")
             .def("ifelse",&FixedArray<T>::ifelse_scalar)
             .def("ifelse",&FixedArray<T>::ifelse_vector)
             ;
+        FixedArrayBuffer<T>::add(c);
         return c;
     }
 
@@ -475,7 +564,7 @@ class FixedArray
         bool throwExc = false;
         if (strictComparison)
             throwExc = true;
-        else if (_indices)
+        else if (_indices.isMask())
         {
             if (_unmaskedLength != a1.len())
                 throwExc = true;
@@ -494,18 +583,25 @@ class FixedArray
     FixedArray<T> ifelse_vector(const FixedArray<int> &choice, const FixedArray<T> &other) {
         size_t len = match_dimension(choice);
         match_dimension(other);
-        FixedArray<T> tmp(len); // should use default construction but V3f doens't initialize
+        FixedArray<T> tmp(len, UNINITIALIZED);
         for (size_t i=0; i < len; ++i) tmp[i] = choice[i] ? (*this)[i] : other[i];
         return tmp;
     }
 
     FixedArray<T> ifelse_scalar(const FixedArray<int> &choice, const T &other) {
         size_t len = match_dimension(choice);
-        FixedArray<T> tmp(len); // should use default construction but V3f doens't initialize
+        FixedArray<T> tmp(len, UNINITIALIZED);
         for (size_t i=0; i < len; ++i) tmp[i] = choice[i] ? (*this)[i] : other;
         return tmp;
     }
 
+    // An array whose elements are left as allocated, for results that
+    // are about to be overwritten anyway.
+    static FixedArray<T> empty(Py_ssize_t length)
+    {
+        return FixedArray<T>(length, UNINITIALIZED);
+    }
+
     // Instantiations of fixed ararys must implement this static member
     static const char *name();
 };
@@ -101,12 +101,23 @@ class FixedArray2D
             throw IEX_NAMESPACE::LogicExc("Fixed array 2d lengths must be non-negative");
         initializeSize();
         T tmp = FixedArrayDefaultValue<T>::value();
-        boost::shared_array<T> a(new T[_size]);
+        boost::shared_array<T> a(allocateArray<T>(_size));
         for (size_t i=0; i<_size; ++i) a[i] = tmp;
         _handle = a;
         _ptr = a.get();
     }
 
+    FixedArray2D(Py_ssize_t lengthX, Py_ssize_t lengthY, Uninitialized)
+        : _ptr(0), _length(lengthX, lengthY), _stride(1, lengthX), _handle()
+    {
+        if (lengthX < 0 || lengthY < 0)
+            throw IEX_NAMESPACE::LogicExc("Fixed array 2d lengths must be non-negative");
+        initializeSize();
+        boost::shared_array<T> a(allocateArray<T>(_size));
+        _handle = a;
+        _ptr = a.get();
+    }
+
     explicit FixedArray2D(const IMATH_NAMESPACE::V2i& length)
         : _ptr(0), _length(length), _stride(1, length.x), _handle()
     {
@@ -114,7 +125,7 @@ class FixedArray2D
             throw IEX_NAMESPACE::LogicExc("Fixed array 2d lengths must be non-negative");
         initializeSize();
         T tmp = FixedArrayDefaultValue<T>::value();
-        boost::shared_array<T> a(new T[_size]);
+        boost::shared_array<T> a(allocateArray<T>(_size));
         for (size_t i=0; i<_size; ++i) a[i] = tmp;
         _handle = a;
         _ptr = a.get();
@@ -126,7 +137,7 @@ class FixedArray2D
         if (lengthX < 0 || lengthY < 0)
             throw IEX_NAMESPACE::LogicExc("Fixed array 2d lengths must be non-negative");
         initializeSize();
-        boost::shared_array<T> a(new T[_size]);
+        boost::shared_array<T> a(allocateArray<T>(_size));
         for (size_t i=0; i<_size; ++i) a[i] = initialValue;
         _handle = a;
         _ptr = a.get();
@@ -141,7 +152,7 @@ class FixedArray2D
         : _ptr(0), _length(other.len()), _stride(1, other.len().x), _handle()
     {
         initializeSize();
-        boost::shared_array<T> a(new T[_size]);
+        boost::shared_array<T> a(allocateArray<T>(_size));
         size_t z = 0;
         for (size_t j = 0; j < _length.y; ++j)
             for (size_t i = 0; i < _length.x; ++i)
@@ -235,7 +246,7 @@ class FixedArray2D
             Py_ssize_t stepy=0;
             extract_slice_indices(PyTuple_GetItem(index, 0),_length.x,startx,endx,stepx,slicelengthx);
             extract_slice_indices(PyTuple_GetItem(index, 1),_length.y,starty,endy,stepy,slicelengthy);
-            FixedArray2D f(slicelengthx, slicelengthy);
+            FixedArray2D f(slicelengthx, slicelengthy, UNINITIALIZED);
             for (size_t j=0,z=0; j<slicelengthy; j++)
                 for (size_t i=0; i<slicelengthx; ++i)
                     f._ptr[z++] = (*this)(startx+i*stepx, starty+j*stepy);
@@ -402,11 +413,12 @@ class FixedArray2D
 
     static py::class_<FixedArray2D<T> > register_(py::module &m, const char *name, const char *doc)
     {
-        py::class_<FixedArray2D<T> > c(m, name, doc);
+        py::class_<FixedArray2D<T> > c = FixedArrayBuffer<T>::template make_class<FixedArray2D<T> >(m, name, doc);
         c
             .def(py::init<Py_ssize_t, Py_ssize_t>(/*"construct an array of the specified length initialized to the default value for the type"*/))
             .def(py::init<const FixedArray2D<T> &>(/*"construct an array with the same values as the given array"*/))
             .def(py::init<const T &, Py_ssize_t, Py_ssize_t>(/*"construct an array of the specified length initialized to the specified default value"*/))
+            .def_static("empty", &FixedArray2D<T>::empty, "empty(x,y) construct an array of the specified size without initializing its elements")
             .def("__getitem__", &FixedArray2D<T>::getslice)
             .def("__getitem__", &FixedArray2D<T>::getslice_mask)
 //             .def("__getitem__", &FixedArray2D<T>::getitem, call_policy())
@@ -423,6 +435,7 @@ class FixedArray2D
             .def("ifelse",&FixedArray2D<T>::ifelse_scalar)
             .def("ifelse",&FixedArray2D<T>::ifelse_vector)
             ;
+        FixedArrayBuffer<T>::add2D(c);
         return c;
     }
 
@@ -446,10 +459,15 @@ class FixedArray2D
         return len();
     }
 
+    static FixedArray2D<T> empty(Py_ssize_t lengthX, Py_ssize_t lengthY)
+    {
+        return FixedArray2D<T>(lengthX, lengthY, UNINITIALIZED);
+    }
+
     FixedArray2D<T> ifelse_vector(const FixedArray2D<int> &choice, const FixedArray2D<T> &other) {
         IMATH_NAMESPACE::Vec2<size_t> len = match_dimension(choice);
         match_dimension(other);
-        FixedArray2D<T> tmp(len); // should use default construction but V3f doens't initialize
+        FixedArray2D<T> tmp(len.x, len.y, UNINITIALIZED);
         for (size_t j = 0; j < len.y; ++j)
             for (size_t i = 0; i < len.x; ++i)
                 tmp(i,j) = choice(i,j) ? (*this)(i,j) : other(i,j);
@@ -458,7 +476,7 @@ class FixedArray2D
 
     FixedArray2D<T> ifelse_scalar(const FixedArray2D<int> &choice, const T &other) {
         IMATH_NAMESPACE::Vec2<size_t> len = match_dimension(choice);
-        FixedArray2D<T> tmp(len); // should use default construction but V3f doens't initialize
+        FixedArray2D<T> tmp(len.x, len.y, UNINITIALIZED);
         for (size_t j = 0; j < len.y; ++j)
             for (size_t i = 0; i < len.x; ++i)
                 tmp(i,j) = choice(i,j) ? (*this)(i,j) : other;
@@ -472,7 +490,7 @@ template <template <class,class> class Op, class T1, class Ret>
 FixedArray2D<Ret> apply_array2d_unary_op(const FixedArray2D<T1> &a1)
 {
     IMATH_NAMESPACE::Vec2<size_t> len = a1.len();
-    FixedArray2D<Ret> retval(len.x,len.y);
+    FixedArray2D<Ret> retval(len.x,len.y,UNINITIALIZED);
     for (int j=0; j<len.y; ++j) {
         for (int i=0;i<len.x;++i) {
             retval(i,j) = Op<T1,Ret>::apply(a1(i,j));
@@ -486,7 +504,7 @@ template <template <class,class,class> class Op, class T1, class T2, class Ret>
 FixedArray2D<Ret> apply_array2d_array2d_binary_op(const FixedArray2D<T1> &a1, const FixedArray2D<T2> &a2)
 {
     IMATH_NAMESPACE::Vec2<size_t> len = a1.match_dimension(a2);
-    FixedArray2D<Ret> retval(len.x,len.y);
+    FixedArray2D<Ret> retval(len.x,len.y,UNINITIALIZED);
     for (int j=0; j<len.y; ++j) {
         for (int i=0;i<len.x;++i) {
             retval(i,j) = Op<T1,T2,Ret>::apply(a1(i,j),a2(i,j));
@@ -499,7 +517,7 @@ template <template <class,class,class> class Op, class T1, class T2, class Ret>
 FixedArray2D<Ret> apply_array2d_scalar_binary_op(const FixedArray2D<T1> &a1, const T2 &a2)
 {
     IMATH_NAMESPACE::Vec2<size_t> len = a1.len();
-    FixedArray2D<Ret> retval(len.x,len.y);
+    FixedArray2D<Ret> retval(len.x,len.y,UNINITIALIZED);
     for (int j=0; j<len.y; ++j) {
         for (int i=0;i<len.x;++i) {
             retval(i,j) = Op<T1,T2,Ret>::apply(a1(i,j),a2);
@@ -512,7 +530,7 @@ template <template <class,class,class> class Op, class T1, class T2, class Ret>
 FixedArray2D<Ret> apply_array2d_scalar_binary_rop(const FixedArray2D<T1> &a1, const T2 &a2)
 {
     IMATH_NAMESPACE::Vec2<size_t> len = a1.len();
-    FixedArray2D<Ret> retval(len.x,len.y);
+    FixedArray2D<Ret> retval(len.x,len.y,UNINITIALIZED);
     for (int j=0; j<len.y; ++j) {
         for (int i=0;i<len.x;++i) {
             retval(i,j) = Op<T2,T1,Ret>::apply(a2,a1(i,j));
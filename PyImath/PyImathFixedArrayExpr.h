@@ -0,0 +1,429 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathFixedArrayExpr_h_
+#define _PyImathFixedArrayExpr_h_
+
+#include "python_include.h"
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <PyImathFixedArray.h>
+#include <PyImathOperators.h>
+#include <PyImathVecOperators.h>
+#include <PyImathMathExc.h>
+#include <PyImathTask.h>
+
+namespace PyImath {
+
+//
+// Deferred expressions over FixedArrays.
+//
+// a.lazy() wraps an array in a FixedArrayExpr, and arithmetic on the
+// expression builds a tree of nodes instead of a temporary array per
+// operator.  Evaluating the expression runs the whole tree in a single
+// pass over blocks small enough to stay in cache, so a chain like
+// (a.lazy()*2.0 + b).normalized() reads each input once and allocates
+// only the result.
+//
+// The leaves share storage with the arrays they were built from, so
+// the inputs are read when the expression is evaluated, not when it
+// is built.
+//
+
+// Elements per block handed down the tree.  Each node buffers one block
+// of each operand in a scratch area allocated once per task, so stack
+// use does not grow with the depth of the tree or the element size.
+static const size_t exprBlockSize = 256;
+
+// Bytes of scratch for one block of T, rounded up so that the next
+// buffer carved out after it stays aligned.
+template <class T>
+inline size_t
+exprBufferSize()
+{
+    const size_t align = alignof(std::max_align_t);
+    return (sizeof(T) * exprBlockSize + align - 1) / align * align;
+}
+
+// Scratch for evaluating node, aligned for any element type.
+template <class Node>
+inline std::vector<std::max_align_t>
+exprScratch(const Node &node)
+{
+    return std::vector<std::max_align_t>(node.scratchSize() / sizeof(std::max_align_t) + 1);
+}
+
+template <class T>
+class ExprNode
+{
+  public:
+    virtual ~ExprNode() {}
+
+    virtual size_t len() const = 0;
+
+    // scalars broadcast against arrays of any length
+    virtual bool isScalar() const { return false; }
+
+    // elementCost() for evaluating the tree rooted here
+    virtual size_t cost() const = 0;
+
+    // bytes of scratch evaluate() needs for the tree rooted here
+    virtual size_t scratchSize() const { return 0; }
+
+    // write elements [start,end) to out; end-start <= exprBlockSize,
+    // and scratch holds at least scratchSize() bytes
+    virtual void evaluate(size_t start, size_t end, T *out, char *scratch) const = 0;
+};
+
+template <class T>
+class ArrayExprNode : public ExprNode<T>
+{
+    FixedArray<T> _array;
+
+  public:
+    explicit ArrayExprNode(const FixedArray<T> &array) : _array(array) {}
+
+    size_t len() const { return _array.len(); }
+    size_t cost() const { return 1; }
+
+    void evaluate(size_t start, size_t end, T *out, char *) const
+    {
+        if (_array.isMaskedReference())
+        {
+            FixedArrayMask::Cursor raw(_array.mask(), start);
+            for (size_t i = start; i < end; ++i)
+                *out++ = _array.direct_index(raw.next());
+        }
+        else
+        {
+            for (size_t i = start; i < end; ++i)
+                *out++ = _array.direct_index(i);
+        }
+    }
+};
+
+template <class T>
+class ScalarExprNode : public ExprNode<T>
+{
+    T _value;
+
+  public:
+    explicit ScalarExprNode(const T &value) : _value(value) {}
+
+    size_t len() const { return 1; }
+    bool isScalar() const { return true; }
+    size_t cost() const { return 0; }
+
+    void evaluate(size_t start, size_t end, T *out, char *) const
+    {
+        std::fill(out, out + (end - start), _value);
+    }
+};
+
+template <class Op, class R, class A>
+class UnaryExprNode : public ExprNode<R>
+{
+    boost::shared_ptr<const ExprNode<A> > _a;
+
+  public:
+    explicit UnaryExprNode(const boost::shared_ptr<const ExprNode<A> > &a) : _a(a) {}
+
+    size_t len() const { return _a->len(); }
+    bool isScalar() const { return _a->isScalar(); }
+    size_t cost() const { return 1 + _a->cost(); }
+    size_t scratchSize() const { return exprBufferSize<A>() + _a->scratchSize(); }
+
+    void evaluate(size_t start, size_t end, R *out, char *scratch) const
+    {
+        A *a = reinterpret_cast<A *>(scratch);
+        _a->evaluate(start, end, a, scratch + exprBufferSize<A>());
+        for (size_t i = 0, n = end - start; i < n; ++i)
+            out[i] = Op::apply(a[i]);
+    }
+};
+
+template <class Op, class R, class A, class B>
+class BinaryExprNode : public ExprNode<R>
+{
+    boost::shared_ptr<const ExprNode<A> > _a;
+    boost::shared_ptr<const ExprNode<B> > _b;
+    size_t _len;
+
+  public:
+    BinaryExprNode(const boost::shared_ptr<const ExprNode<A> > &a,
+                   const boost::shared_ptr<const ExprNode<B> > &b)
+        : _a(a), _b(b), _len(a->len())
+    {
+        if (_a->isScalar())
+            _len = _b->len();
+        else if (!_b->isScalar() && _b->len() != _len)
+            throw IEX_NAMESPACE::ArgExc("Array dimensions passed into function do not match");
+    }
+
+    size_t len() const { return _len; }
+    bool isScalar() const { return _a->isScalar() && _b->isScalar(); }
+    size_t cost() const { return 1 + _a->cost() + _b->cost(); }
+
+    // the operands are evaluated one after the other, so they share the
+    // scratch past this node's own buffers
+    size_t scratchSize() const
+    {
+        return exprBufferSize<A>() + exprBufferSize<B>() +
+               std::max(_a->scratchSize(), _b->scratchSize());
+    }
+
+    void evaluate(size_t start, size_t end, R *out, char *scratch) const
+    {
+        A *a = reinterpret_cast<A *>(scratch);
+        B *b = reinterpret_cast<B *>(scratch + exprBufferSize<A>());
+        char *rest = scratch + exprBufferSize<A>() + exprBufferSize<B>();
+        _a->evaluate(start, end, a, rest);
+        _b->evaluate(start, end, b, rest);
+        for (size_t i = 0, n = end - start; i < n; ++i)
+            out[i] = Op::apply(a[i], b[i]);
+    }
+};
+
+template <class T>
+struct EvaluateExprTask : public Task
+{
+    const ExprNode<T> &node;
+    FixedArray<T> &result;
+
+    EvaluateExprTask(const ExprNode<T> &n, FixedArray<T> &r) : node(n), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        std::vector<std::max_align_t> scratch = exprScratch(node);
+
+        // result is freshly allocated and so contiguous
+        for (size_t s = start; s < end; s += exprBlockSize)
+            node.evaluate(s, std::min(end, s + exprBlockSize), &result.direct_index(s),
+                          reinterpret_cast<char *>(&scratch[0]));
+    }
+
+    size_t elementCost() const { return node.cost(); }
+    size_t minGrain() const { return exprBlockSize; }
+};
+
+template <class T>
+class FixedArrayExpr
+{
+    boost::shared_ptr<const ExprNode<T> > _node;
+
+  public:
+    typedef boost::shared_ptr<const ExprNode<T> > NodePtr;
+
+    explicit FixedArrayExpr(const NodePtr &node) : _node(node) {}
+
+    explicit FixedArrayExpr(const FixedArray<T> &array)
+        : _node(new ArrayExprNode<T>(array))
+    {}
+
+    static FixedArrayExpr scalar(const T &value)
+    {
+        return FixedArrayExpr(NodePtr(new ScalarExprNode<T>(value)));
+    }
+
+    static FixedArrayExpr lazy(const FixedArray<T> &array)
+    {
+        return FixedArrayExpr(array);
+    }
+
+    const NodePtr & node() const { return _node; }
+
+    Py_ssize_t len() const { return _node->len(); }
+
+    FixedArray<T> eval() const
+    {
+        MATH_EXC_ON;
+        size_t len = _node->len();
+        FixedArray<T> result(Py_ssize_t(len), UNINITIALIZED);
+        EvaluateExprTask<T> task(*_node, result);
+        dispatchTask(task, len);
+        mathexcon.handleOutstandingExceptions();
+        return result;
+    }
+
+    // evaluates just the one element, for reading an expression
+    // without materializing it
+    T getitem(Py_ssize_t index) const
+    {
+        MATH_EXC_ON;
+        Py_ssize_t length = len();
+        if (index < 0) index += length;
+        if (index >= length || index < 0) {
+            PyErr_SetString(PyExc_IndexError, "Index out of range");
+            throw py::error_already_set();
+        }
+        T value;
+        std::vector<std::max_align_t> scratch = exprScratch(*_node);
+        _node->evaluate(index, index+1, &value, reinterpret_cast<char *>(&scratch[0]));
+        mathexcon.handleOutstandingExceptions();
+        return value;
+    }
+
+    static const char *name()
+    {
+        static const std::string exprName = std::string(FixedArray<T>::name()) + "Expr";
+        return exprName.c_str();
+    }
+
+    static py::class_<FixedArrayExpr<T> > register_(py::module &m, const char *doc)
+    {
+        py::class_<FixedArrayExpr<T> > c(m, name(), doc);
+        c
+            .def("__len__", &FixedArrayExpr<T>::len)
+            .def("__getitem__", &FixedArrayExpr<T>::getitem)
+            .def("eval", &FixedArrayExpr<T>::eval, "evaluate the expression into a new array in a single pass")
+            ;
+        return c;
+    }
+};
+
+template <class Op, class R, class A, class B>
+struct expr_binary
+{
+    static FixedArrayExpr<R> withExpr(const FixedArrayExpr<A> &a, const FixedArrayExpr<B> &b)
+    {
+        return FixedArrayExpr<R>(typename FixedArrayExpr<R>::NodePtr(
+            new BinaryExprNode<Op,R,A,B>(a.node(), b.node())));
+    }
+
+    static FixedArrayExpr<R> withArray(const FixedArrayExpr<A> &a, const FixedArray<B> &b)
+    {
+        return withExpr(a, FixedArrayExpr<B>(b));
+    }
+
+    static FixedArrayExpr<R> withScalar(const FixedArrayExpr<A> &a, const B &b)
+    {
+        return withExpr(a, FixedArrayExpr<B>::scalar(b));
+    }
+};
+
+template <class Op, class R, class A>
+struct expr_unary
+{
+    static FixedArrayExpr<R> apply(const FixedArrayExpr<A> &a)
+    {
+        return FixedArrayExpr<R>(typename FixedArrayExpr<R>::NodePtr(
+            new UnaryExprNode<Op,R,A>(a.node())));
+    }
+};
+
+template <class Op, class R, class A, class B>
+static void add_expr_binary(py::class_<FixedArrayExpr<A> > &c, const char *name, const char *doc)
+{
+    typedef expr_binary<Op,R,A,B> binary;
+    c
+        .def(name, &binary::withScalar, doc, py::arg("x"))
+        .def(name, &binary::withArray, doc, py::arg("x"))
+        .def(name, &binary::withExpr, doc, py::arg("x"))
+        ;
+}
+
+template <class Op, class R, class A>
+static void add_expr_unary(py::class_<FixedArrayExpr<A> > &c, const char *name, const char *doc)
+{
+    c.def(name, &expr_unary<Op,R,A>::apply, doc);
+}
+
+template <class T>
+static FixedArray<T> *
+FixedArray_fromExpr(const FixedArrayExpr<T> &expr)
+{
+    return new FixedArray<T>(expr.eval());
+}
+
+//
+// Registers the expression type for T, gives the array type a lazy()
+// method, and lets an expression be passed wherever the array type is
+// expected, evaluating it on the way in.
+//
+template <class T>
+static py::class_<FixedArrayExpr<T> >
+add_lazy_arithmetic_functions(py::module &m, py::class_<FixedArray<T> > &c)
+{
+    py::class_<FixedArrayExpr<T> > e = FixedArrayExpr<T>::register_(m, "Deferred expression over a fixed length array");
+
+    add_expr_binary<op_add<T>,T,T,T>(e, "__add__", "self+x");
+    add_expr_binary<op_add<T>,T,T,T>(e, "__radd__", "x+self");
+    add_expr_binary<op_sub<T>,T,T,T>(e, "__sub__", "self-x");
+    add_expr_binary<op_rsub<T>,T,T,T>(e, "__rsub__", "x-self");
+    add_expr_binary<op_mul<T>,T,T,T>(e, "__mul__", "self*x");
+    add_expr_binary<op_mul<T>,T,T,T>(e, "__rmul__", "x*self");
+    add_expr_binary<op_div<T>,T,T,T>(e, "__div__", "self/x");
+    add_expr_binary<op_div<T>,T,T,T>(e, "__truediv__", "self/x");
+    add_expr_unary<op_neg<T>,T,T>(e, "__neg__", "-x");
+
+    c
+        .def("lazy", &FixedArrayExpr<T>::lazy,
+             "return a deferred expression over this array; arithmetic on it is fused into one pass by eval()")
+        .def(py::init(&FixedArray_fromExpr<T>))
+        ;
+    py::implicitly_convertible<FixedArrayExpr<T>, FixedArray<T> >();
+
+    return e;
+}
+
+template <class V>
+static void add_lazy_vec_functions(py::class_<FixedArrayExpr<V> > &e)
+{
+    typedef typename V::BaseType S;
+
+    add_expr_binary<op_mul<V,S>,V,V,S>(e, "__mul__", "self*x");
+    add_expr_binary<op_mul<V,S>,V,V,S>(e, "__rmul__", "x*self");
+    add_expr_binary<op_div<V,S>,V,V,S>(e, "__div__", "self/x");
+    add_expr_binary<op_div<V,S>,V,V,S>(e, "__truediv__", "self/x");
+
+    add_expr_unary<op_vecLength<V>,S,V>(e, "length", "");
+    add_expr_unary<op_vecLength2<V>,S,V>(e, "length2", "");
+    add_expr_unary<op_vecNormalized<V>,V,V>(e, "normalized", "");
+    add_expr_binary<op_vecDot<V>,S,V,V>(e, "dot", "return the inner product of (self,x)");
+}
+
+template <class T>
+static void add_lazy_vec3_functions(py::class_<FixedArrayExpr<IMATH_NAMESPACE::Vec3<T> > > &e)
+{
+    add_expr_binary<op_vec3Cross<T>,IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::Vec3<T> >(
+        e, "cross", "return the cross product of (self,x)");
+}
+
+} // namespace PyImath
+
+#endif // _PyImathFixedArrayExpr_h_
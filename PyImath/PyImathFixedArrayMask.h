@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef _PyImathFixedArrayMask_h_
+#define _PyImathFixedArrayMask_h_
+
+#include <boost/shared_array.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <stdint.h>
+
+namespace PyImath {
+
+//
+// The index map of a masked reference: element i of the masked array
+// is element (*this)[i] of the underlying storage.  Masks are immutable
+// once built and shared between copies of the array.
+//
+// Selections that consist of a few long runs (e.g. one object's range
+// out of a packed buffer) are stored run-length encoded, which takes
+// no memory per element and keeps the accesses sequential.  Other
+// selections store one index per element, as 32 bit indices whenever
+// the underlying array is small enough.
+//
+class FixedArrayMask
+{
+    struct Run
+    {
+        size_t offset;  // index of the run's first element in the masked array
+        size_t raw;     // index of the run's first element in the storage
+    };
+
+    size_t                          _length;
+    size_t                          _numRuns;
+    boost::shared_array<Run>        _runs;
+    boost::shared_array<uint32_t>   _indices32;
+    boost::shared_array<size_t>     _indices;
+
+  public:
+
+    FixedArrayMask() : _length(0), _numRuns(0) {}
+
+    size_t len() const { return _length; }
+
+    bool isMask() const { return _runs || _indices32 || _indices; }
+    bool isRunLengthEncoded() const { return bool(_runs); }
+    size_t numRuns() const { return _numRuns; }
+
+    // no bounds checking on i!
+    size_t operator [] (size_t i) const
+    {
+        if (_indices32)
+            return _indices32[i];
+        if (_indices)
+            return _indices[i];
+        if (_numRuns == 1)
+            return _runs[0].raw + i;
+
+        const Run *run = findRun(i);
+        return run->raw + (i - run->offset);
+    }
+
+    class Builder;
+    class Cursor;
+
+  private:
+
+    // the run holding element i; a binary search
+    const Run *findRun(size_t i) const
+    {
+        const Run *first = _runs.get();
+        const Run *last = first + _numRuns;
+        while (last - first > 1)
+        {
+            const Run *mid = first + (last - first) / 2;
+            if (mid->offset <= i)
+                first = mid;
+            else
+                last = mid;
+        }
+        return first;
+    }
+};
+
+//
+// Walks the storage indices of consecutive elements, starting from any
+// element.  Indexing a run-length encoded mask searches its runs, so
+// loops over masked arrays step a cursor instead, which only searches
+// once.  A cursor over an empty mask (an unmasked array) yields the
+// element indices themselves.
+//
+class FixedArrayMask::Cursor
+{
+    size_t              _i;
+    const uint32_t *    _indices32;
+    const size_t *      _indices;
+    const Run *         _run;
+    size_t              _runEnd;
+    const Run *         _lastRun;
+    size_t              _length;
+
+  public:
+
+    Cursor(const FixedArrayMask &mask, size_t start)
+        : _i(start), _indices32(mask._indices32.get()), _indices(mask._indices.get()),
+          _run(0), _runEnd(0), _lastRun(0), _length(mask._length)
+    {
+        if (mask._runs)
+        {
+            _run = mask.findRun(start);
+            _lastRun = mask._runs.get() + mask._numRuns - 1;
+            _runEnd = _run == _lastRun ? _length : (_run+1)->offset;
+        }
+    }
+
+    // the storage index of the current element, then moves to the next;
+    // no bounds checking!
+    size_t next()
+    {
+        if (_indices32)
+            return _indices32[_i++];
+        if (_indices)
+            return _indices[_i++];
+        if (!_run)
+            return _i++;
+
+        if (_i == _runEnd)
+        {
+            ++_run;
+            _runEnd = _run == _lastRun ? _length : (_run+1)->offset;
+        }
+        return _run->raw + (_i++ - _run->offset);
+    }
+};
+
+//
+// Builds a mask from the storage indices of the selected elements,
+// appended in order.  The number of elements must be known up front;
+// the builder starts out run-length encoding and switches to explicit
+// indices once the runs get too short to pay off.
+//
+class FixedArrayMask::Builder
+{
+    FixedArrayMask      _mask;
+    std::vector<Run>    _runs;
+    size_t              _maxRuns;
+    size_t              _count;
+    size_t              _last;
+    bool                _indices32;
+
+    void expand()
+    {
+        for (size_t r = 0; r < _runs.size(); ++r)
+        {
+            size_t end = r+1 < _runs.size() ? _runs[r+1].offset : _count;
+            for (size_t i = _runs[r].offset; i < end; ++i)
+                store(i, _runs[r].raw + (i - _runs[r].offset));
+        }
+        std::vector<Run>().swap(_runs);
+    }
+
+    void store(size_t i, size_t raw)
+    {
+        if (_mask._indices32)
+            _mask._indices32[i] = uint32_t(raw);
+        else
+            _mask._indices[i] = raw;
+    }
+
+    bool explicitIndices() const { return _mask._indices32 || _mask._indices; }
+
+  public:
+
+    Builder(size_t length, size_t unmaskedLength)
+        : _maxRuns(std::max(length / 16, size_t(4))), _count(0), _last(0)
+    {
+        _mask._length = length;
+        _indices32 = unmaskedLength <= size_t(std::numeric_limits<uint32_t>::max());
+    }
+
+    void append(size_t raw)
+    {
+        if (explicitIndices())
+        {
+            store(_count++, raw);
+            return;
+        }
+
+        if (_count > 0 && raw == _last + 1)
+        {
+            _last = raw;
+            ++_count;
+            return;
+        }
+
+        if (_runs.size() == _maxRuns)
+        {
+            if (_indices32)
+                _mask._indices32.reset(new uint32_t[_mask._length]);
+            else
+                _mask._indices.reset(new size_t[_mask._length]);
+            expand();
+            store(_count++, raw);
+            return;
+        }
+
+        Run run = { _count, raw };
+        _runs.push_back(run);
+        _last = raw;
+        ++_count;
+    }
+
+    FixedArrayMask mask()
+    {
+        if (!explicitIndices())
+        {
+            // an empty selection still has to be a mask
+            if (_runs.empty())
+            {
+                Run run = { 0, 0 };
+                _runs.push_back(run);
+            }
+            _mask._numRuns = _runs.size();
+            _mask._runs.reset(new Run[_runs.size()]);
+            std::copy(_runs.begin(), _runs.end(), _mask._runs.get());
+        }
+        return _mask;
+    }
+};
+
+} // namespace PyImath
+
+#endif // _PyImathFixedArrayMask_h_
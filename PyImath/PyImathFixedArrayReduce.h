@@ -0,0 +1,413 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef _PyImathFixedArrayReduce_h_
+#define _PyImathFixedArrayReduce_h_
+
+#include "python_include.h"
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/mpl/if.hpp>
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+#include <Iex.h>
+#include <ImathVec.h>
+#include <PyImathFixedArray.h>
+#include <PyImathTask.h>
+
+namespace PyImath {
+
+//
+// Single pass min/max/sum reductions over scalar and Vec2/3/4 arrays.
+//
+// The array is cut into fixed size blocks that are reduced in parallel,
+// and the per-block results are combined in block order, so the result
+// does not depend on the number of threads.  Inside a block, contiguous
+// arrays are reduced as a flat run of components into a few vector
+// registers' worth of independent accumulators, which the compiler turns
+// into packed min/max/add instructions; strided and masked arrays take
+// the element by element path.
+//
+
+enum ReduceOps
+{
+    REDUCE_MIN = 1,
+    REDUCE_MAX = 2,
+    REDUCE_SUM = 4,
+    REDUCE_ALL = REDUCE_MIN | REDUCE_MAX | REDUCE_SUM
+};
+
+//
+// The type sums are accumulated in: double for floating point
+// components, and 64 bit integers for integer ones, so that sums and
+// means of small integer types don't wrap.
+//
+template <class B>
+struct ReduceAccumulator
+{
+    typedef typename boost::mpl::if_<boost::is_floating_point<B>, double,
+            typename boost::mpl::if_<boost::is_signed<B>, int64_t, uint64_t>::type>::type type;
+};
+
+//
+// How the reductions see an element type: as dimensions components of
+// type base_type, summed as accumulate_type.  Scalar sums are returned
+// as accumulate_type for integers, and vector sums of integer vectors
+// as the double vector type.  The mean of integer types is computed in
+// double.
+//
+template <class T>
+struct ReduceTraits
+{
+    typedef T base_type;
+    static const int dimensions = 1;
+    typedef typename ReduceAccumulator<T>::type accumulate_type;
+    typedef typename boost::mpl::if_<boost::is_floating_point<T>,T,accumulate_type>::type sum_type;
+    typedef typename boost::mpl::if_<boost::is_floating_point<T>,T,double>::type mean_type;
+
+    static base_type *components(T &v) { return &v; }
+    static const base_type *components(const T &v) { return &v; }
+    static T zero() { return T(0); }
+    static sum_type sum(const accumulate_type *s) { return sum_type(s[0]); }
+    static mean_type mean(const accumulate_type *s, size_t count) { return mean_type(double(s[0]) / double(count)); }
+};
+
+template <class V, int N, class M>
+struct VecReduceTraits
+{
+    typedef typename V::BaseType base_type;
+    static const int dimensions = N;
+    typedef typename ReduceAccumulator<base_type>::type accumulate_type;
+    typedef M sum_type;
+    typedef M mean_type;
+
+    static base_type *components(V &v) { return &v[0]; }
+    static const base_type *components(const V &v) { return &v[0]; }
+    static V zero() { return V(base_type(0)); }
+
+    static M sum(const accumulate_type *s)
+    {
+        M m;
+        for (int c = 0; c < N; ++c)
+            m[c] = typename M::BaseType(s[c]);
+        return m;
+    }
+
+    static M mean(const accumulate_type *s, size_t count)
+    {
+        M m;
+        for (int c = 0; c < N; ++c)
+            m[c] = typename M::BaseType(double(s[c]) / double(count));
+        return m;
+    }
+};
+
+template <class T>
+struct ReduceMeanBase
+{
+    typedef typename boost::mpl::if_<boost::is_floating_point<T>,T,double>::type type;
+};
+
+template <class T>
+struct ReduceTraits<IMATH_NAMESPACE::Vec2<T> >
+    : VecReduceTraits<IMATH_NAMESPACE::Vec2<T>,2,IMATH_NAMESPACE::Vec2<typename ReduceMeanBase<T>::type> > {};
+
+template <class T>
+struct ReduceTraits<IMATH_NAMESPACE::Vec3<T> >
+    : VecReduceTraits<IMATH_NAMESPACE::Vec3<T>,3,IMATH_NAMESPACE::Vec3<typename ReduceMeanBase<T>::type> > {};
+
+template <class T>
+struct ReduceTraits<IMATH_NAMESPACE::Vec4<T> >
+    : VecReduceTraits<IMATH_NAMESPACE::Vec4<T>,4,IMATH_NAMESPACE::Vec4<typename ReduceMeanBase<T>::type> > {};
+
+//
+// The result of a reduction.  min, max and mean are only meaningful if
+// count is non-zero; sum is zero for an empty array.
+//
+template <class T>
+struct ArrayReduction
+{
+    typedef ReduceTraits<T> traits;
+
+    T                                   min;
+    T                                   max;
+    typename traits::sum_type           sum;
+    typename traits::mean_type          mean;
+    size_t                              count;
+
+    ArrayReduction() : min(traits::zero()), max(traits::zero()),
+                       sum(ReduceTraits<typename traits::sum_type>::zero()),
+                       mean(ReduceTraits<typename traits::mean_type>::zero()), count(0) {}
+};
+
+namespace detail {
+
+static const size_t reduceBlockSize = 8192;
+
+template <int Ops, class B, int N>
+struct ComponentReducer
+{
+    typedef typename ReduceAccumulator<B>::type A;
+
+    B       min[N];
+    B       max[N];
+    A       sum[N];
+    size_t  count;
+
+    ComponentReducer() : count(0)
+    {
+        for (int c = 0; c < N; ++c)
+        {
+            min[c] = max[c] = B(0);
+            sum[c] = A(0);
+        }
+    }
+
+    void first(const B *v)
+    {
+        for (int c = 0; c < N; ++c)
+            min[c] = max[c] = v[c];
+    }
+
+    void add(const B *v)
+    {
+        if (count++ == 0)
+            first(v);
+        for (int c = 0; c < N; ++c)
+        {
+            if (Ops & REDUCE_MIN) min[c] = v[c] < min[c] ? v[c] : min[c];
+            if (Ops & REDUCE_MAX) max[c] = v[c] > max[c] ? v[c] : max[c];
+            if (Ops & REDUCE_SUM) sum[c] += v[c];
+        }
+    }
+
+    //
+    // Reduce n consecutive elements stored as n*N contiguous components.
+    // The accumulators cover a whole number of elements, so lane l always
+    // holds component l % N.
+    //
+    void addContiguous(const B *p, size_t n)
+    {
+        if (n == 0)
+            return;
+        if (count == 0)
+            first(p);
+
+        const int W = boost::is_arithmetic<B>::value && sizeof(B) < 32 ? int(32 / sizeof(B)) : 1;
+        const int L = N * W;
+
+        B accMin[L], accMax[L];
+        A accSum[L];
+        for (int l = 0; l < L; ++l)
+        {
+            accMin[l] = min[l % N];
+            accMax[l] = max[l % N];
+            accSum[l] = A(0);
+        }
+
+        const size_t total = n * N;
+        size_t i = 0;
+        for (; i + L <= total; i += L)
+        {
+            for (int l = 0; l < L; ++l)
+            {
+                B v = p[i+l];
+                if (Ops & REDUCE_MIN) accMin[l] = v < accMin[l] ? v : accMin[l];
+                if (Ops & REDUCE_MAX) accMax[l] = v > accMax[l] ? v : accMax[l];
+                if (Ops & REDUCE_SUM) accSum[l] += v;
+            }
+        }
+
+        for (int l = 0; l < L; ++l)
+        {
+            int c = l % N;
+            if (Ops & REDUCE_MIN) min[c] = accMin[l] < min[c] ? accMin[l] : min[c];
+            if (Ops & REDUCE_MAX) max[c] = accMax[l] > max[c] ? accMax[l] : max[c];
+            if (Ops & REDUCE_SUM) sum[c] += accSum[l];
+        }
+
+        for (; i < total; ++i)
+        {
+            int c = int(i % N);
+            B v = p[i];
+            if (Ops & REDUCE_MIN) min[c] = v < min[c] ? v : min[c];
+            if (Ops & REDUCE_MAX) max[c] = v > max[c] ? v : max[c];
+            if (Ops & REDUCE_SUM) sum[c] += v;
+        }
+
+        count += n;
+    }
+
+    void merge(const ComponentReducer &other)
+    {
+        if (other.count == 0)
+            return;
+        for (int c = 0; c < N; ++c)
+        {
+            if (count == 0)
+            {
+                min[c] = other.min[c];
+                max[c] = other.max[c];
+            }
+            else
+            {
+                if (Ops & REDUCE_MIN) min[c] = other.min[c] < min[c] ? other.min[c] : min[c];
+                if (Ops & REDUCE_MAX) max[c] = other.max[c] > max[c] ? other.max[c] : max[c];
+            }
+            if (Ops & REDUCE_SUM) sum[c] += other.sum[c];
+        }
+        count += other.count;
+    }
+};
+
+template <int Ops, class T>
+struct ReduceTask : public Task
+{
+    typedef ReduceTraits<T> traits;
+    typedef ComponentReducer<Ops,typename traits::base_type,traits::dimensions> reducer_type;
+
+    const FixedArray<T> &               array;
+    std::vector<reducer_type> &         blocks;
+
+    ReduceTask(const FixedArray<T> &a, std::vector<reducer_type> &b)
+        : array(a), blocks(b) {}
+
+    size_t elementCost() const { return reduceBlockSize * traits::dimensions; }
+
+    void execute(size_t start, size_t end)
+    {
+        const size_t len = array.len();
+        for (size_t b = start; b < end; ++b)
+        {
+            reducer_type &r = blocks[b];
+            const size_t first = b * reduceBlockSize;
+            const size_t last = std::min(len, first + reduceBlockSize);
+
+            if (array.isMaskedReference())
+            {
+                FixedArrayMask::Cursor raw(array.mask(), first);
+                for (size_t i = first; i < last; ++i)
+                    r.add(traits::components(array.direct_index(raw.next())));
+            }
+            else if (array.stride() == 1)
+            {
+                r.addContiguous(traits::components(array.direct_index(first)), last - first);
+            }
+            else
+            {
+                for (size_t i = first; i < last; ++i)
+                    r.add(traits::components(array.direct_index(i)));
+            }
+        }
+    }
+};
+
+} // namespace detail
+
+//
+// Reduce a with the operations in Ops, in one pass.
+//
+template <int Ops, class T>
+ArrayReduction<T>
+reduceArray(const FixedArray<T> &a)
+{
+    typedef ReduceTraits<T> traits;
+    typedef typename detail::ReduceTask<Ops,T>::reducer_type reducer_type;
+
+    ArrayReduction<T> result;
+    const size_t len = a.len();
+    if (len == 0)
+        return result;
+
+    const size_t numBlocks = (len + detail::reduceBlockSize - 1) / detail::reduceBlockSize;
+    std::vector<reducer_type> blocks(numBlocks);
+    detail::ReduceTask<Ops,T> task(a, blocks);
+    dispatchTask(task, numBlocks);
+
+    reducer_type total;
+    for (size_t b = 0; b < numBlocks; ++b)
+        total.merge(blocks[b]);
+
+    for (int c = 0; c < traits::dimensions; ++c)
+    {
+        traits::components(result.min)[c] = total.min[c];
+        traits::components(result.max)[c] = total.max[c];
+    }
+    result.sum = traits::sum(total.sum);
+    result.mean = traits::mean(total.sum, total.count);
+    result.count = total.count;
+    return result;
+}
+
+template <class T>
+static typename ReduceTraits<T>::sum_type
+fa_sum(const FixedArray<T> &a)
+{
+    return reduceArray<REDUCE_SUM>(a).sum;
+}
+
+template <class T>
+static typename ReduceTraits<T>::mean_type
+fa_mean(const FixedArray<T> &a)
+{
+    if (a.len() == 0)
+        throw IEX_NAMESPACE::ArgExc("Cannot compute the mean of an empty array");
+    return reduceArray<REDUCE_SUM>(a).mean;
+}
+
+template <class T>
+static T fa_min(const FixedArray<T> &a)
+{
+    return reduceArray<REDUCE_MIN>(a).min;
+}
+
+template <class T>
+static T fa_max(const FixedArray<T> &a)
+{
+    return reduceArray<REDUCE_MAX>(a).max;
+}
+
+// (min, max) in one pass, for the types that have no Box binding
+template <class T>
+static py::tuple fa_minmax(const FixedArray<T> &a)
+{
+    ArrayReduction<T> r = reduceArray<REDUCE_MIN|REDUCE_MAX>(a);
+    return py::make_tuple(r.min, r.max);
+}
+
+} // namespace PyImath
+
+#endif // _PyImathFixedArrayReduce_h_
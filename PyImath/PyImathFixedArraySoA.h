@@ -0,0 +1,860 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathFixedArraySoA_h_
+#define _PyImathFixedArraySoA_h_
+
+#include "python_include.h"
+#include <boost/shared_array.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <Iex.h>
+#include <ImathVec.h>
+#include <ImathColor.h>
+#include <ImathQuat.h>
+#include <ImathBox.h>
+#include <PyImathFixedArray.h>
+#include <PyImathTask.h>
+#include <PyImathMathExc.h>
+#include <PyImathOperators.h>
+
+namespace PyImath {
+
+//
+// Structure-of-arrays storage for arrays of small vectors.
+//
+// FixedArraySoA<V> holds each component of V in its own contiguous
+// plane, so that component-wise arithmetic runs over plain arrays of
+// floats or doubles, which the compiler vectorizes.  The planes live in
+// a single allocation, and the component properties return FixedArray
+// views onto them without copying.  Conversion to and from the usual
+// interleaved FixedArray<V> layout goes both ways, and a FixedArraySoA
+// is accepted wherever the interleaved array type is.
+//
+template <class V> struct SoALayout;
+
+template <class T, int N, bool ComponentwiseProduct>
+struct SoALayoutBase
+{
+    typedef T BaseType;
+    static const int components = N;
+
+    // whether V*V and V/V act component by component
+    static const bool componentwiseProduct = ComponentwiseProduct;
+};
+
+template <class V, class T, int N>
+struct SoAIndexedLayout : public SoALayoutBase<T,N,true>
+{
+    static T get(const V &v, int c) { return v[c]; }
+    static void set(V &v, int c, T s) { v[c] = s; }
+};
+
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Vec2<T> > : public SoAIndexedLayout<IMATH_NAMESPACE::Vec2<T>,T,2>
+{
+    static const char *component(int c) { static const char *n[] = {"x","y"}; return n[c]; }
+};
+
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Vec3<T> > : public SoAIndexedLayout<IMATH_NAMESPACE::Vec3<T>,T,3>
+{
+    static const char *component(int c) { static const char *n[] = {"x","y","z"}; return n[c]; }
+};
+
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Vec4<T> > : public SoAIndexedLayout<IMATH_NAMESPACE::Vec4<T>,T,4>
+{
+    static const char *component(int c) { static const char *n[] = {"x","y","z","w"}; return n[c]; }
+};
+
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Color3<T> > : public SoAIndexedLayout<IMATH_NAMESPACE::Color3<T>,T,3>
+{
+    static const char *component(int c) { static const char *n[] = {"r","g","b"}; return n[c]; }
+};
+
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Color4<T> > : public SoAIndexedLayout<IMATH_NAMESPACE::Color4<T>,T,4>
+{
+    static const char *component(int c) { static const char *n[] = {"r","g","b","a"}; return n[c]; }
+};
+
+// the product of two quaternions is not component-wise
+template <class T>
+struct SoALayout<IMATH_NAMESPACE::Quat<T> > : public SoALayoutBase<T,4,false>
+{
+    static const char *component(int c) { static const char *n[] = {"r","x","y","z"}; return n[c]; }
+    static T get(const IMATH_NAMESPACE::Quat<T> &q, int c) { return c == 0 ? q.r : q.v[c-1]; }
+    static void set(IMATH_NAMESPACE::Quat<T> &q, int c, T s) { if (c == 0) q.r = s; else q.v[c-1] = s; }
+};
+
+template <class V>
+class FixedArraySoA
+{
+  public:
+    typedef SoALayout<V>                Layout;
+    typedef typename Layout::BaseType   BaseType;
+    typedef BaseType                    T;
+    static const int N = Layout::components;
+
+  private:
+    size_t                  _length;
+    boost::shared_array<T>  _data;      // N planes of _length elements each
+
+  public:
+    FixedArraySoA(Py_ssize_t length, Uninitialized)
+        : _length(length)
+    {
+        if (length < 0)
+            throw IEX_NAMESPACE::LogicExc("Fixed array length must be non-negative");
+        _data = allocateArray<T>(N*_length);
+    }
+
+    explicit FixedArraySoA(Py_ssize_t length)
+        : _length(length)
+    {
+        if (length < 0)
+            throw IEX_NAMESPACE::LogicExc("Fixed array length must be non-negative");
+        _data = allocateArray<T>(N*_length);
+
+        const V value = FixedArrayDefaultValue<V>::value();
+        for (int c = 0; c < N; ++c)
+            std::fill(plane(c), plane(c) + _length, Layout::get(value,c));
+    }
+
+    explicit FixedArraySoA(const FixedArray<V> &a);
+
+    size_t len() const { return _length; }
+
+    T *       plane(int c)       { return _data.get() + c*_length; }
+    const T * plane(int c) const { return _data.get() + c*_length; }
+
+    V get(size_t i) const
+    {
+        V v;
+        for (int c = 0; c < N; ++c)
+            Layout::set(v, c, plane(c)[i]);
+        return v;
+    }
+
+    void set(size_t i, const V &v)
+    {
+        for (int c = 0; c < N; ++c)
+            plane(c)[i] = Layout::get(v,c);
+    }
+
+    size_t canonical_index(Py_ssize_t index) const
+    {
+        if (index < 0) index += _length;
+        if (index >= Py_ssize_t(_length) || index < 0) {
+            PyErr_SetString(PyExc_IndexError, "Index out of range");
+            throw py::error_already_set();
+        }
+        return index;
+    }
+
+    V getitem(Py_ssize_t index) const { return get(canonical_index(index)); }
+    void setitem(Py_ssize_t index, const V &v) { set(canonical_index(index), v); }
+
+    size_t match_dimension(const FixedArraySoA &other) const
+    {
+        if (_length != other._length)
+            throw IEX_NAMESPACE::ArgExc("Dimensions of source do not match destination");
+        return _length;
+    }
+
+    // a view of one component's plane, sharing this array's storage
+    template <int C>
+    FixedArray<T> component()
+    {
+        return FixedArray<T>(plane(C), _length, 1, boost::any(_data));
+    }
+
+    FixedArray<V> toAoS() const;
+
+    static FixedArraySoA fromAoS(const FixedArray<V> &a) { return FixedArraySoA(a); }
+
+    static const char *name()
+    {
+        static const std::string soaName = std::string(FixedArray<V>::name()) + "SoA";
+        return soaName.c_str();
+    }
+
+    static py::class_<FixedArraySoA<V> > register_(py::module &m, const char *doc)
+    {
+        py::class_<FixedArraySoA<V> > c(m, name(), doc);
+        c
+            .def(py::init<Py_ssize_t>())
+            .def(py::init<const FixedArray<V> &>(), "convert an interleaved array to structure-of-arrays layout")
+            .def("__len__", &FixedArraySoA<V>::len)
+            .def("__getitem__", &FixedArraySoA<V>::getitem)
+            .def("__setitem__", &FixedArraySoA<V>::setitem)
+            .def("toAoS", &FixedArraySoA<V>::toAoS, "convert to an interleaved array")
+            ;
+        return c;
+    }
+};
+
+template <class V>
+struct SoAFromAoSTask : public Task
+{
+    const FixedArray<V> &src;
+    FixedArraySoA<V>    &dst;
+
+    SoAFromAoSTask(const FixedArray<V> &s, FixedArraySoA<V> &d) : src(s), dst(d) {}
+
+    void execute(size_t start, size_t end)
+    {
+        if (src.isMaskedReference())
+            for (size_t i = start; i < end; ++i)
+                dst.set(i, src[i]);
+        else
+            for (size_t i = start; i < end; ++i)
+                dst.set(i, src.direct_index(i));
+    }
+};
+
+template <class V>
+struct SoAToAoSTask : public Task
+{
+    const FixedArraySoA<V> &src;
+    FixedArray<V>          &dst;
+
+    SoAToAoSTask(const FixedArraySoA<V> &s, FixedArray<V> &d) : src(s), dst(d) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            dst.direct_index(i) = src.get(i);
+    }
+};
+
+template <class V>
+FixedArraySoA<V>::FixedArraySoA(const FixedArray<V> &a)
+    : _length(a.len()), _data(allocateArray<T>(N*a.len()))
+{
+    SoAFromAoSTask<V> task(a, *this);
+    dispatchTask(task, _length);
+}
+
+template <class V>
+FixedArray<V>
+FixedArraySoA<V>::toAoS() const
+{
+    FixedArray<V> result(Py_ssize_t(_length), UNINITIALIZED);
+    SoAToAoSTask<V> task(*this, result);
+    dispatchTask(task, _length);
+    return result;
+}
+
+template <class V>
+FixedArray<V> *
+FixedArray_fromSoA(const FixedArraySoA<V> &a)
+{
+    return new FixedArray<V>(a.toAoS());
+}
+
+//
+// The right hand side of a component-wise operation: another array,
+// or a single vector or scalar applied to every element.
+//
+template <class V>
+struct SoAOperand
+{
+    typedef typename FixedArraySoA<V>::T T;
+    static const int N = FixedArraySoA<V>::N;
+
+    const T *planes[N];
+    T        values[N];
+    bool     isArray;
+
+    explicit SoAOperand(const FixedArraySoA<V> &a) : isArray(true)
+    {
+        for (int c = 0; c < N; ++c)
+            planes[c] = a.plane(c);
+    }
+
+    explicit SoAOperand(const V &v) : isArray(false)
+    {
+        for (int c = 0; c < N; ++c)
+            values[c] = SoALayout<V>::get(v,c);
+    }
+
+    explicit SoAOperand(const T &s) : isArray(false)
+    {
+        for (int c = 0; c < N; ++c)
+            values[c] = s;
+    }
+};
+
+template <class Op, class V>
+struct SoABinaryTask : public Task
+{
+    typedef typename FixedArraySoA<V>::T T;
+    static const int N = FixedArraySoA<V>::N;
+
+    FixedArraySoA<V>       &result;
+    const FixedArraySoA<V> &a;
+    const SoAOperand<V>    &b;
+
+    SoABinaryTask(FixedArraySoA<V> &r, const FixedArraySoA<V> &aIn, const SoAOperand<V> &bIn)
+        : result(r), a(aIn), b(bIn) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (int c = 0; c < N; ++c)
+        {
+            T *r = result.plane(c);
+            const T *x = a.plane(c);
+            if (b.isArray)
+            {
+                const T *y = b.planes[c];
+                for (size_t i = start; i < end; ++i)
+                    r[i] = Op::apply(x[i], y[i]);
+            }
+            else
+            {
+                const T y = b.values[c];
+                for (size_t i = start; i < end; ++i)
+                    r[i] = Op::apply(x[i], y);
+            }
+        }
+    }
+};
+
+template <class Op, class V>
+struct soa_binary
+{
+    typedef typename FixedArraySoA<V>::T T;
+
+    static void apply(FixedArraySoA<V> &result, const FixedArraySoA<V> &a, const SoAOperand<V> &b)
+    {
+        MATH_EXC_ON;
+        SoABinaryTask<Op,V> task(result, a, b);
+        dispatchTask(task, a.len());
+        mathexcon.handleOutstandingExceptions();
+    }
+
+    static FixedArraySoA<V> withArray(const FixedArraySoA<V> &a, const FixedArraySoA<V> &b)
+    {
+        FixedArraySoA<V> result(Py_ssize_t(a.match_dimension(b)), UNINITIALIZED);
+        apply(result, a, SoAOperand<V>(b));
+        return result;
+    }
+
+    static FixedArraySoA<V> withValue(const FixedArraySoA<V> &a, const V &b)
+    {
+        FixedArraySoA<V> result(Py_ssize_t(a.len()), UNINITIALIZED);
+        apply(result, a, SoAOperand<V>(b));
+        return result;
+    }
+
+    static FixedArraySoA<V> withScalar(const FixedArraySoA<V> &a, const T &b)
+    {
+        FixedArraySoA<V> result(Py_ssize_t(a.len()), UNINITIALIZED);
+        apply(result, a, SoAOperand<V>(b));
+        return result;
+    }
+
+    static FixedArraySoA<V> &inplaceArray(FixedArraySoA<V> &a, const FixedArraySoA<V> &b)
+    {
+        a.match_dimension(b);
+        apply(a, a, SoAOperand<V>(b));
+        return a;
+    }
+
+    static FixedArraySoA<V> &inplaceValue(FixedArraySoA<V> &a, const V &b)
+    {
+        apply(a, a, SoAOperand<V>(b));
+        return a;
+    }
+
+    static FixedArraySoA<V> &inplaceScalar(FixedArraySoA<V> &a, const T &b)
+    {
+        apply(a, a, SoAOperand<V>(b));
+        return a;
+    }
+};
+
+template <class V>
+static FixedArraySoA<V>
+SoA_neg(const FixedArraySoA<V> &a)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    return soa_binary<op_mul<T>,V>::withScalar(a, T(-1));
+}
+
+template <class V, bool Max>
+static V
+SoA_extreme(const FixedArraySoA<V> &a)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    V tmp;
+    size_t len = a.len();
+    PyReleaseLock pyunlock(worthReleasingLock(len));
+    for (int c = 0; c < FixedArraySoA<V>::N; ++c)
+    {
+        const T *p = a.plane(c);
+        T m = len > 0 ? p[0] : T(0);
+        for (size_t i = 1; i < len; ++i)
+            if (Max ? m < p[i] : p[i] < m)
+                m = p[i];
+        SoALayout<V>::set(tmp, c, m);
+    }
+    return tmp;
+}
+
+template <class V>
+static V
+SoA_min(const FixedArraySoA<V> &a)
+{
+    return SoA_extreme<V,false>(a);
+}
+
+template <class V>
+static V
+SoA_max(const FixedArraySoA<V> &a)
+{
+    return SoA_extreme<V,true>(a);
+}
+
+template <class V>
+static IMATH_NAMESPACE::Box<V>
+SoA_bounds(const FixedArraySoA<V> &a)
+{
+    if (a.len() == 0)
+        return IMATH_NAMESPACE::Box<V>();
+    return IMATH_NAMESPACE::Box<V>(SoA_min(a), SoA_max(a));
+}
+
+//
+// Vector operations over the planes.  The sums are accumulated in the
+// same order as the Imath methods so the results are identical, and
+// lengths small enough for Imath's lengthTiny() path are handed to it.
+//
+template <class V>
+struct SoALengthTask : public Task
+{
+    typedef typename FixedArraySoA<V>::T T;
+    static const int N = FixedArraySoA<V>::N;
+
+    const FixedArraySoA<V> &a;
+    T                      *result;
+    bool                    squared;
+
+    SoALengthTask(const FixedArraySoA<V> &aIn, T *r, bool sq) : a(aIn), result(r), squared(sq) {}
+
+    void execute(size_t start, size_t end)
+    {
+        const T *x = a.plane(0);
+        for (size_t i = start; i < end; ++i)
+            result[i] = x[i]*x[i];
+        for (int c = 1; c < N; ++c)
+        {
+            const T *p = a.plane(c);
+            for (size_t i = start; i < end; ++i)
+                result[i] += p[i]*p[i];
+        }
+        if (squared)
+            return;
+
+        const T tiny = 2 * std::numeric_limits<T>::min();
+        for (size_t i = start; i < end; ++i)
+            result[i] = result[i] < tiny ? a.get(i).length() : std::sqrt(result[i]);
+    }
+};
+
+template <class V>
+struct SoANormalizeTask : public Task
+{
+    typedef typename FixedArraySoA<V>::T T;
+    static const int N = FixedArraySoA<V>::N;
+
+    const FixedArraySoA<V> &a;
+    FixedArraySoA<V>       &result;
+    const T                *lengths;
+
+    SoANormalizeTask(const FixedArraySoA<V> &aIn, FixedArraySoA<V> &r, const T *l)
+        : a(aIn), result(r), lengths(l) {}
+
+    void execute(size_t start, size_t end)
+    {
+        // zero length vectors are left alone; all their components
+        // are zero, so dividing them by one does the same without a
+        // branch in the loop
+        for (int c = 0; c < N; ++c)
+        {
+            const T *p = a.plane(c);
+            T *r = result.plane(c);
+            for (size_t i = start; i < end; ++i)
+                r[i] = p[i] / (lengths[i] != T(0) ? lengths[i] : T(1));
+        }
+    }
+};
+
+template <class V>
+struct SoADotTask : public Task
+{
+    typedef typename FixedArraySoA<V>::T T;
+    static const int N = FixedArraySoA<V>::N;
+
+    const FixedArraySoA<V> &a;
+    const SoAOperand<V>    &b;
+    T                      *result;
+
+    SoADotTask(const FixedArraySoA<V> &aIn, const SoAOperand<V> &bIn, T *r) : a(aIn), b(bIn), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (int c = 0; c < N; ++c)
+        {
+            const T *x = a.plane(c);
+            if (b.isArray)
+            {
+                const T *y = b.planes[c];
+                if (c == 0)
+                    for (size_t i = start; i < end; ++i) result[i] = x[i]*y[i];
+                else
+                    for (size_t i = start; i < end; ++i) result[i] += x[i]*y[i];
+            }
+            else
+            {
+                const T y = b.values[c];
+                if (c == 0)
+                    for (size_t i = start; i < end; ++i) result[i] = x[i]*y;
+                else
+                    for (size_t i = start; i < end; ++i) result[i] += x[i]*y;
+            }
+        }
+    }
+};
+
+template <class V>
+struct SoACrossTask : public Task
+{
+    typedef typename FixedArraySoA<V>::T T;
+
+    const FixedArraySoA<V> &a;
+    const SoAOperand<V>    &b;
+    FixedArraySoA<V>       &result;
+
+    SoACrossTask(const FixedArraySoA<V> &aIn, const SoAOperand<V> &bIn, FixedArraySoA<V> &r)
+        : a(aIn), b(bIn), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        const T *x = a.plane(0), *y = a.plane(1), *z = a.plane(2);
+        T *rx = result.plane(0), *ry = result.plane(1), *rz = result.plane(2);
+        if (b.isArray)
+        {
+            const T *x2 = b.planes[0], *y2 = b.planes[1], *z2 = b.planes[2];
+            for (size_t i = start; i < end; ++i)
+            {
+                rx[i] = y[i]*z2[i] - z[i]*y2[i];
+                ry[i] = z[i]*x2[i] - x[i]*z2[i];
+                rz[i] = x[i]*y2[i] - y[i]*x2[i];
+            }
+        }
+        else
+        {
+            const T x2 = b.values[0], y2 = b.values[1], z2 = b.values[2];
+            for (size_t i = start; i < end; ++i)
+            {
+                rx[i] = y[i]*z2 - z[i]*y2;
+                ry[i] = z[i]*x2 - x[i]*z2;
+                rz[i] = x[i]*y2 - y[i]*x2;
+            }
+        }
+    }
+};
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_lengths(const FixedArraySoA<V> &a, bool squared)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    MATH_EXC_ON;
+    FixedArray<T> result(Py_ssize_t(a.len()), UNINITIALIZED);
+    SoALengthTask<V> task(a, &result.direct_index(0), squared);
+    dispatchTask(task, a.len());
+    mathexcon.handleOutstandingExceptions();
+    return result;
+}
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_length(const FixedArraySoA<V> &a)
+{
+    return SoA_lengths(a, false);
+}
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_length2(const FixedArraySoA<V> &a)
+{
+    return SoA_lengths(a, true);
+}
+
+template <class V>
+static void
+SoA_normalizeInto(const FixedArraySoA<V> &a, FixedArraySoA<V> &result)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    MATH_EXC_ON;
+    FixedArray<T> lengths(Py_ssize_t(a.len()), UNINITIALIZED);
+    SoALengthTask<V> lengthTask(a, &lengths.direct_index(0), false);
+    dispatchTask(lengthTask, a.len());
+    SoANormalizeTask<V> task(a, result, &lengths.direct_index(0));
+    dispatchTask(task, a.len());
+    mathexcon.handleOutstandingExceptions();
+}
+
+template <class V>
+static FixedArraySoA<V>
+SoA_normalized(const FixedArraySoA<V> &a)
+{
+    FixedArraySoA<V> result(Py_ssize_t(a.len()), UNINITIALIZED);
+    SoA_normalizeInto(a, result);
+    return result;
+}
+
+template <class V>
+static FixedArraySoA<V> &
+SoA_normalize(FixedArraySoA<V> &a)
+{
+    SoA_normalizeInto(a, a);
+    return a;
+}
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_dot(const FixedArraySoA<V> &a, const SoAOperand<V> &b)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    MATH_EXC_ON;
+    FixedArray<T> result(Py_ssize_t(a.len()), UNINITIALIZED);
+    SoADotTask<V> task(a, b, &result.direct_index(0));
+    dispatchTask(task, a.len());
+    mathexcon.handleOutstandingExceptions();
+    return result;
+}
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_dotArray(const FixedArraySoA<V> &a, const FixedArraySoA<V> &b)
+{
+    a.match_dimension(b);
+    return SoA_dot(a, SoAOperand<V>(b));
+}
+
+template <class V>
+static FixedArray<typename FixedArraySoA<V>::T>
+SoA_dotValue(const FixedArraySoA<V> &a, const V &b)
+{
+    return SoA_dot(a, SoAOperand<V>(b));
+}
+
+template <class V>
+static FixedArraySoA<V>
+SoA_cross(const FixedArraySoA<V> &a, const SoAOperand<V> &b)
+{
+    MATH_EXC_ON;
+    FixedArraySoA<V> result(Py_ssize_t(a.len()), UNINITIALIZED);
+    SoACrossTask<V> task(a, b, result);
+    dispatchTask(task, a.len());
+    mathexcon.handleOutstandingExceptions();
+    return result;
+}
+
+template <class V>
+static FixedArraySoA<V>
+SoA_crossArray(const FixedArraySoA<V> &a, const FixedArraySoA<V> &b)
+{
+    a.match_dimension(b);
+    return SoA_cross(a, SoAOperand<V>(b));
+}
+
+template <class V>
+static FixedArraySoA<V>
+SoA_crossValue(const FixedArraySoA<V> &a, const V &b)
+{
+    return SoA_cross(a, SoAOperand<V>(b));
+}
+
+template <class V, int C = SoALayout<V>::components - 1>
+struct soa_component_properties
+{
+    static void add(py::class_<FixedArraySoA<V> > &c)
+    {
+        soa_component_properties<V,C-1>::add(c);
+        c.def_property_readonly(SoALayout<V>::component(C), &FixedArraySoA<V>::template component<C>);
+    }
+};
+
+template <class V>
+struct soa_component_properties<V,-1>
+{
+    static void add(py::class_<FixedArraySoA<V> > &c) {}
+};
+
+template <class Op, class V>
+static void
+add_soa_binary(py::class_<FixedArraySoA<V> > &c, const char *name, const char *doc, bool withArrays)
+{
+    if (withArrays)
+        c.def(name, &soa_binary<Op,V>::withArray, doc);
+    c.def(name, &soa_binary<Op,V>::withScalar, doc);
+    if (withArrays)
+        c.def(name, &soa_binary<Op,V>::withValue, doc);
+}
+
+template <class Op, class V>
+static void
+add_soa_inplace(py::class_<FixedArraySoA<V> > &c, const char *name, const char *doc, bool withArrays)
+{
+    if (withArrays)
+        c.def(name, &soa_binary<Op,V>::inplaceArray, doc, py::return_value_policy::reference_internal);
+    c.def(name, &soa_binary<Op,V>::inplaceScalar, doc, py::return_value_policy::reference_internal);
+    if (withArrays)
+        c.def(name, &soa_binary<Op,V>::inplaceValue, doc, py::return_value_policy::reference_internal);
+}
+
+//
+// Registers the structure-of-arrays counterpart of an array class,
+// with its arithmetic and component properties, and the conversions
+// between the two.
+//
+template <class V>
+static py::class_<FixedArraySoA<V> >
+add_soa_functions(py::module &m, py::class_<FixedArray<V> > &c)
+{
+    typedef typename FixedArraySoA<V>::T T;
+    const bool product = SoALayout<V>::componentwiseProduct;
+
+    py::class_<FixedArraySoA<V> > s = FixedArraySoA<V>::register_(m, "Fixed length array stored as one plane per component");
+    soa_component_properties<V>::add(s);
+
+    // sums and differences are component-wise for all the layouts, but
+    // only arrays and vectors can be added, not bare scalars
+    s.def("__add__", &soa_binary<op_add<T>,V>::withArray, "self+x");
+    s.def("__add__", &soa_binary<op_add<T>,V>::withValue, "self+x");
+    s.def("__radd__", &soa_binary<op_add<T>,V>::withValue, "x+self");
+    s.def("__sub__", &soa_binary<op_sub<T>,V>::withArray, "self-x");
+    s.def("__sub__", &soa_binary<op_sub<T>,V>::withValue, "self-x");
+    s.def("__rsub__", &soa_binary<op_rsub<T>,V>::withValue, "x-self");
+    s.def("__iadd__", &soa_binary<op_add<T>,V>::inplaceArray, "self+=x", py::return_value_policy::reference_internal);
+    s.def("__iadd__", &soa_binary<op_add<T>,V>::inplaceValue, "self+=x", py::return_value_policy::reference_internal);
+    s.def("__isub__", &soa_binary<op_sub<T>,V>::inplaceArray, "self-=x", py::return_value_policy::reference_internal);
+    s.def("__isub__", &soa_binary<op_sub<T>,V>::inplaceValue, "self-=x", py::return_value_policy::reference_internal);
+    s.def("__neg__", &SoA_neg<V>, "-x");
+
+    add_soa_binary<op_mul<T>,V>(s, "__mul__", "self*x", product);
+    add_soa_binary<op_mul<T>,V>(s, "__rmul__", "x*self", product);
+    add_soa_binary<op_div<T>,V>(s, "__div__", "self/x", product);
+    add_soa_binary<op_div<T>,V>(s, "__truediv__", "self/x", product);
+    add_soa_inplace<op_mul<T>,V>(s, "__imul__", "self*=x", product);
+    add_soa_inplace<op_div<T>,V>(s, "__idiv__", "self/=x", product);
+    add_soa_inplace<op_div<T>,V>(s, "__itruediv__", "self/=x", product);
+
+    s.def("min", &SoA_min<V>);
+    s.def("max", &SoA_max<V>);
+
+    c.def("toSoA", &FixedArraySoA<V>::fromAoS, "convert to structure-of-arrays layout");
+    c.def(py::init(&FixedArray_fromSoA<V>));
+    py::implicitly_convertible<FixedArraySoA<V>, FixedArray<V> >();
+
+    return s;
+}
+
+// lengths and normals only make sense for floating point vectors
+template <class V, bool Float = std::is_floating_point<typename FixedArraySoA<V>::T>::value>
+struct soa_vec_functions
+{
+    static void add(py::class_<FixedArraySoA<V> > &s) {}
+    static void add3(py::class_<FixedArraySoA<V> > &s) {}
+};
+
+template <class V>
+struct soa_vec_functions<V,true>
+{
+    static void add(py::class_<FixedArraySoA<V> > &s)
+    {
+        s
+            .def("length", &SoA_length<V>)
+            .def("length2", &SoA_length2<V>)
+            .def("normalize", &SoA_normalize<V>, py::return_value_policy::reference_internal)
+            .def("normalized", &SoA_normalized<V>)
+            .def("dot", &SoA_dotArray<V>, "return the inner product of (self,x)")
+            .def("dot", &SoA_dotValue<V>, "return the inner product of (self,x)")
+            ;
+    }
+
+    static void add3(py::class_<FixedArraySoA<V> > &s)
+    {
+        s
+            .def("cross", &SoA_crossArray<V>, "return the cross product of (self,x)")
+            .def("cross", &SoA_crossValue<V>, "return the cross product of (self,x)")
+            ;
+    }
+};
+
+template <class V>
+static void
+add_soa_vec_functions(py::class_<FixedArraySoA<V> > &s)
+{
+    soa_vec_functions<V>::add(s);
+}
+
+template <class V>
+static void
+add_soa_vec3_functions(py::class_<FixedArraySoA<V> > &s)
+{
+    soa_vec_functions<V>::add3(s);
+}
+
+template <class V>
+static void
+add_soa_bounds_functions(py::class_<FixedArraySoA<V> > &s)
+{
+    s.def("bounds", &SoA_bounds<V>);
+}
+
+} // namespace PyImath
+
+#endif // _PyImathFixedArraySoA_h_
@@ -65,7 +65,7 @@ class FixedMatrix
     }
 
     FixedMatrix(int rows, int cols)
-        : _ptr(new T[rows*cols]), _rows(rows), _cols(cols),
+        : _ptr(newArrayElements<T>(rows*cols)), _rows(rows), _cols(cols),
           _rowStride(1), _colStride(1), _refcount(new int(1))
     {
         // nothing
@@ -101,7 +101,7 @@ class FixedMatrix
         if (_refcount) {
             *_refcount -= 1;
             if (*_refcount == 0) {
-                delete [] _ptr;
+                deleteArrayElements(_ptr, size_t(_rows)*_cols);
                 delete _refcount;
             }
         }
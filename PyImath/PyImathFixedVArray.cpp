@@ -38,32 +38,81 @@
 #include <boost/any.hpp>
 #include <Iex.h>
 #include <PyImathExport.h>
+#include <PyImathAllocator.h>
+#include <PyImathTask.h>
+#include <ImathVec.h>
+#include <algorithm>
+#include <limits>
 
 namespace PyImath {
 
 template <class T>
-FixedVArray<T>::FixedVArray (std::vector<T>* ptr, Py_ssize_t length,
-                             Py_ssize_t stride)
-    : _ptr(ptr), _length(length), _stride(stride),
-      _handle(), _unmaskedLength(0)
+struct FixedVArray_CopyItems : public Task
 {
-    if (length < 0)
+    const std::vector<const T*> &data;
+    const int *offsets;
+    T *values;
+
+    FixedVArray_CopyItems (const std::vector<const T*> &d, const int *o, T *v)
+        : data(d), offsets(o), values(v) {}
+
+    size_t elementCost() const { return 8; }
+
+    void execute (size_t start, size_t end)
     {
-        throw IEX_NAMESPACE::ArgExc("Fixed array length must be non-negative");
+        for (size_t i = start; i < end; ++i)
+        {
+            std::copy (data[i], data[i] + (offsets[i+1] - offsets[i]), values + offsets[i]);
+        }
     }
-    if (stride <= 0)
+};
+
+// static
+template <class T>
+boost::shared_ptr<typename FixedVArray<T>::Storage>
+FixedVArray<T>::layout (const std::vector<const T*>& data,
+                        const std::vector<size_t>& counts)
+{
+    size_t numItems = counts.size();
+
+    boost::shared_ptr<Storage> storage(new Storage);
+    storage->numItems = numItems;
+    storage->offsets = allocateArray<int>(numItems + 1);
+
+    size_t numValues = 0;
+    for (size_t i = 0; i < numItems; ++i)
     {
-        throw IEX_NAMESPACE::ArgExc("Fixed array stride must be positive");
+        storage->offsets[i] = int(numValues);
+        numValues += counts[i];
+        if (numValues > size_t(std::numeric_limits<int>::max()))
+        {
+            throw IEX_NAMESPACE::ArgExc("Too many elements for a variable array");
+        }
+    }
+    storage->offsets[numItems] = int(numValues);
+
+    storage->values = allocateArray<T>(numValues);
+
+    if (!data.empty())
+    {
+        FixedVArray_CopyItems<T> task(data, storage->offsets.get(), storage->values.get());
+        dispatchTask (task, numItems);
     }
 
-    // Nothing else to do (pointer given, so we have the data)
+    return storage;
+}
+
+template <class T>
+FixedVArray<T>::FixedVArray (const boost::shared_ptr<Storage>& storage)
+    : _storage(storage), _length(storage->numItems), _unmaskedLength(0)
+{
+    // Nothing.
 }
 
 template <class T>
-FixedVArray<T>::FixedVArray (std::vector<T>* ptr, Py_ssize_t length,
-                             Py_ssize_t stride, boost::any handle)
-    : _ptr(ptr), _length(length), _stride(stride),
-      _handle(handle), _unmaskedLength(0)
+FixedVArray<T>::FixedVArray (const std::vector<T>* ptr, Py_ssize_t length,
+                             Py_ssize_t stride)
+    : _length(length), _unmaskedLength(0)
 {
     if (length < 0)
     {
@@ -74,59 +123,101 @@ FixedVArray<T>::FixedVArray (std::vector<T>* ptr, Py_ssize_t length,
         throw IEX_NAMESPACE::ArgExc("Fixed array stride must be positive");
     }
 
-    // Nothing else to do (pointer given, so we have the data)
+    std::vector<const T*> data(length);
+    std::vector<size_t>   counts(length);
+    for (size_t i = 0; i < size_t(length); ++i)
+    {
+        const std::vector<T>& v = ptr[i*stride];
+        data[i]   = v.empty() ? 0 : &v[0];
+        counts[i] = v.size();
+    }
+    _storage = layout (data, counts);
 }
 
 template <class T>
 FixedVArray<T>::FixedVArray(Py_ssize_t length)
-    : _ptr(0), _length(length), _stride(1), _handle(), _unmaskedLength(0)
+    : _length(length), _unmaskedLength(0)
 {
     if (length < 0)
     {
         throw IEX_NAMESPACE::ArgExc("Fixed array length must be non-negative");
     }
 
-    boost::shared_array<std::vector<T> > a(new std::vector<T>[length]);
- // Initial vectors in the array will be zero-length.
-    _handle = a;
-    _ptr = a.get();
+ // Initial items in the array will be zero-length.
+    _storage = layout (std::vector<const T*>(length, (const T*) 0),
+                       std::vector<size_t>(length, 0));
 }
 
 // template <class T>
 // FixedVArray<T>::FixedVArray(Py_ssize_t length, Uninitialized)
-//     : _ptr(0), _length(length), _stride(1), _handle(), _unmaskedLength(0)
 // {
-//     if (length < 0)
-//     {
-//         throw IEX_NAMESPACE::ArgExc("Fixed array length must be non-negative");
-//     }
-// 
-//     boost::shared_array<std::vector<T> > a(new std::vector<T>[length]);
-//     _handle = a;
-//     _ptr = a.get();
 // }
 
 template <class T>
 FixedVArray<T>::FixedVArray(const T& initialValue, Py_ssize_t length)
-    : _ptr(0), _length(length), _stride(1), _handle(), _unmaskedLength(0)
+    : _length(length), _unmaskedLength(0)
 {
     if (length < 0)
     {
         throw IEX_NAMESPACE::ArgExc("Fixed array length must be non-negative");
     }
 
-    boost::shared_array<std::vector<T> > a(new std::vector<T>[length]);
-    for (size_t i = 0; i < length; ++i)
+    _storage = layout (std::vector<const T*>(length, &initialValue),
+                       std::vector<size_t>(length, 1));
+}
+
+template <class T>
+FixedVArray<T>::FixedVArray(const FixedArray<int>& counts, const FixedArray<T>& values)
+    : _length(counts.len()), _unmaskedLength(0)
+{
+    // the items point into a contiguous copy of values
+    std::vector<T> flat(values.len());
+    for (size_t i = 0; i < flat.size(); ++i)
+    {
+        flat[i] = values[i];
+    }
+
+    std::vector<const T*> data(_length);
+    std::vector<size_t>   itemCounts(_length);
+    size_t offset = 0;
+    for (size_t i = 0; i < _length; ++i)
+    {
+        if (counts[i] < 0)
+        {
+            throw IEX_NAMESPACE::ArgExc("Variable array counts must be non-negative");
+        }
+        itemCounts[i] = counts[i];
+        data[i] = flat.empty() ? 0 : &flat[0] + std::min(offset, flat.size());
+        offset += counts[i];
+    }
+    if (offset != flat.size())
+    {
+        throw IEX_NAMESPACE::ArgExc("Variable array counts do not match the number of values");
+    }
+
+    _storage = layout (data, itemCounts);
+}
+
+template <class T>
+FixedVArray<T>::FixedVArray(const FixedArray<int>& counts, Uninitialized)
+    : _length(counts.len()), _unmaskedLength(0)
+{
+    std::vector<size_t> itemCounts(_length);
+    for (size_t i = 0; i < _length; ++i)
     {
-        a[i].push_back (initialValue);
+        if (counts[i] < 0)
+        {
+            throw IEX_NAMESPACE::ArgExc("Variable array counts must be non-negative");
+        }
+        itemCounts[i] = counts[i];
     }
-    _handle = a;
-    _ptr = a.get();
+
+    _storage = layout (std::vector<const T*>(), itemCounts);
 }
 
 template <class T>
 FixedVArray<T>::FixedVArray(FixedVArray<T>& other, const FixedArray<int>& mask)
-    : _ptr(other._ptr), _stride(other._stride), _handle(other._handle)
+    : _storage(other._storage)
 {
     if (other.isMaskedReference())
     {
@@ -167,9 +258,8 @@ FixedVArray<T>::FixedVArray(FixedVArray<T>& other, const FixedArray<int>& mask)
 
 template <class T>
 FixedVArray<T>::FixedVArray(const FixedVArray<T>& other)
-    : _ptr(other._ptr), _length(other._length), _stride(other._stride),
-      _handle(other._handle), _indices(other._indices),
-      _unmaskedLength(other._unmaskedLength)
+    : _storage(other._storage), _length(other._length),
+      _indices(other._indices), _unmaskedLength(other._unmaskedLength)
 {
     // Nothing.
 }
@@ -181,10 +271,8 @@ FixedVArray<T>::operator = (const FixedVArray<T>& other)  // AAJ (WHY SHALLOW CO
     if (&other == this)
         return *this;
 
-    _ptr            = other._ptr;
+    _storage        = other._storage;
     _length         = other._length;
-    _stride         = other._stride;
-    _handle         = other._handle;
     _unmaskedLength = other._unmaskedLength;
     _indices        = other._indices;
 
@@ -192,24 +280,95 @@ FixedVArray<T>::operator = (const FixedVArray<T>& other)  // AAJ (WHY SHALLOW CO
 }
 
 template <class T>
-FixedVArray<T>::~FixedVArray()  // AAJ (NOT DELETED BECAUSE SHARED ARRAY THAT HANDLE HAS?)
+FixedVArray<T>::~FixedVArray()
 {
-    // Nothing.
+    // Nothing; the storage is shared.
+}
+
+
+template <class T>
+size_t
+FixedVArray<T>::itemLength (size_t i) const
+{
+    const int* offsets = _storage->offsets.get();
+    size_t u = storageIndex(i);
+    return offsets[u+1] - offsets[u];
 }
 
+template <class T>
+T *
+FixedVArray<T>::item (size_t i)
+{
+    return _storage->values.get() + _storage->offsets[storageIndex(i)];
+}
 
 template <class T>
-std::vector<T>&
-FixedVArray<T>::operator [] (size_t i)
+const T *
+FixedVArray<T>::item (size_t i) const
 {
-    return _ptr[(_indices ? raw_ptr_index(i) : i) * _stride];
+    return _storage->values.get() + _storage->offsets[storageIndex(i)];
 }
 
 template <class T>
-const std::vector<T>&
-FixedVArray<T>::operator [] (size_t i) const
+void
+FixedVArray<T>::assignItems (const std::vector<size_t>& targets,
+                             const FixedVArray<T>& data,
+                             const std::vector<size_t>& sources)
 {
-    return _ptr[(_indices ? raw_ptr_index(i) : i) * _stride];
+    if (data._storage == _storage)
+    {
+        // copy the source items first so they can't be overwritten
+        std::vector<const T*> d(sources.size());
+        std::vector<size_t>   c(sources.size());
+        std::vector<size_t>   s(sources.size());
+        for (size_t k = 0; k < sources.size(); ++k)
+        {
+            d[k] = data.item(sources[k]);
+            c[k] = data.itemLength(sources[k]);
+            s[k] = k;
+        }
+        assignItems (targets, FixedVArray<T>(layout (d, c)), s);
+        return;
+    }
+
+    Storage& storage = *_storage;
+    const int* offsets = storage.offsets.get();
+
+    bool sameLengths = true;
+    for (size_t k = 0; k < targets.size() && sameLengths; ++k)
+    {
+        size_t u = targets[k];
+        sameLengths = size_t(offsets[u+1] - offsets[u]) == data.itemLength(sources[k]);
+    }
+
+    if (sameLengths)
+    {
+        for (size_t k = 0; k < targets.size(); ++k)
+        {
+            const T* src = data.item(sources[k]);
+            std::copy (src, src + data.itemLength(sources[k]),
+                       storage.values.get() + offsets[targets[k]]);
+        }
+        return;
+    }
+
+    std::vector<const T*> d(storage.numItems);
+    std::vector<size_t>   c(storage.numItems);
+    for (size_t u = 0; u < storage.numItems; ++u)
+    {
+        d[u] = storage.values.get() + offsets[u];
+        c[u] = offsets[u+1] - offsets[u];
+    }
+    for (size_t k = 0; k < targets.size(); ++k)
+    {
+        d[targets[k]] = data.item(sources[k]);
+        c[targets[k]] = data.itemLength(sources[k]);
+    }
+
+    // replace the contents of the shared storage so that masked
+    // references and copies see the new items
+    boost::shared_ptr<Storage> rebuilt = layout (d, c);
+    storage = *rebuilt;
 }
 
 
@@ -301,24 +460,15 @@ FixedVArray<T>::getslice (PyObject* index) const
     Py_ssize_t step;
     extract_slice_indices (index, start, end, step, sliceLength, _length);
 
-    FixedVArray<T> f(sliceLength);
-
-    if (_indices)
-    {
-        for (size_t i = 0; i < sliceLength; ++i)
-        {
-            f._ptr[i] = _ptr[raw_ptr_index(start + i*step)*_stride];
-        }
-    }
-    else
+    std::vector<const T*> data(sliceLength);
+    std::vector<size_t>   counts(sliceLength);
+    for (size_t i = 0; i < sliceLength; ++i)
     {
-        for (size_t i = 0; i < sliceLength; ++i)
-        {
-            f._ptr[i] = _ptr[(start + i*step)*_stride];
-        }
+        data[i]   = item(start + i*step);
+        counts[i] = itemLength(start + i*step);
     }
 
-    return f;
+    return FixedVArray<T>(layout (data, counts));
 }
 
 template <class T>
@@ -398,20 +548,15 @@ FixedVArray<T>::setitem_vector (PyObject* index, const FixedVArray<T>& data)
         throw py::error_already_set();
     }
 
-    if (_indices)
-    {
-        for (size_t i = 0; i < sliceLength; ++i)
-        {
-            _ptr[raw_ptr_index(start + i*step)*_stride] = data[i];
-        }
-    }
-    else
+    std::vector<size_t> targets(sliceLength);
+    std::vector<size_t> sources(sliceLength);
+    for (size_t i = 0; i < sliceLength; ++i)
     {
-        for (size_t i = 0; i < sliceLength; ++i)
-        {
-            _ptr[(start + i*step)*_stride] = data[i];
-        }
+        targets[i] = storageIndex(start + i*step);
+        sources[i] = i;
     }
+
+    assignItems (targets, data, sources);
 }
 
 template <class T>
@@ -428,13 +573,17 @@ FixedVArray<T>::setitem_vector_mask (const FixedArray<int>& mask,
 
     size_t len = match_dimension(mask);
 
+    std::vector<size_t> targets;
+    std::vector<size_t> sources;
+
     if (data.len() == len)
     {
         for (size_t i = 0; i < len; ++i)
         {
             if (mask[i])
             {
-                _ptr[i*_stride] = data[i];
+                targets.push_back (i);
+                sources.push_back (i);
             }
         }
     }
@@ -455,16 +604,19 @@ FixedVArray<T>::setitem_vector_mask (const FixedArray<int>& mask,
                  "either masked or unmasked");
         }
 
-        Py_ssize_t dataIndex = 0;
+        size_t dataIndex = 0;
         for (size_t i = 0; i < len; ++i)
         {
             if (mask[i])
             {
-                _ptr[i*_stride] = data[dataIndex];
+                targets.push_back (i);
+                sources.push_back (dataIndex);
                 dataIndex++;
             }
         }
     }
+
+    assignItems (targets, data, sources);
 }
 
 // template <class T>
@@ -490,13 +642,58 @@ FixedVArray<T>::ifelse_vector(const FixedArray<int>& choice,
     size_t len = match_dimension (choice);
     match_dimension (other);
 
-    FixedVArray<T> tmp(len);
+    std::vector<const T*> data(len);
+    std::vector<size_t>   counts(len);
     for (size_t i = 0; i < len; ++i)
     {
-        tmp[i] = choice[i] ? (*this)[i] : other[i];
+        const FixedVArray<T>& src = choice[i] ? *this : other;
+        data[i]   = src.item(i);
+        counts[i] = src.itemLength(i);
+    }
+
+    return FixedVArray<T>(layout (data, counts));
+}
+
+template <class T>
+FixedArray<T>
+FixedVArray<T>::values () const
+{
+    if (_indices)
+    {
+        throw IEX_NAMESPACE::ArgExc("Masked variable arrays have no flat view of their values");
+    }
+
+    return FixedArray<T>(_storage->values.get(), _storage->offsets[_storage->numItems],
+                         1, boost::any(_storage->values));
+}
+
+template <class T>
+FixedArray<int>
+FixedVArray<T>::offsets () const
+{
+    if (_indices)
+    {
+        throw IEX_NAMESPACE::ArgExc("Masked variable arrays have no flat view of their offsets");
+    }
+
+    const size_t n = _storage->numItems + 1;
+    FixedArray<int> result(n, UNINITIALIZED);
+    std::copy (_storage->offsets.get(), _storage->offsets.get() + n, &result.direct_index(0));
+
+    return result;
+}
+
+template <class T>
+FixedArray<int>
+FixedVArray<T>::counts () const
+{
+    FixedArray<int> result(_length, UNINITIALIZED);
+    for (size_t i = 0; i < _length; ++i)
+    {
+        result.direct_index(i) = int(itemLength(i));
     }
 
-    return tmp;
+    return result;
 }
 
 template <class T>
@@ -539,12 +736,20 @@ FixedVArray<T>::register_(py::module &m, const char* doc)
                 "specified length initialized to the default value for the given type")*/))
      .def(py::init<const FixedVArray<T> &>(/*"Construct a variable array with the same values as the given array"*/))
      .def(py::init<const T &, Py_ssize_t>(/*"Construct a variable array of the specified length initialized to the specified default value"*/))
+     .def(py::init<const FixedArray<int> &, const FixedArray<T> &>(),
+          "Construct a variable array from the element count of each item and the elements of all items in order")
      .def("__getitem__", &FixedVArray<T>::getslice)
      .def("__getitem__", &FixedVArray<T>::getslice_mask)
      .def("__setitem__", &FixedVArray<T>::setitem_vector)
      .def("__setitem__", &FixedVArray<T>::setitem_vector_mask)
      .def("__len__",     &FixedVArray<T>::len)
      .def("ifelse",      &FixedVArray<T>::ifelse_vector)
+     .def("values",      &FixedVArray<T>::values,
+          "values() -- the elements of all items in order, as a view that shares the array's storage")
+     .def("offsets",     &FixedVArray<T>::offsets,
+          "offsets() -- a copy of where each item starts in values(), followed by the total")
+     .def("counts",      &FixedVArray<T>::counts,
+          "counts() -- the number of elements of each item")
      ;
 
   // .def("__setitem__", &FixedVArray<T>::setitem_scalar)
@@ -560,5 +765,8 @@ FixedVArray<T>::register_(py::module &m, const char* doc)
 // ---- Explicit Class Instantiation ---------------------------------
 
 template class PYIMATH_EXPORT FixedVArray<int>;
+template class PYIMATH_EXPORT FixedVArray<float>;
+template class PYIMATH_EXPORT FixedVArray<IMATH_NAMESPACE::V2f>;
+template class PYIMATH_EXPORT FixedVArray<IMATH_NAMESPACE::V3f>;
 
 } // namespace PyImath
@@ -36,7 +36,8 @@
 #define _PyImathFixedVArray_h_
 
 #include "python_include.h"
-#include <boost/any.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/shared_ptr.hpp>
 #include <vector>
 #include <PyImathFixedArray.h>
 
@@ -45,19 +46,26 @@ namespace PyImath {
 template <class T>
 class FixedVArray
 {
-    // This class (at least for now) holds a std::vector of 'T' types.
-    // This will give us the 'variable' part of the array.  Generally,
-    // we will initially support only a very small subset of accessor
-    // methods before the semantics are fully defined.  Currently, the
-    // VArray semantics are defined in the 'varraySemantics.txt' file.
-
-    std::vector<T> *  _ptr;
-    size_t            _length;
-    size_t            _stride;
+    // The items are stored in compressed sparse row form: the elements
+    // of all items sit back to back in one flat buffer, and item i is
+    // the run [offsets[i], offsets[i+1]) of that buffer.  The storage is
+    // shared by copies and masked references of the array, so an
+    // assignment that changes item lengths rebuilds the buffers in place
+    // and every array sharing them sees the result.  Views returned by
+    // values() keep the buffer they were made from.
+    //
+    // Currently, the VArray semantics are defined in the
+    // 'varraySemantics.txt' file.
+
+    struct Storage
+    {
+        boost::shared_array<T>    values;
+        boost::shared_array<int>  offsets;  // numItems + 1 entries
+        size_t                    numItems;
+    };
 
-    // This handle optionally stores a shared_array to allocated array data
-    // so that everything is freed properly on exit.
-    boost::any        _handle;
+    boost::shared_ptr<Storage>   _storage;
+    size_t                       _length;
 
     boost::shared_array<size_t>  _indices;  // non-NULL if we're a masked reference
     size_t                       _unmaskedLength;
@@ -65,12 +73,10 @@ class FixedVArray
   public:
     typedef T  BaseType;
 
-    FixedVArray (std::vector<T>* ptr, Py_ssize_t length,
+    // Copies length items from ptr, stride items apart.
+    FixedVArray (const std::vector<T>* ptr, Py_ssize_t length,
                  Py_ssize_t stride = 1);
 
-    FixedVArray (std::vector<T>* ptr, Py_ssize_t length,
-                 Py_ssize_t stride, boost::any handle);
-
     explicit FixedVArray (Py_ssize_t length);
 
  // Not needed.  vector-lengths are zero (uninitialized) by default.
@@ -78,6 +84,13 @@ class FixedVArray
 
     FixedVArray (const T& initialValue, Py_ssize_t length);
 
+    // One item per entry of counts, holding the next counts[i] elements
+    // of values.
+    FixedVArray (const FixedArray<int>& counts, const FixedArray<T>& values);
+
+    // One item per entry of counts, with uninitialized elements.
+    FixedVArray (const FixedArray<int>& counts, Uninitialized);
+
     FixedVArray (FixedVArray<T>& f, const FixedArray<int>& mask);
 
  // template <class S>
@@ -91,16 +104,15 @@ class FixedVArray
 
     // ----------------
 
-    const boost::any&  handle() { return _handle; }
-
     Py_ssize_t  len()    const { return _length; }
-    size_t      stride() const { return _stride; }
 
     bool        isMaskedReference() const { return _indices.get() != 0; }
     size_t      unmaskedLength()    const { return _unmaskedLength; }
 
-    std::vector<T>&        operator [] (size_t i);
-    const std::vector<T>&  operator [] (size_t i) const;
+    // The elements of item i.
+    size_t      itemLength (size_t i) const;
+    T *         item (size_t i);
+    const T *   item (size_t i) const;
 
     // ----------------
 
@@ -125,6 +137,18 @@ class FixedVArray
 
     // ----------------
 
+    // A view of the flat element buffer, without copying, and a copy
+    // of the item offsets.  Writes to the values view change the
+    // elements of the array.  Neither is available for masked
+    // references.
+    FixedArray<T>    values () const;
+    FixedArray<int>  offsets () const;
+
+    // The number of elements of each item.
+    FixedArray<int>  counts () const;
+
+    // ----------------
+
     static py::class_<FixedVArray<T> > register_(py::module &m, const char* doc);
 
     // Instantiations of fixed variable arrays must implement this static member.
@@ -200,6 +224,21 @@ class FixedVArray
   protected:
     size_t  raw_ptr_index (size_t i) const;
 
+    size_t  storageIndex (size_t i) const { return _indices ? raw_ptr_index(i) : i; }
+
+    explicit FixedVArray (const boost::shared_ptr<Storage>& storage);
+
+    // Fresh storage with one item per entry of counts, counts[i] elements
+    // long and copied from data[i] (left uninitialized if data is empty).
+    static boost::shared_ptr<Storage>  layout (const std::vector<const T*>& data,
+                                               const std::vector<size_t>& counts);
+
+    // Give storage item targets[k] the elements of item sources[k] of
+    // data, rebuilding the storage if any item changes length.
+    void    assignItems (const std::vector<size_t>& targets,
+                         const FixedVArray<T>& data,
+                         const std::vector<size_t>& sources);
+
 };
 
 } // namespace PyImath
@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathFixedVArrayOps_h_
+#define _PyImathFixedVArrayOps_h_
+
+#include "python_include.h"
+#include <algorithm>
+#include <vector>
+#include <Iex.h>
+#include <PyImathFixedArray.h>
+#include <PyImathFixedVArray.h>
+#include <PyImathFixedArrayReduce.h>
+#include <PyImathTask.h>
+#include <PyImathMathExc.h>
+
+namespace PyImath {
+
+//
+// Segmented operations over variable length arrays.
+//
+// The reductions collapse each item to one element, in parallel over the
+// items; an empty item reduces to zero.  Sums and means are accumulated
+// as ReduceTraits<T>::accumulate_type and returned as its mean_type, so
+// the sum of an integer item is a double, as there is no array of 64 bit
+// integers to hold it.  gather and scatterAdd treat a
+// VIntArray as ragged indices into a flat array, as a mesh's face vertex
+// indices index its points: gather reads the indexed elements into an
+// array with the same item lengths, and scatterAdd sums item (or item
+// element) values into the indexed elements of a new flat array.
+//
+// scatterAdd first transposes the indices into a per-output list of
+// contributions, in item order, and then sums the outputs in parallel, so
+// the result does not depend on the number of threads.
+//
+
+namespace detail {
+
+// min or max of each item
+template <class T, int Ops>
+struct VArrayReduceTask : public Task
+{
+    typedef ReduceTraits<T> traits;
+    typedef typename traits::base_type base_type;
+
+    const FixedVArray<T> &  array;
+    FixedArray<T> &         result;
+
+    VArrayReduceTask(const FixedVArray<T> &a, FixedArray<T> &r)
+        : array(a), result(r) {}
+
+    size_t elementCost() const { return 4 * traits::dimensions; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            const size_t n = array.itemLength(i);
+            const T *v = array.item(i);
+            T r = n > 0 ? v[0] : traits::zero();
+            base_type *rc = traits::components(r);
+            for (size_t k = 1; k < n; ++k)
+            {
+                const base_type *vc = traits::components(v[k]);
+                for (int c = 0; c < traits::dimensions; ++c)
+                {
+                    if (Ops == REDUCE_MIN) rc[c] = vc[c] < rc[c] ? vc[c] : rc[c];
+                    if (Ops == REDUCE_MAX) rc[c] = vc[c] > rc[c] ? vc[c] : rc[c];
+                }
+            }
+            result.direct_index(i) = r;
+        }
+    }
+};
+
+// sum or mean of each item
+template <class T, bool Mean>
+struct VArraySumTask : public Task
+{
+    typedef ReduceTraits<T> traits;
+    typedef typename traits::mean_type mean_type;
+
+    const FixedVArray<T> &      array;
+    FixedArray<mean_type> &     result;
+
+    VArraySumTask(const FixedVArray<T> &a, FixedArray<mean_type> &r)
+        : array(a), result(r) {}
+
+    size_t elementCost() const { return 4 * traits::dimensions; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            const size_t n = array.itemLength(i);
+            const T *v = array.item(i);
+            if (n == 0)
+            {
+                result.direct_index(i) = ReduceTraits<mean_type>::zero();
+                continue;
+            }
+            typename traits::accumulate_type sum[traits::dimensions] = {};
+            for (size_t k = 0; k < n; ++k)
+            {
+                const typename traits::base_type *vc = traits::components(v[k]);
+                for (int c = 0; c < traits::dimensions; ++c)
+                    sum[c] += vc[c];
+            }
+            result.direct_index(i) = Mean ? traits::mean(sum, n) : mean_type(traits::sum(sum));
+        }
+    }
+};
+
+template <class T>
+struct VArrayGatherTask : public Task
+{
+    const FixedVArray<int> &    indices;
+    const FixedArray<T> &       values;
+    FixedVArray<T> &            result;
+
+    VArrayGatherTask(const FixedVArray<int> &i, const FixedArray<T> &v, FixedVArray<T> &r)
+        : indices(i), values(v), result(r) {}
+
+    size_t elementCost() const { return 8; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            const size_t n = indices.itemLength(i);
+            const int *idx = indices.item(i);
+            T *dst = result.item(i);
+            for (size_t k = 0; k < n; ++k)
+                dst[k] = values[idx[k]];
+        }
+    }
+};
+
+template <class T>
+struct VArrayScatterAddTask : public Task
+{
+    const std::vector<size_t> &     offsets;
+    const std::vector<const T *> &  sources;
+    FixedArray<T> &                 result;
+
+    VArrayScatterAddTask(const std::vector<size_t> &o, const std::vector<const T *> &s, FixedArray<T> &r)
+        : offsets(o), sources(s), result(r) {}
+
+    size_t elementCost() const { return 8; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t j = start; j < end; ++j)
+        {
+            T sum = ReduceTraits<T>::zero();
+            for (size_t s = offsets[j]; s < offsets[j+1]; ++s)
+                sum += *sources[s];
+            result.direct_index(j) = sum;
+        }
+    }
+};
+
+// Throw unless every element of indices is in [0, n).
+inline void
+checkVArrayIndices(const FixedVArray<int> &indices, size_t n)
+{
+    int lo = 0, hi = -1;
+    if (!indices.isMaskedReference())
+    {
+        ArrayReduction<int> r = reduceArray<REDUCE_MIN|REDUCE_MAX>(indices.values());
+        if (r.count == 0)
+            return;
+        lo = r.min;
+        hi = r.max;
+    }
+    else
+    {
+        for (size_t i = 0; i < size_t(indices.len()); ++i)
+        {
+            const int *idx = indices.item(i);
+            for (size_t k = 0; k < indices.itemLength(i); ++k)
+            {
+                if (hi < lo) { lo = hi = idx[k]; continue; }
+                lo = std::min(lo, idx[k]);
+                hi = std::max(hi, idx[k]);
+            }
+        }
+        if (hi < lo)
+            return;
+    }
+    if (lo < 0 || size_t(hi) >= n)
+        throw IEX_NAMESPACE::ArgExc("Variable array index out of range");
+}
+
+// An array of length n whose element j sums *source(i,k) over the item
+// elements with indices.item(i)[k] == j.
+template <class T, class Source>
+FixedArray<T>
+scatterAddVArray(const FixedVArray<int> &indices, size_t n, Source source)
+{
+    checkVArrayIndices(indices, n);
+
+    const size_t len = indices.len();
+    std::vector<size_t> offsets(n + 1, 0);
+    for (size_t i = 0; i < len; ++i)
+    {
+        const int *idx = indices.item(i);
+        for (size_t k = 0, e = indices.itemLength(i); k < e; ++k)
+            ++offsets[idx[k] + 1];
+    }
+    for (size_t j = 0; j < n; ++j)
+        offsets[j+1] += offsets[j];
+
+    std::vector<const T *> sources(offsets[n]);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < len; ++i)
+    {
+        const int *idx = indices.item(i);
+        for (size_t k = 0, e = indices.itemLength(i); k < e; ++k)
+            sources[next[idx[k]]++] = source(i, k);
+    }
+
+    FixedArray<T> result(n, UNINITIALIZED);
+    VArrayScatterAddTask<T> task(offsets, sources, result);
+    dispatchTask(task, n);
+    return result;
+}
+
+template <class T>
+struct ItemSource
+{
+    const FixedArray<T> &values;
+    const T *operator () (size_t i, size_t) const { return &values[i]; }
+};
+
+template <class T>
+struct ItemElementSource
+{
+    const FixedVArray<T> &values;
+    const T *operator () (size_t i, size_t k) const { return values.item(i) + k; }
+};
+
+} // namespace detail
+
+template <class T, int Ops>
+static FixedArray<T>
+va_reduce(const FixedVArray<T> &a)
+{
+    MATH_EXC_ON;
+    FixedArray<T> result(a.len(), UNINITIALIZED);
+    detail::VArrayReduceTask<T,Ops> task(a, result);
+    dispatchTask(task, a.len());
+    return result;
+}
+
+template <class T, bool Mean>
+static FixedArray<typename ReduceTraits<T>::mean_type>
+va_sum(const FixedVArray<T> &a)
+{
+    MATH_EXC_ON;
+    FixedArray<typename ReduceTraits<T>::mean_type> result(a.len(), UNINITIALIZED);
+    detail::VArraySumTask<T,Mean> task(a, result);
+    dispatchTask(task, a.len());
+    return result;
+}
+
+template <class T>
+static FixedVArray<T>
+va_gather(const FixedVArray<int> &indices, const FixedArray<T> &values)
+{
+    MATH_EXC_ON;
+    detail::checkVArrayIndices(indices, values.len());
+    FixedVArray<T> result(indices.counts(), UNINITIALIZED);
+    detail::VArrayGatherTask<T> task(indices, values, result);
+    dispatchTask(task, indices.len());
+    return result;
+}
+
+template <class T>
+static FixedArray<T>
+va_scatterAdd(const FixedVArray<int> &indices, const FixedArray<T> &values, size_t n)
+{
+    MATH_EXC_ON;
+    if (size_t(values.len()) != size_t(indices.len()))
+        throw IEX_NAMESPACE::ArgExc("Dimensions of source do not match destination");
+    detail::ItemSource<T> source = {values};
+    return detail::scatterAddVArray<T>(indices, n, source);
+}
+
+template <class T>
+static FixedArray<T>
+va_scatterAdd_items(const FixedVArray<int> &indices, const FixedVArray<T> &values, size_t n)
+{
+    MATH_EXC_ON;
+    if (size_t(values.len()) != size_t(indices.len()))
+        throw IEX_NAMESPACE::ArgExc("Dimensions of source do not match destination");
+    for (size_t i = 0, len = indices.len(); i < len; ++i)
+    {
+        if (indices.itemLength(i) != values.itemLength(i))
+            throw IEX_NAMESPACE::ArgExc("Item lengths of source do not match destination");
+    }
+    detail::ItemElementSource<T> source = {values};
+    return detail::scatterAddVArray<T>(indices, n, source);
+}
+
+template <class T>
+static void add_varray_reduction_functions(py::class_<FixedVArray<T> > &c) {
+    c.def("sum",&va_sum<T,false>,
+          "sum() -- the sum of the elements of each item, as doubles for integer elements");
+    c.def("mean",&va_sum<T,true>,
+          "mean() -- the mean of the elements of each item, zero for empty items");
+    c.def("min",&va_reduce<T,REDUCE_MIN>,
+          "min() -- the componentwise minimum of the elements of each item, zero for empty items");
+    c.def("max",&va_reduce<T,REDUCE_MAX>,
+          "max() -- the componentwise maximum of the elements of each item, zero for empty items");
+}
+
+// gather and scatterAdd between VIntArray indices and arrays of T
+template <class T>
+static void add_varray_index_functions(py::class_<FixedVArray<int> > &c) {
+    c.def("gather",&va_gather<T>,
+          "gather(values) -- the elements of values at the indices of each item, "
+          "as a variable array with the same item lengths",py::arg("values"));
+    c.def("scatterAdd",&va_scatterAdd<T>,
+          "scatterAdd(values,n) -- an array of length n holding, at each index, "
+          "the sum of values[i] over the items i that contain the index",py::arg("values"),py::arg("n"));
+    c.def("scatterAdd",&va_scatterAdd_items<T>,
+          "scatterAdd(values,n) -- an array of length n holding, at each index, "
+          "the sum of the elements of values at the places the index appears",py::arg("values"),py::arg("n"));
+}
+
+} // namespace PyImath
+
+#endif // _PyImathFixedVArrayOps_h_
@@ -469,6 +469,8 @@ struct IsVisibleTask : public Task
     IsVisibleTask(const IMATH_NAMESPACE::FrustumTest<T>& ft, const PyImath::FixedArray<T2> &p, PyImath::FixedArray<int> &r)
         : frustumTest(ft), points(p), results(r) {}
 
+    size_t elementCost() const { return 8; }
+
     void execute(size_t start, size_t end)
     {
         for(size_t p = start; p < end; ++p)
@@ -481,13 +483,136 @@ PyImath::FixedArray<int>
 frustumTest_isVisible(IMATH_NAMESPACE::FrustumTest<T>& ft, const PyImath::FixedArray<T2>& points)
 {
     size_t numPoints = points.len();
-    PyImath::FixedArray<int> mask(numPoints);
+    PyImath::FixedArray<int> mask(numPoints, PyImath::UNINITIALIZED);
 
     IsVisibleTask<T,T2> task(ft,points,mask);
     dispatchTask(task,numPoints);
     return mask;
 }
 
+//
+// Batched culling of boxes and spheres.  Each test is FrustumTest's own,
+// which checks three planes at a time and stops at the first half that
+// rejects the object.
+//
+
+template <class T,class T2>
+struct IsVisibleBoxTask : public Task
+{
+    const IMATH_NAMESPACE::FrustumTest<T>& frustumTest;
+    const PyImath::FixedArray<IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T2> > >& boxes;
+    PyImath::FixedArray<int>& results;
+
+    IsVisibleBoxTask(const IMATH_NAMESPACE::FrustumTest<T>& ft,
+                     const PyImath::FixedArray<IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T2> > > &b,
+                     PyImath::FixedArray<int> &r)
+        : frustumTest(ft), boxes(b), results(r) {}
+
+    size_t elementCost() const { return 24; }
+
+    void execute(size_t start, size_t end)
+    {
+        for(size_t p = start; p < end; ++p)
+        {
+            const IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T2> > &b = boxes[p];
+            results[p] = frustumTest.isVisible(IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> >(IMATH_NAMESPACE::Vec3<T>(b.min),
+                                                                                                IMATH_NAMESPACE::Vec3<T>(b.max)));
+        }
+    }
+};
+
+template <class T,class T2>
+struct IsVisibleSphereTask : public Task
+{
+    const IMATH_NAMESPACE::FrustumTest<T>& frustumTest;
+    const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T2> >& centers;
+    const PyImath::FixedArray<T2>& radii;
+    PyImath::FixedArray<int>& results;
+
+    IsVisibleSphereTask(const IMATH_NAMESPACE::FrustumTest<T>& ft,
+                        const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T2> > &c,
+                        const PyImath::FixedArray<T2> &r,
+                        PyImath::FixedArray<int> &res)
+        : frustumTest(ft), centers(c), radii(r), results(res) {}
+
+    size_t elementCost() const { return 16; }
+
+    void execute(size_t start, size_t end)
+    {
+        for(size_t p = start; p < end; ++p)
+            results[p] = frustumTest.isVisible(IMATH_NAMESPACE::Sphere3<T>(IMATH_NAMESPACE::Vec3<T>(centers[p]), T(radii[p])));
+    }
+};
+
+template <class T,class T2>
+PyImath::FixedArray<int>
+frustumTest_isVisibleBoxes(IMATH_NAMESPACE::FrustumTest<T>& ft,
+                           const PyImath::FixedArray<IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T2> > >& boxes)
+{
+    MATH_EXC_ON;
+    size_t numBoxes = boxes.len();
+    PyImath::FixedArray<int> mask(numBoxes, PyImath::UNINITIALIZED);
+
+    IsVisibleBoxTask<T,T2> task(ft,boxes,mask);
+    dispatchTask(task,numBoxes);
+    return mask;
+}
+
+template <class T,class T2>
+PyImath::FixedArray<int>
+frustumTest_isVisibleSpheres(IMATH_NAMESPACE::FrustumTest<T>& ft,
+                             const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T2> >& centers,
+                             const PyImath::FixedArray<T2>& radii)
+{
+    MATH_EXC_ON;
+    size_t numSpheres = centers.match_dimension(radii);
+    PyImath::FixedArray<int> mask(numSpheres, PyImath::UNINITIALIZED);
+
+    IsVisibleSphereTask<T,T2> task(ft,centers,radii,mask);
+    dispatchTask(task,numSpheres);
+    return mask;
+}
+
+// The indices of the set elements of a visibility mask.
+static PyImath::FixedArray<int>
+visibleIndices(const PyImath::FixedArray<int>& mask)
+{
+    size_t len = mask.len();
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i)
+        count += mask[i] != 0;
+
+    PyImath::FixedArray<int> indices(count, PyImath::UNINITIALIZED);
+    for (size_t i = 0, j = 0; i < len; ++i)
+        if (mask[i])
+            indices[j++] = int(i);
+    return indices;
+}
+
+template <class T,class T2>
+PyImath::FixedArray<int>
+frustumTest_visiblePoints(IMATH_NAMESPACE::FrustumTest<T>& ft, const PyImath::FixedArray<T2>& points)
+{
+    return visibleIndices(frustumTest_isVisible(ft,points));
+}
+
+template <class T,class T2>
+PyImath::FixedArray<int>
+frustumTest_visibleBoxes(IMATH_NAMESPACE::FrustumTest<T>& ft,
+                         const PyImath::FixedArray<IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T2> > >& boxes)
+{
+    return visibleIndices(frustumTest_isVisibleBoxes(ft,boxes));
+}
+
+template <class T,class T2>
+PyImath::FixedArray<int>
+frustumTest_visibleSpheres(IMATH_NAMESPACE::FrustumTest<T>& ft,
+                           const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T2> >& centers,
+                           const PyImath::FixedArray<T2>& radii)
+{
+    return visibleIndices(frustumTest_isVisibleSpheres(ft,centers,radii));
+}
+
 template <class T>
 py::class_<FrustumTest<T> >
 register_FrustumTest(py::module &m)
@@ -507,6 +632,24 @@ register_FrustumTest(py::module &m)
         .def("isVisible",isVisibleB)
         .def("isVisible",isVisibleV)
         .def("isVisible",&frustumTest_isVisible<T,IMATH_NAMESPACE::V3f>)
+        .def("isVisible",&frustumTest_isVisibleBoxes<T,float>,
+             "isVisible(boxes) -- an IntArray that is 1 for each box of the array that may be visible")
+        .def("isVisible",&frustumTest_isVisibleBoxes<T,double>,
+             "isVisible(boxes) -- an IntArray that is 1 for each box of the array that may be visible")
+        .def("isVisible",&frustumTest_isVisibleSpheres<T,float>,
+             "isVisible(centers,radii) -- an IntArray that is 1 for each sphere that may be visible")
+        .def("isVisible",&frustumTest_isVisibleSpheres<T,double>,
+             "isVisible(centers,radii) -- an IntArray that is 1 for each sphere that may be visible")
+        .def("visibleIndices",&frustumTest_visiblePoints<T,IMATH_NAMESPACE::V3f>,
+             "visibleIndices(points) -- the indices of the visible points")
+        .def("visibleIndices",&frustumTest_visibleBoxes<T,float>,
+             "visibleIndices(boxes) -- the indices of the boxes that may be visible")
+        .def("visibleIndices",&frustumTest_visibleBoxes<T,double>,
+             "visibleIndices(boxes) -- the indices of the boxes that may be visible")
+        .def("visibleIndices",&frustumTest_visibleSpheres<T,float>,
+             "visibleIndices(centers,radii) -- the indices of the spheres that may be visible")
+        .def("visibleIndices",&frustumTest_visibleSpheres<T,double>,
+             "visibleIndices(centers,radii) -- the indices of the spheres that may be visible")
         .def("completelyContains",completelyContainsS)
         .def("completelyContains",completelyContainsB)
         ;
@@ -36,7 +36,7 @@
 #include <PyImathFun.h>
 #include <PyImathDecorators.h>
 #include <PyImathExport.h>
-//#include <PyImathAutovectorize.h>
+#include <PyImathAutovectorize.h>
 #include <boost/format.hpp>
 #include <boost/mpl/bool.hpp>
 #include <ImathVec.h>
@@ -280,92 +280,111 @@ struct gain_op
 
 void register_functions(py::module &m)
 {
+    using boost::mpl::true_;
+
     //
     // Utility Functions
     //
 
-    PyImath::generate_bindings(m, &abs_op<int>::apply,
+    PyImath::generate_bindings<abs_op<int>,true_>(m,
         "abs",
-        "return the absolute value of 'value'"
+        "return the absolute value of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &abs_op<float>::apply,
+    PyImath::generate_bindings<abs_op<float>,true_>(m,
         "abs",
-        "return the absolute value of 'value'"
+        "return the absolute value of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &abs_op<double>::apply,
+    PyImath::generate_bindings<abs_op<double>,true_>(m,
         "abs",
-        "return the absolute value of 'value'"
+        "return the absolute value of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &sign_op<int>::apply,
+    PyImath::generate_bindings<sign_op<int>,true_>(m,
         "sign",
-        "return 1 or -1 based on the sign of 'value'"
+        "return 1 or -1 based on the sign of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &sign_op<float>::apply,
+    PyImath::generate_bindings<sign_op<float>,true_>(m,
         "sign",
-        "return 1 or -1 based on the sign of 'value'"
+        "return 1 or -1 based on the sign of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &sign_op<double>::apply,
+    PyImath::generate_bindings<sign_op<double>,true_>(m,
         "sign",
-        "return 1 or -1 based on the sign of 'value'"
+        "return 1 or -1 based on the sign of 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &log_op<float>::apply,
+    PyImath::generate_bindings<log_op<float>,true_>(m,
         "log",
-        "return the natural log of 'value'"
+        "return the natural log of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &log_op<double>::apply,
+    PyImath::generate_bindings<log_op<double>,true_>(m,
         "log",
-        "return the natural log of 'value'"
+        "return the natural log of 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &log10_op<float>::apply,
+    PyImath::generate_bindings<log10_op<float>,true_>(m,
         "log10",
-        "return the base 10 log of 'value'"
+        "return the base 10 log of 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &log10_op<double>::apply,
+    PyImath::generate_bindings<log10_op<double>,true_>(m,
         "log10",
-        "return the base 10 log of 'value'"
+        "return the base 10 log of 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &lerp_op<float>::apply,
+    PyImath::generate_bindings<lerp_op<float>,true_,true_,true_>(m,
         "lerp",
-        "return the linear interpolation of 'a' to 'b' using parameter 't'"
+        "return the linear interpolation of 'a' to 'b' using parameter 't'",
+        PyImath::args("a","b","t")
         );
-    PyImath::generate_bindings(m, &lerp_op<double>::apply,
+    PyImath::generate_bindings<lerp_op<double>,true_,true_,true_>(m,
         "lerp",
-        "return the linear interpolation of 'a' to 'b' using parameter 't'"
+        "return the linear interpolation of 'a' to 'b' using parameter 't'",
+        PyImath::args("a","b","t")
         );
 
-    PyImath::generate_bindings(m, &lerpfactor_op<float>::apply,
+    PyImath::generate_bindings<lerpfactor_op<float>,true_,true_,true_>(m,
         "lerpfactor",
         R"(return how far m is between a and b, that is return t such that\
 if:
     t = lerpfactor(m, a, b);
 then:
     m = lerp(a, b, t);
-if a==b, return 0.)"
+if a==b, return 0.)",
+        PyImath::args("m","a","b")
         );
-    PyImath::generate_bindings(m, &lerpfactor_op<double>::apply,
+    PyImath::generate_bindings<lerpfactor_op<double>,true_,true_,true_>(m,
         "lerpfactor",
         R"(return how far m is between a and b, that is return t such that\n"
 if:
     t = lerpfactor(m, a, b);
 then:
     m = lerp(a, b, t);
-if a==b, return 0.)"
+if a==b, return 0.)",
+        PyImath::args("m","a","b")
         );
 
-    PyImath::generate_bindings(m, &clamp_op<int>::apply,
+    PyImath::generate_bindings<clamp_op<int>,true_,true_,true_>(m,
         "clamp",
-        "return the value clamped to the range [low,high]"
+        "return the value clamped to the range [low,high]",
+        PyImath::args("value","low","high")
         );
-    PyImath::generate_bindings(m, &clamp_op<float>::apply,
+    PyImath::generate_bindings<clamp_op<float>,true_,true_,true_>(m,
         "clamp",
-        "return the value clamped to the range [low,high]"
+        "return the value clamped to the range [low,high]",
+        PyImath::args("value","low","high")
         );
-    PyImath::generate_bindings(m, &clamp_op<double>::apply,
+    PyImath::generate_bindings<clamp_op<double>,true_,true_,true_>(m,
         "clamp",
-        "return the value clamped to the range [low,high]"
+        "return the value clamped to the range [low,high]",
+        PyImath::args("value","low","high")
         );
 
     m.def("cmp", IMATH_NAMESPACE::cmp<float>);
@@ -380,74 +399,87 @@ if a==b, return 0.)"
     m.def("equal", IMATH_NAMESPACE::equal<float, float, float>);
     m.def("equal", IMATH_NAMESPACE::equal<double, double, double>);
 
-    PyImath::generate_bindings(m, &floor_op<float>::apply,
+    PyImath::generate_bindings<floor_op<float>,true_>(m,
         "floor",
-        "return the closest integer less than or equal to 'value'"
+        "return the closest integer less than or equal to 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &floor_op<double>::apply,
+    PyImath::generate_bindings<floor_op<double>,true_>(m,
         "floor",
-        "return the closest integer less than or equal to 'value'"
+        "return the closest integer less than or equal to 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &ceil_op<float>::apply,
+    PyImath::generate_bindings<ceil_op<float>,true_>(m,
         "ceil",
-        "return the closest integer greater than or equal to 'value'"
+        "return the closest integer greater than or equal to 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &ceil_op<double>::apply,
+    PyImath::generate_bindings<ceil_op<double>,true_>(m,
         "ceil",
-        "return the closest integer greater than or equal to 'value'"
+        "return the closest integer greater than or equal to 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &trunc_op<float>::apply,
+    PyImath::generate_bindings<trunc_op<float>,true_>(m,
         "trunc",
-        "return the closest integer with magnitude less than or equal to 'value'"
+        "return the closest integer with magnitude less than or equal to 'value'",
+        PyImath::args("value")
         );
-    PyImath::generate_bindings(m, &trunc_op<double>::apply,
+    PyImath::generate_bindings<trunc_op<double>,true_>(m,
         "trunc",
-        "return the closest integer with magnitude less than or equal to 'value'"
+        "return the closest integer with magnitude less than or equal to 'value'",
+        PyImath::args("value")
         );
 
-    PyImath::generate_bindings(m, &divs_op::apply,
+    PyImath::generate_bindings<divs_op,true_,true_>(m,
         "divs",
         R"(return x/y where the remainder has the same sign as x:
-divs(x,y) == (abs(x) / abs(y)) * (sign(x) * sign(y)))"
+divs(x,y) == (abs(x) / abs(y)) * (sign(x) * sign(y)))",
+        PyImath::args("x","y")
         );
 
-    PyImath::generate_bindings(m, &mods_op::apply,
+    PyImath::generate_bindings<mods_op,true_,true_>(m,
         "mods",
         R"("return x%y where the remainder has the same sign as x:
-mods(x,y) == x - y * divs(x,y))"
+mods(x,y) == x - y * divs(x,y))",
+        PyImath::args("x","y")
         );
 
-    PyImath::generate_bindings(m, &divp_op::apply,
+    PyImath::generate_bindings<divp_op,true_,true_>(m,
         "divp",
         R"(return x/y where the remainder is always positive:
-divp(x,y) == floor (double(x) / double (y)))"
+divp(x,y) == floor (double(x) / double (y)))",
+        PyImath::args("x","y")
         );
-    PyImath::generate_bindings(m, &modp_op::apply,
+    PyImath::generate_bindings<modp_op,true_,true_>(m,
         "modp",
         R"(return x%y where the remainder is always positive:
-modp(x,y) == x - y * divp(x,y))"
+modp(x,y) == x - y * divp(x,y))",
+        PyImath::args("x","y")
         );
 
-    PyImath::generate_bindings(m, &bias_op::apply,
+    PyImath::generate_bindings<bias_op,true_,true_>(m,
          "bias",
-         "bias(x,b) is a gamma correction that remaps the unit interval such that bias(0.5, b) = b."
+         "bias(x,b) is a gamma correction that remaps the unit interval such that bias(0.5, b) = b.",
+         PyImath::args("x","b")
          );
 
-    PyImath::generate_bindings(m, &gain_op::apply,
+    PyImath::generate_bindings<gain_op,true_,true_>(m,
          "gain",
          R"(gain(x,g) is a gamma correction that remaps the unit interval with the property that gain(0.5, g) = 0.5.
- The gain function can be thought of as two scaled bias curves forming an 'S' shape in the unit interval.)"
+ The gain function can be thought of as two scaled bias curves forming an 'S' shape in the unit interval.)",
+         PyImath::args("x","g")
          );
 
     //
     // Vectorized utility functions
     // 
-    PyImath::generate_bindings(m, &rotationXYZWithUpDir_op<float>::apply,
+    PyImath::generate_bindings<rotationXYZWithUpDir_op<float>,true_,true_,true_>(m,
         "rotationXYZWithUpDir",
         R"(return the XYZ rotation vector that rotates 'fromDir' to 'toDir'"
-using the up vector 'upDir')"
+using the up vector 'upDir')",
+        PyImath::args("fromDir","toDir","upDir")
         );
 }
 
@@ -42,6 +42,7 @@
 #include <PyImath.h>
 #include <PyImathVec.h>
 #include <PyImathMathExc.h>
+#include <PyImathMatrixOperators.h>
 #include <ImathVec.h>
 #include <ImathMatrixAlgo.h>
 #include <Iex.h>
@@ -362,7 +363,7 @@ multDirMatrix33_array(Matrix33<TM> &mat, const FixedArray<Vec2<TV> >&src)
 {
     MATH_EXC_ON;
     size_t len = src.len();
-    FixedArray<Vec2<TV> > dst(len);
+    FixedArray<Vec2<TV> > dst(len, UNINITIALIZED);
     for (size_t i=0; i<len; ++i) mat.multDirMatrix(src[i], dst[i]);    
     return dst;
 }
@@ -391,7 +392,7 @@ multVecMatrix33_array(Matrix33<TM> &mat, const FixedArray<Vec2<TV> >&src)
 {
     MATH_EXC_ON;
     size_t len = src.len();
-    FixedArray<Vec2<TV> > dst(len);
+    FixedArray<Vec2<TV> > dst(len, UNINITIALIZED);
     for (size_t i=0; i<len; ++i) mat.multVecMatrix(src[i], dst[i]);    
     return dst;
 }
@@ -920,8 +921,8 @@ register_Matrix33(py::module &m)
         .def("negate", &negate33<T>, py::return_value_policy::reference_internal, "negate() negate all entries in this matrix")
         .def("__neg__", &neg33<T>)
         .def("__imul__", &imul33T<T>, py::return_value_policy::reference_internal)
-        .def("__mul__", &mul33T<T>)
-        .def("__rmul__", &rmul33T<T>)
+        .def("__mul__", &mul33T<T>, py::is_operator())
+        .def("__rmul__", &rmul33T<T>, py::is_operator())
         .def("__idiv__", &idiv33T<T>, py::return_value_policy::reference_internal)
         .def("__itruediv__", &idiv33T<T>, py::return_value_policy::reference_internal)
         .def("__div__", &div33T<T>)
@@ -930,10 +931,10 @@ register_Matrix33(py::module &m)
         .def("__radd__", &add33T<T>)
         .def("__sub__", &subtractTL33<T>)
         .def("__rsub__", &subtractTR33<T>)
-        .def("__mul__", &mul33<float, T>)
-        .def("__mul__", &mul33<double, T>)
-        .def("__rmul__", &rmul33<float, T>)
-        .def("__rmul__", &rmul33<double, T>)
+        .def("__mul__", &mul33<float, T>, py::is_operator())
+        .def("__mul__", &mul33<double, T>, py::is_operator())
+        .def("__rmul__", &rmul33<float, T>, py::is_operator())
+        .def("__rmul__", &rmul33<double, T>, py::is_operator())
         .def("__imul__", &imul33<float, T>, py::return_value_policy::reference_internal)
         .def("__imul__", &imul33<double, T>, py::return_value_policy::reference_internal)
         .def("__lt__", &lessThan33<T>)
@@ -1130,6 +1131,8 @@ register_M33Array(py::module &m)
     matrixArray_class
          .def("__setitem__", &setM33ArrayItem<T>)
         ;
+
+    add_matrix_array_algebra(matrixArray_class);
     return matrixArray_class;
 }
 
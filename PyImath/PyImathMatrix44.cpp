@@ -41,10 +41,13 @@
 #include <boost/format.hpp>
 #include <PyImath.h>
 #include <PyImathVec.h>
+#include <PyImathEuler.h>
 #include <PyImathMathExc.h>
+#include <PyImathMatrixOperators.h>
 #include <ImathVec.h>
 #include <ImathMatrixAlgo.h>
 #include <Iex.h>
+#include <PyImathFixedArrayReduce.h>
 #include <PyImathTask.h>
 
 namespace PyImath {
@@ -372,6 +375,8 @@ struct MatrixVecTask : public Task
     MatrixVecTask(const Matrix44<T2> &m, const FixedArray<Vec3<T1> >& s, FixedArray<Vec3<T1> >& d)
         : mat(m), src(s), dst(d) {}
 
+    size_t elementCost() const { return 8; }
+
     void execute(size_t start, size_t end)
     {
         for(size_t p = start; p < end; ++p) 
@@ -385,7 +390,7 @@ multDirMatrix44_array(Matrix44<TM> &mat, const FixedArray<Vec3<TV> >&src)
 {
     MATH_EXC_ON;
     size_t len = src.len();
-    FixedArray<Vec3<TV> > dst(len);
+    FixedArray<Vec3<TV> > dst(len, UNINITIALIZED);
 
     MatrixVecTask<TV,TM,op_multDirMatrix<TV,TM> > task(mat,src,dst);
     dispatchTask(task,len);
@@ -418,7 +423,7 @@ multVecMatrix44_array(Matrix44<TM> &mat, const FixedArray<Vec3<TV> >&src)
 {
     MATH_EXC_ON;
     size_t len = src.len();
-    FixedArray<Vec3<TV> > dst(len);
+    FixedArray<Vec3<TV> > dst(len, UNINITIALIZED);
 
     MatrixVecTask<TV,TM,op_multVecMatrix<TV,TM> > task(mat,src,dst);
     dispatchTask(task,len);
@@ -426,6 +431,263 @@ multVecMatrix44_array(Matrix44<TM> &mat, const FixedArray<Vec3<TV> >&src)
     return dst;
 }
 
+//
+// Transform each point or direction of src by its own matrix: the matrix
+// with the same index, or the one picked by indices[i] when an index array
+// is given (skinning, or instances sharing a transform).
+//
+
+template <class TV, class TM, class Op>
+struct MatrixArrayVecTask : public Task
+{
+    const FixedArray<Matrix44<TM> > &mats;
+    const FixedArray<int> *indices;
+    const FixedArray<Vec3<TV> > &src;
+    FixedArray<Vec3<TV> > &dst;
+
+    MatrixArrayVecTask(const FixedArray<Matrix44<TM> > &m, const FixedArray<int> *i,
+                       const FixedArray<Vec3<TV> > &s, FixedArray<Vec3<TV> > &d)
+        : mats(m), indices(i), src(s), dst(d) {}
+
+    size_t elementCost() const { return 8; }
+
+    void execute(size_t start, size_t end)
+    {
+        if (mats.isMaskedReference() || src.isMaskedReference() ||
+            (indices && indices->isMaskedReference()))
+        {
+            for (size_t p = start; p < end; ++p)
+                Op::apply(mats[indices ? (*indices)[p] : p], src[p], dst[p]);
+        }
+        else if (indices)
+        {
+            for (size_t p = start; p < end; ++p)
+                Op::apply(mats.direct_index(indices->direct_index(p)),
+                          src.direct_index(p), dst.direct_index(p));
+        }
+        else
+        {
+            for (size_t p = start; p < end; ++p)
+                Op::apply(mats.direct_index(p), src.direct_index(p), dst.direct_index(p));
+        }
+    }
+};
+
+template <class TV, class TM, class Op>
+static FixedArray<Vec3<TV> >
+multMatrix44Array(const FixedArray<Matrix44<TM> > &mats, const FixedArray<int> *indices,
+                  const FixedArray<Vec3<TV> > &src)
+{
+    MATH_EXC_ON;
+    size_t len;
+    if (indices)
+    {
+        len = src.match_dimension(*indices);
+        ArrayReduction<int> r = reduceArray<REDUCE_MIN|REDUCE_MAX>(*indices);
+        if (r.count > 0 && (r.min < 0 || size_t(r.max) >= mats.len()))
+            throw IEX_NAMESPACE::ArgExc("Matrix index out of range");
+    }
+    else
+        len = mats.match_dimension(src);
+
+    FixedArray<Vec3<TV> > dst(len, UNINITIALIZED);
+
+    MatrixArrayVecTask<TV,TM,Op> task(mats,indices,src,dst);
+    dispatchTask(task,len);
+
+    return dst;
+}
+
+template <class TV, class TM>
+static FixedArray<Vec3<TV> >
+M44Array_multVecMatrix(const FixedArray<Matrix44<TM> > &mats, const FixedArray<Vec3<TV> > &src)
+{
+    return multMatrix44Array<TV,TM,op_multVecMatrix<TV,TM> >(mats, 0, src);
+}
+
+template <class TV, class TM>
+static FixedArray<Vec3<TV> >
+M44Array_multVecMatrixIndexed(const FixedArray<Matrix44<TM> > &mats, const FixedArray<Vec3<TV> > &src,
+                              const FixedArray<int> &indices)
+{
+    return multMatrix44Array<TV,TM,op_multVecMatrix<TV,TM> >(mats, &indices, src);
+}
+
+template <class TV, class TM>
+static FixedArray<Vec3<TV> >
+M44Array_multDirMatrix(const FixedArray<Matrix44<TM> > &mats, const FixedArray<Vec3<TV> > &src)
+{
+    return multMatrix44Array<TV,TM,op_multDirMatrix<TV,TM> >(mats, 0, src);
+}
+
+template <class TV, class TM>
+static FixedArray<Vec3<TV> >
+M44Array_multDirMatrixIndexed(const FixedArray<Matrix44<TM> > &mats, const FixedArray<Vec3<TV> > &src,
+                              const FixedArray<int> &indices)
+{
+    return multMatrix44Array<TV,TM,op_multDirMatrix<TV,TM> >(mats, &indices, src);
+}
+
+//
+// Decompose every matrix of an array in one parallel pass.  Elements that
+// cannot be decomposed (a scale too close to zero) are flagged with a 0 in
+// the returned status array and get zero components, instead of raising.
+//
+
+template <class T>
+struct ExtractSHRTTask : public Task
+{
+    const FixedArray<Matrix44<T> > &mats;
+    FixedArray<Vec3<T> > &s;
+    FixedArray<Vec3<T> > &h;
+    FixedArray<Euler<T> > &r;
+    FixedArray<Vec3<T> > &t;
+    FixedArray<int> &ok;
+    typename Euler<T>::Order order;
+
+    ExtractSHRTTask(const FixedArray<Matrix44<T> > &m,
+                    FixedArray<Vec3<T> > &s_, FixedArray<Vec3<T> > &h_,
+                    FixedArray<Euler<T> > &r_, FixedArray<Vec3<T> > &t_,
+                    FixedArray<int> &ok_, typename Euler<T>::Order o)
+        : mats(m), s(s_), h(h_), r(r_), t(t_), ok(ok_), order(o) {}
+
+    size_t elementCost() const { return 256; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            Euler<T> e(order);
+            ok[i] = IMATH_NAMESPACE::extractSHRT(mats[i], s[i], h[i], e, t[i], false);
+            if (!ok[i])
+            {
+                s[i] = h[i] = t[i] = Vec3<T>(0);
+                e = Euler<T>(order);
+            }
+            r[i] = e;
+        }
+    }
+};
+
+template <class T>
+struct ExtractScalingAndShearTask : public Task
+{
+    const FixedArray<Matrix44<T> > &mats;
+    FixedArray<Vec3<T> > &s;
+    FixedArray<Vec3<T> > *h;
+    FixedArray<int> &ok;
+
+    ExtractScalingAndShearTask(const FixedArray<Matrix44<T> > &m, FixedArray<Vec3<T> > &s_,
+                               FixedArray<Vec3<T> > *h_, FixedArray<int> &ok_)
+        : mats(m), s(s_), h(h_), ok(ok_) {}
+
+    size_t elementCost() const { return 64; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            Vec3<T> shr;
+            ok[i] = IMATH_NAMESPACE::extractScalingAndShear(mats[i], s[i], shr, false);
+            if (!ok[i])
+                s[i] = shr = Vec3<T>(0);
+            if (h)
+                (*h)[i] = shr;
+        }
+    }
+};
+
+template <class T>
+struct ExtractEulerTask : public Task
+{
+    const FixedArray<Matrix44<T> > &mats;
+    FixedArray<Euler<T> > &r;
+    typename Euler<T>::Order order;
+
+    ExtractEulerTask(const FixedArray<Matrix44<T> > &m, FixedArray<Euler<T> > &r_,
+                     typename Euler<T>::Order o)
+        : mats(m), r(r_), order(o) {}
+
+    size_t elementCost() const { return 128; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            Euler<T> e(order);
+            e.extract(mats[i]);
+            r[i] = e;
+        }
+    }
+};
+
+template <class T>
+static py::tuple
+M44Array_extractSHRT(const FixedArray<Matrix44<T> > &mats, int order)
+{
+    MATH_EXC_ON;
+    size_t len = mats.len();
+    FixedArray<Vec3<T> > s(len, UNINITIALIZED);
+    FixedArray<Vec3<T> > h(len, UNINITIALIZED);
+    FixedArray<Euler<T> > r(len, UNINITIALIZED);
+    FixedArray<Vec3<T> > t(len, UNINITIALIZED);
+    FixedArray<int> ok(len, UNINITIALIZED);
+
+    ExtractSHRTTask<T> task(mats, s, h, r, t, ok, eulerOrderFromInt<T>(order));
+    dispatchTask(task, len);
+    mathexcon.handleOutstandingExceptions();
+
+    return py::make_tuple(s, h, r, t, ok);
+}
+
+template <class T>
+static py::tuple
+M44Array_extractScaling(const FixedArray<Matrix44<T> > &mats)
+{
+    MATH_EXC_ON;
+    size_t len = mats.len();
+    FixedArray<Vec3<T> > s(len, UNINITIALIZED);
+    FixedArray<int> ok(len, UNINITIALIZED);
+
+    ExtractScalingAndShearTask<T> task(mats, s, 0, ok);
+    dispatchTask(task, len);
+    mathexcon.handleOutstandingExceptions();
+
+    return py::make_tuple(s, ok);
+}
+
+template <class T>
+static py::tuple
+M44Array_extractScalingAndShear(const FixedArray<Matrix44<T> > &mats)
+{
+    MATH_EXC_ON;
+    size_t len = mats.len();
+    FixedArray<Vec3<T> > s(len, UNINITIALIZED);
+    FixedArray<Vec3<T> > h(len, UNINITIALIZED);
+    FixedArray<int> ok(len, UNINITIALIZED);
+
+    ExtractScalingAndShearTask<T> task(mats, s, &h, ok);
+    dispatchTask(task, len);
+    mathexcon.handleOutstandingExceptions();
+
+    return py::make_tuple(s, h, ok);
+}
+
+template <class T>
+static FixedArray<Euler<T> >
+M44Array_extractEuler(const FixedArray<Matrix44<T> > &mats, int order)
+{
+    MATH_EXC_ON;
+    size_t len = mats.len();
+    FixedArray<Euler<T> > r(len, UNINITIALIZED);
+
+    ExtractEulerTask<T> task(mats, r, eulerOrderFromInt<T>(order));
+    dispatchTask(task, len);
+    mathexcon.handleOutstandingExceptions();
+
+    return r;
+}
+
 template <class T>
 static int
 removeScaling44(Matrix44<T> &mat, int exc = 1)
@@ -1019,8 +1281,8 @@ register_Matrix44(py::module &m)
 .def("negate", &negate44<T>, py::return_value_policy::reference_internal, "negate() negate all entries in this matrix")
 .def("__neg__", &neg44<T>)
 .def("__imul__", &imul44T<T>, py::return_value_policy::reference_internal)
-.def("__mul__", &mul44T<T>)
-.def("__rmul__", &rmul44T<T>)
+.def("__mul__", &mul44T<T>, py::is_operator())
+.def("__rmul__", &rmul44T<T>, py::is_operator())
 .def("__idiv__", &idiv44T<T>, py::return_value_policy::reference_internal)
 .def("__itruediv__", &idiv44T<T>, py::return_value_policy::reference_internal)
 .def("__div__", &div44T<T>)
@@ -1029,10 +1291,10 @@ register_Matrix44(py::module &m)
 .def("__radd__", &add44T<T>)
 .def("__sub__", &subtractTL44<T>)
 .def("__rsub__", &subtractTR44<T>)
-.def("__mul__", &mul44<float, T>)
-.def("__mul__", &mul44<double, T>)
-.def("__rmul__", &rmul44<float, T>)
-.def("__rmul__", &rmul44<double, T>)
+.def("__mul__", &mul44<float, T>, py::is_operator())
+.def("__mul__", &mul44<double, T>, py::is_operator())
+.def("__rmul__", &rmul44<float, T>, py::is_operator())
+.def("__rmul__", &rmul44<double, T>, py::is_operator())
 .def("__imul__", &imul44<float, T>, py::return_value_policy::reference_internal)
 .def("__imul__", &imul44<double, T>, py::return_value_policy::reference_internal)
 .def("__lt__", &lessThan44<T>)
@@ -1222,7 +1484,35 @@ register_M44Array(py::module &m)
     py::class_<FixedArray<IMATH_NAMESPACE::Matrix44<T> > > matrixArray_class = FixedArray<IMATH_NAMESPACE::Matrix44<T> >::register_(m, "Fixed length array of IMATH_NAMESPACE::Matrix44");
     matrixArray_class
          .def("__setitem__", &setM44ArrayItem<T>)
+         .def("multVecMatrix", &M44Array_multVecMatrix<float,T>,
+              "multVecMatrix(src) -- transform each point of src by the matrix with the same index")
+         .def("multVecMatrix", &M44Array_multVecMatrix<double,T>,
+              "multVecMatrix(src) -- transform each point of src by the matrix with the same index")
+         .def("multVecMatrix", &M44Array_multVecMatrixIndexed<float,T>,
+              "multVecMatrix(src,indices) -- transform each point src[i] by the matrix self[indices[i]]")
+         .def("multVecMatrix", &M44Array_multVecMatrixIndexed<double,T>,
+              "multVecMatrix(src,indices) -- transform each point src[i] by the matrix self[indices[i]]")
+         .def("multDirMatrix", &M44Array_multDirMatrix<float,T>,
+              "multDirMatrix(src) -- transform each direction of src by the matrix with the same index")
+         .def("multDirMatrix", &M44Array_multDirMatrix<double,T>,
+              "multDirMatrix(src) -- transform each direction of src by the matrix with the same index")
+         .def("multDirMatrix", &M44Array_multDirMatrixIndexed<float,T>,
+              "multDirMatrix(src,indices) -- transform each direction src[i] by the matrix self[indices[i]]")
+         .def("multDirMatrix", &M44Array_multDirMatrixIndexed<double,T>,
+              "multDirMatrix(src,indices) -- transform each direction src[i] by the matrix self[indices[i]]")
+         .def("extractSHRT", &M44Array_extractSHRT<T>, py::arg("order") = int(IMATH_NAMESPACE::Eulerf::XYZ),
+              "extractSHRT([order]) -- decompose each matrix into scale, shear, rotation and translation.\n"
+              "Returns (s, h, r, t, ok): V3 arrays s, h and t, an Euler array r in the given order\n"
+              "and an IntArray ok that is 0 where a matrix could not be decomposed")
+         .def("extractScaling", &M44Array_extractScaling<T>,
+              "extractScaling() -- return (s, ok), the scale of each matrix and a status array")
+         .def("extractScalingAndShear", &M44Array_extractScalingAndShear<T>,
+              "extractScalingAndShear() -- return (s, h, ok), the scale and shear of each matrix and a status array")
+         .def("extractEuler", &M44Array_extractEuler<T>, py::arg("order") = int(IMATH_NAMESPACE::Eulerf::XYZ),
+              "extractEuler([order]) -- return the rotation of each matrix as an Euler array in the given order")
         ;
+
+    add_matrix_array_algebra(matrixArray_class);
     return matrixArray_class;
 }
 
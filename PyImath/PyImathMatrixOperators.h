@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathMatrixOperators_h_
+#define _PyImathMatrixOperators_h_
+
+#include <PyImathOperators.h>
+
+namespace PyImath {
+
+//
+// Element ops for M33 and M44 arrays.  Singular elements invert to the
+// identity, as with inverse(False), since a worker thread has no way to
+// raise the exception for a single element.
+//
+
+template <class T>
+struct op_matInverse {
+    static inline T apply(const T &m) { return m.inverse(false); }
+};
+
+template <class T>
+struct op_matGJInverse {
+    static inline T apply(const T &m) { return m.gjInverse(false); }
+};
+
+template <class T>
+struct op_matTransposed {
+    static inline T apply(const T &m) { return m.transposed(); }
+};
+
+template <class T>
+struct op_matDeterminant {
+    static inline typename T::BaseType apply(const T &m) { return m.determinant(); }
+};
+
+//
+// Rough costs for dispatchTask(): n^3 multiply-adds for a product or an
+// inverse, fewer for a determinant.
+//
+template <class T> struct op_cost<op_mul<IMATH_NAMESPACE::Matrix44<T> > >     { static const size_t value = 64; };
+template <class T> struct op_cost<op_rmul<IMATH_NAMESPACE::Matrix44<T> > >    { static const size_t value = 64; };
+template <class T> struct op_cost<op_imul<IMATH_NAMESPACE::Matrix44<T> > >    { static const size_t value = 64; };
+template <class T> struct op_cost<op_matInverse<IMATH_NAMESPACE::Matrix44<T> > >    { static const size_t value = 128; };
+template <class T> struct op_cost<op_matGJInverse<IMATH_NAMESPACE::Matrix44<T> > >  { static const size_t value = 192; };
+template <class T> struct op_cost<op_matTransposed<IMATH_NAMESPACE::Matrix44<T> > > { static const size_t value = 16; };
+template <class T> struct op_cost<op_matDeterminant<IMATH_NAMESPACE::Matrix44<T> > >{ static const size_t value = 40; };
+
+template <class T> struct op_cost<op_mul<IMATH_NAMESPACE::Matrix33<T> > >     { static const size_t value = 27; };
+template <class T> struct op_cost<op_rmul<IMATH_NAMESPACE::Matrix33<T> > >    { static const size_t value = 27; };
+template <class T> struct op_cost<op_imul<IMATH_NAMESPACE::Matrix33<T> > >    { static const size_t value = 27; };
+template <class T> struct op_cost<op_matInverse<IMATH_NAMESPACE::Matrix33<T> > >    { static const size_t value = 48; };
+template <class T> struct op_cost<op_matGJInverse<IMATH_NAMESPACE::Matrix33<T> > >  { static const size_t value = 72; };
+template <class T> struct op_cost<op_matTransposed<IMATH_NAMESPACE::Matrix33<T> > > { static const size_t value = 9; };
+template <class T> struct op_cost<op_matDeterminant<IMATH_NAMESPACE::Matrix33<T> > >{ static const size_t value = 12; };
+
+//
+// The batched algebra shared by M33fArray, M33dArray, M44fArray and
+// M44dArray.  A product takes either an array of matrices of the same
+// length or a single matrix.
+//
+template <class M>
+static void
+add_matrix_array_algebra(py::class_<FixedArray<M> > &c)
+{
+    using boost::mpl::true_;
+    using boost::mpl::false_;
+
+    generate_member_bindings<op_mul<M>,true_>(c,"__mul__","self*x",args("x"));
+    generate_member_bindings<op_rmul<M>,false_>(c,"__rmul__","x*self",args("x"));
+    generate_member_bindings<op_imul<M>,true_>(c,"__imul__","self*=x",args("x"));
+    generate_member_bindings<op_matInverse<M> >(c,"inverse","return the inverse of each matrix");
+    generate_member_bindings<op_matGJInverse<M> >(c,"gjInverse","return the Gauss-Jordan inverse of each matrix");
+    generate_member_bindings<op_matTransposed<M> >(c,"transposed","return the transpose of each matrix");
+    generate_member_bindings<op_matDeterminant<M> >(c,"determinant","return the determinant of each matrix");
+}
+
+}  // namespace PyImath
+
+#endif // _PyImathMatrixOperators_h_
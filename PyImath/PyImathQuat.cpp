@@ -44,6 +44,7 @@
 #include <ImathEuler.h>
 #include <PyImathOperators.h>
 #include <PyImathTask.h>
+#include <PyImathFixedArraySoA.h>
 
 // XXX incomplete array wrapping, docstrings missing
 
@@ -394,7 +395,7 @@ rmulVec3Array(Quat<T> &quat, const FixedArray< Vec3<T> > &a)
     MATH_EXC_ON;
     Matrix44<T> m = quat.toMatrix44();
     size_t len = a.len();
-    FixedArray< Vec3<T> > r(len);
+    FixedArray< Vec3<T> > r(len, UNINITIALIZED);
     for (size_t i = 0; i < len; i++)
         r[i] = a[i] * m;
     return r;
@@ -572,6 +573,8 @@ struct QuatArray_SetRotationTask : public PyImath::Task
                                FixedArray<IMATH_NAMESPACE::Quat<T> >       &resultIn)
         : from (fromIn), to (toIn), result (resultIn) {}
 
+    size_t elementCost () const { return 16; }
+
     void execute (size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -607,6 +610,8 @@ struct QuatArray_OrientToVectors : public Task
         : forward (forwardIn), up (upIn), result (resultIn),
           alignForward (alignForwardIn) {}
 
+    size_t elementCost () const { return 64; }
+
     void execute (size_t start, size_t end)
     {
         Vec3<T> f(0), u(0);
@@ -658,6 +663,8 @@ struct QuatArray_Axis : public Task
                     FixedArray<IMATH_NAMESPACE::Vec3<T> >       &resultIn)
         : va (vaIn), result (resultIn) {}
 
+    size_t elementCost () const { return 8; }
+
     void execute (size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -687,6 +694,8 @@ struct QuatArray_Angle : public Task
                      FixedArray<T>                               &resultIn)
         : va (vaIn), result (resultIn) {}
 
+    size_t elementCost () const { return 8; }
+
     void execute (size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -718,6 +727,8 @@ struct QuatArray_RmulVec3 : public Task
                         const Vec3<T> &vIn, FixedArray<Vec3<T> > &rIn)
         : a (aIn), v (vIn), r (rIn) {}
 
+    size_t elementCost () const { return 16; }
+
     void execute(size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -753,6 +764,8 @@ struct QuatArray_RmulVec3Array : public Task
                              FixedArray<Vec3<T> > &rIn)
         : a (aIn), b (bIn), r (rIn) {}
 
+    size_t elementCost () const { return 16; }
+
     void execute(size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -789,6 +802,8 @@ struct QuatArray_SetAxisAngle : public Task
                             FixedArray<IMATH_NAMESPACE::Quat<T> >       &quatsIn)
         : axis (axisIn), angles (anglesIn), quats (quatsIn) {}
 
+    size_t elementCost () const { return 16; }
+
     void execute(size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -822,6 +837,8 @@ struct QuatArray_SetEulerXYZ : public Task
                            FixedArray<IMATH_NAMESPACE::Quat<T> >       &quatsIn)
         : rot (rotIn), quats (quatsIn) {}
 
+    size_t elementCost () const { return 32; }
+
     void execute (size_t start, size_t end)
     {
         for (size_t i = start; i < end; ++i)
@@ -912,10 +929,229 @@ QuatArray_quatConstructor1(const FixedArray<IMATH_NAMESPACE::Euler<T> > &e)
     return result;
 }
 
+template <class T>
+struct op_quatToMatrix33 {
+    static inline Matrix33<T> apply(const Quat<T> &q) { return q.toMatrix33(); }
+};
+
+template <class T>
+struct op_quatToMatrix44 {
+    static inline Matrix44<T> apply(const Quat<T> &q) { return q.toMatrix44(); }
+};
+
+template <class T> struct op_cost<op_quatToMatrix33<T> > { static const size_t value = 16; };
+template <class T> struct op_cost<op_quatToMatrix44<T> > { static const size_t value = 16; };
+
+template <class T>
+struct QuatArray_ExtractQuat : public Task
+{
+    const FixedArray<IMATH_NAMESPACE::Matrix44<T> > *m44;
+    const FixedArray<IMATH_NAMESPACE::Matrix33<T> > *m33;
+    FixedArray<IMATH_NAMESPACE::Quat<T> >           &result;
+
+    QuatArray_ExtractQuat (const FixedArray<IMATH_NAMESPACE::Matrix44<T> > *m44In,
+                           const FixedArray<IMATH_NAMESPACE::Matrix33<T> > *m33In,
+                           FixedArray<IMATH_NAMESPACE::Quat<T> >           &resultIn)
+        : m44 (m44In), m33 (m33In), result (resultIn) {}
+
+    size_t elementCost () const { return 32; }
+
+    void execute (size_t start, size_t end)
+    {
+        if (m44)
+        {
+            for (size_t i = start; i < end; ++i)
+                result[i] = IMATH_NAMESPACE::extractQuat ((*m44)[i]);
+        }
+        else
+        {
+            for (size_t i = start; i < end; ++i)
+                result[i] = IMATH_NAMESPACE::extractQuat (IMATH_NAMESPACE::Matrix44<T> ((*m33)[i], Vec3<T> (0)));
+        }
+    }
+};
+
+template <class T>
+static FixedArray<IMATH_NAMESPACE::Quat<T> > *
+QuatArray_quatConstructorM44(const FixedArray<IMATH_NAMESPACE::Matrix44<T> > &m)
+{
+    MATH_EXC_ON;
+    size_t len = m.len();
+    FixedArray<IMATH_NAMESPACE::Quat<T> >* result =
+        new FixedArray<IMATH_NAMESPACE::Quat<T> > (Py_ssize_t(len), UNINITIALIZED);
+
+    QuatArray_ExtractQuat<T> task (&m, 0, *result);
+    dispatchTask (task, len);
+    return result;
+}
+
+template <class T>
+static FixedArray<IMATH_NAMESPACE::Quat<T> > *
+QuatArray_quatConstructorM33(const FixedArray<IMATH_NAMESPACE::Matrix33<T> > &m)
+{
+    MATH_EXC_ON;
+    size_t len = m.len();
+    FixedArray<IMATH_NAMESPACE::Quat<T> >* result =
+        new FixedArray<IMATH_NAMESPACE::Quat<T> > (Py_ssize_t(len), UNINITIALIZED);
+
+    QuatArray_ExtractQuat<T> task (0, &m, *result);
+    dispatchTask (task, len);
+    return result;
+}
+
+template <class T>
+struct op_quatSlerp {
+    static inline Quat<T> apply(const Quat<T> &q, const Quat<T> &p, T t)
+    { return IMATH_NAMESPACE::slerp(q, p, t); }
+};
+
+template <class T>
+struct op_quatSlerpShortestArc {
+    static inline Quat<T> apply(const Quat<T> &q, const Quat<T> &p, T t)
+    { return IMATH_NAMESPACE::slerpShortestArc(q, p, t); }
+};
+
+template <class T>
+struct op_quatNormalize {
+    static inline void apply(Quat<T> &q) { q.normalize(); }
+};
+
+template <class T>
+struct op_quatNormalized {
+    static inline Quat<T> apply(const Quat<T> &q) { return q.normalized(); }
+};
+
+template <class T> struct op_cost<op_quatSlerp<T> >            { static const size_t value = 32; };
+template <class T> struct op_cost<op_quatSlerpShortestArc<T> > { static const size_t value = 32; };
+template <class T> struct op_cost<op_quatNormalize<T> >        { static const size_t value = 8; };
+template <class T> struct op_cost<op_quatNormalized<T> >       { static const size_t value = 8; };
+
+//
+// Spline interpolation through an array of rotation keys, one key per
+// unit of t.  The squad control points are computed once per call, then
+// each sample picks its segment from floor(t); t is clamped to the keys.
+//
+
+template <class T>
+struct QuatArray_Intermediate : public Task
+{
+    const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys;
+    FixedArray<IMATH_NAMESPACE::Quat<T> >       &result;
+
+    QuatArray_Intermediate (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keysIn,
+                            FixedArray<IMATH_NAMESPACE::Quat<T> >       &resultIn)
+        : keys (keysIn), result (resultIn) {}
+
+    size_t elementCost () const { return 64; }
+
+    void execute (size_t start, size_t end)
+    {
+        size_t last = keys.len() - 1;
+        for (size_t i = start; i < end; ++i)
+        {
+            result[i] = IMATH_NAMESPACE::intermediate (keys[i > 0 ? i-1 : 0],
+                                                       keys[i],
+                                                       keys[i < last ? i+1 : last]);
+        }
+    }
+};
+
+template <class T>
+static inline IMATH_NAMESPACE::Quat<T>
+squadSample (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys,
+             const FixedArray<IMATH_NAMESPACE::Quat<T> > &ctrl,
+             T t)
+{
+    size_t last = keys.len() - 1;
+    if (last == 0 || !(t > T(0)))
+        return keys[0];
+    if (t >= T(last))
+        return keys[last];
+
+    size_t i = size_t(t);
+    return IMATH_NAMESPACE::squad (keys[i], ctrl[i], ctrl[i+1], keys[i+1], t - T(i));
+}
+
+template <class T>
+struct QuatArray_Squad : public Task
+{
+    const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys;
+    const FixedArray<IMATH_NAMESPACE::Quat<T> > &ctrl;
+    const FixedArray<T>                         &t;
+    FixedArray<IMATH_NAMESPACE::Quat<T> >       &result;
+
+    QuatArray_Squad (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keysIn,
+                     const FixedArray<IMATH_NAMESPACE::Quat<T> > &ctrlIn,
+                     const FixedArray<T>                         &tIn,
+                     FixedArray<IMATH_NAMESPACE::Quat<T> >       &resultIn)
+        : keys (keysIn), ctrl (ctrlIn), t (tIn), result (resultIn) {}
+
+    size_t elementCost () const { return 96; }
+
+    void execute (size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            result[i] = squadSample (keys, ctrl, t[i]);
+    }
+};
+
+template <class T>
+static FixedArray<IMATH_NAMESPACE::Quat<T> >
+QuatArray_squadControlPoints (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys)
+{
+    size_t len = keys.len();
+    if (len == 0)
+        throw IEX_NAMESPACE::ArgExc ("squad requires at least one key");
+
+    FixedArray<IMATH_NAMESPACE::Quat<T> > ctrl (Py_ssize_t(len), UNINITIALIZED);
+    QuatArray_Intermediate<T> task (keys, ctrl);
+    dispatchTask (task, len);
+    return ctrl;
+}
+
+template <class T>
+static FixedArray<IMATH_NAMESPACE::Quat<T> >
+QuatArray_squad (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys,
+                 const FixedArray<T> &t)
+{
+    MATH_EXC_ON;
+    FixedArray<IMATH_NAMESPACE::Quat<T> > ctrl = QuatArray_squadControlPoints (keys);
+
+    size_t len = t.len();
+    FixedArray<IMATH_NAMESPACE::Quat<T> > result (Py_ssize_t(len), UNINITIALIZED);
+    QuatArray_Squad<T> task (keys, ctrl, t, result);
+    dispatchTask (task, len);
+    return result;
+}
+
+template <class T>
+static IMATH_NAMESPACE::Quat<T>
+QuatArray_squadScalar (const FixedArray<IMATH_NAMESPACE::Quat<T> > &keys, T t)
+{
+    MATH_EXC_ON;
+    size_t len = keys.len();
+    if (len == 0)
+        throw IEX_NAMESPACE::ArgExc ("squad requires at least one key");
+
+    size_t last = len - 1;
+    if (last == 0 || !(t > T(0)))
+        return keys[0];
+    if (t >= T(last))
+        return keys[last];
+
+    // only the two control points around t are needed
+    size_t i = size_t(t);
+    IMATH_NAMESPACE::Quat<T> a = IMATH_NAMESPACE::intermediate (keys[i > 0 ? i-1 : 0], keys[i], keys[i+1]);
+    IMATH_NAMESPACE::Quat<T> b = IMATH_NAMESPACE::intermediate (keys[i], keys[i+1], keys[std::min (i+2, last)]);
+    return IMATH_NAMESPACE::squad (keys[i], a, b, keys[i+1], t - T(i));
+}
+
 template <class T>
 py::class_<FixedArray<IMATH_NAMESPACE::Quat<T> > >
 register_QuatArray(py::module &m)
 {
+    using boost::mpl::true_;
+
     py::class_<FixedArray<IMATH_NAMESPACE::Quat<T> > > quatArray_class = FixedArray<IMATH_NAMESPACE::Quat<T> >::register_(m, "Fixed length array of IMATH_NAMESPACE::Quat");
     quatArray_class
         .def_property_readonly("r",&QuatArray_get<T,0>)
@@ -945,9 +1181,34 @@ register_QuatArray(py::module &m)
         .def("__rmul__", &QuatArray_rmulVec3<T>)
         .def("__rmul__", &QuatArray_rmulVec3Array<T>)
         .def(py::init(&QuatArray_quatConstructor1<T>))
+        .def(py::init(&QuatArray_quatConstructorM44<T>),
+             "QuatArray(m) -- the rotation of each 4x4 matrix of m")
+        .def(py::init(&QuatArray_quatConstructorM33<T>),
+             "QuatArray(m) -- the rotation of each 3x3 matrix of m")
+        ;
+
+    generate_member_bindings<op_quatToMatrix33<T> >(quatArray_class,"toMatrix33","convert each quat into a 3x3 rotation matrix");
+    generate_member_bindings<op_quatToMatrix44<T> >(quatArray_class,"toMatrix44","convert each quat into a 4x4 rotation matrix");
+
+    generate_member_bindings<op_quatSlerp<T>,true_,true_>(quatArray_class,"slerp",
+        "q.slerp(p,t) -- spherical linear interpolation from each quat of q to p "
+        "(a quat or an array of them) at t (a scalar or an array)",args("p","t"));
+    generate_member_bindings<op_quatSlerpShortestArc<T>,true_,true_>(quatArray_class,"slerpShortestArc",
+        "q.slerpShortestArc(p,t) -- like slerp, but interpolates along the shorter "
+        "of the two arcs between each pair",args("p","t"));
+    generate_member_bindings<op_quatNormalize<T> >(quatArray_class,"normalize","normalize each quat in place");
+    generate_member_bindings<op_quatNormalized<T> >(quatArray_class,"normalized","return a normalized copy of each quat");
+    quatArray_class
+        .def("squad", &QuatArray_squad<T>,
+             "keys.squad(t) -- spline interpolation through the rotation keys, one key per "
+             "unit of t, sampled at each value of the array t")
+        .def("squad", &QuatArray_squadScalar<T>,
+             "keys.squad(t) -- spline interpolation through the rotation keys, one key per "
+             "unit of t, sampled at t")
         ;
 
     add_comparison_functions(quatArray_class);
+    add_soa_functions(m, quatArray_class);
     decoratecopy(quatArray_class);
 
     return quatArray_class;
@@ -54,16 +54,16 @@ template <class T> inline IMATH_NAMESPACE::Vec3<T> operator * (const IMATH_NAMES
 
 template <class T> static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >
 operator *(const IMATH_NAMESPACE::Vec3<T> &va, const PyImath::FixedArray<IMATH_NAMESPACE::Quat<T> > &vb)
-{ size_t len = vb.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va * vb[i]; return f; }
+{ size_t len = vb.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va * vb[i]; return f; }
 
 template <class T> static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >
 operator *(const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &va, const IMATH_NAMESPACE::Quat<T> &vb)
-{ size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * vb; return f; }
+{ size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * vb; return f; }
 
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >
 operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &va, const PyImath::FixedArray<IMATH_NAMESPACE::Quat<T> > &vb)
-{ size_t len = va.match_dimension(vb); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * vb[i]; return f; }
+{ size_t len = va.match_dimension(vb); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * vb[i]; return f; }
 
 //
 
@@ -121,7 +121,7 @@ static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >
 hollowSphereRand(Rand &rand, int num)
 {
     MATH_EXC_ON;
-    PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >  retval(num);
+    PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >  retval(num, PyImath::UNINITIALIZED);
     for (int i=0; i<num; ++i) {
         retval[i] = IMATH_NAMESPACE::hollowSphereRand<IMATH_NAMESPACE::Vec3<T>,Rand>(rand);
     }
@@ -133,7 +133,7 @@ static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >
 solidSphereRand(Rand &rand, int num)
 {
     MATH_EXC_ON;
-    PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >  retval(num);
+    PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >  retval(num, PyImath::UNINITIALIZED);
     for (int i=0; i<num; ++i) {
         retval[i] = IMATH_NAMESPACE::solidSphereRand<IMATH_NAMESPACE::Vec3<T>,Rand>(rand);
     }
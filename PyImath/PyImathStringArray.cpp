@@ -35,6 +35,12 @@
 #include <PyImathStringArrayRegister.h>
 #include <PyImathStringArray.h>
 #include <PyImathExport.h>
+#include <PyImathTask.h>
+#include <PyImathFixedArrayReduce.h>
+#include <Iex.h>
+#include <vector>
+#include <cstring>
+#include <limits>
 
 namespace PyImath {
 
@@ -76,12 +82,155 @@ StringArrayT<T>* StringArrayT<T>::createFromRawArray(const T* rawArray, size_t l
     StringTableIndexArrayPtr indexArray(reinterpret_cast<StringTableIndex*>(new char[sizeof(StringTableIndex)*length]));
     StringTablePtr table(new StringTableT<T>);
 
+    table->intern(rawArray, length, indexArray.get());
+
+    return new StringArrayT<T>(*table, indexArray.get(), length, 1, indexArray, table);
+}
+
+template<class T>
+StringArrayT<T>* StringArrayT<T>::createFromList(const py::list &strings)
+{
+    size_t length = strings.size();
+    std::vector<T> values(length);
     for(size_t i=0; i<length; ++i)
-        indexArray[i] = table->intern(rawArray[i]);
+        values[i] = py::cast<T>(strings[i]);
+
+    return createFromRawArray(length ? &values[0] : 0, length);
+}
+
+//
+// Moving indices between string tables.  A remap vector, indexed by the
+// old code, gives the new code of each element.
+//
+
+static inline size_t codeOf(const StringTableIndex &i) { return i.index(); }
+static inline size_t codeOf(int i) { return size_t(i); }
+
+template <class Src, class Dst>
+struct StringArray_Remap : public Task
+{
+    const FixedArray<Src> &src;
+    const std::vector<Dst> &remap;
+    Dst *dst;
+
+    StringArray_Remap(const FixedArray<Src> &s, const std::vector<Dst> &r, Dst *d)
+        : src(s), remap(r), dst(d) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            dst[i] = remap[codeOf(src[i])];
+    }
+};
+
+template<class T>
+StringArrayT<T>* StringArrayT<T>::createFromDictionary(const py::list &strings, const FixedArray<int> &codes)
+{
+    typedef boost::shared_array<StringTableIndex> StringTableIndexArrayPtr;
+    typedef boost::shared_ptr<StringTableT<T> > StringTablePtr;
+
+    size_t numStrings = strings.size();
+    std::vector<T> values(numStrings);
+    for(size_t i=0; i<numStrings; ++i)
+        values[i] = py::cast<T>(strings[i]);
+
+    ArrayReduction<int> r = reduceArray<REDUCE_MIN|REDUCE_MAX>(codes);
+    if (r.count > 0 && (r.min < 0 || size_t(r.max) >= numStrings))
+        throw IEX_NAMESPACE::ArgExc("String dictionary code out of range");
+
+    // only the dictionary is interned; the codes are remapped, which is
+    // the identity unless the dictionary repeats a string
+    StringTablePtr table(new StringTableT<T>);
+    std::vector<StringTableIndex> remap(numStrings);
+    table->intern(numStrings ? &values[0] : 0, numStrings, numStrings ? &remap[0] : 0);
+
+    size_t length = codes.len();
+    StringTableIndexArrayPtr indexArray(reinterpret_cast<StringTableIndex*>(new char[sizeof(StringTableIndex)*length]));
+    StringArray_Remap<int,StringTableIndex> task(codes, remap, indexArray.get());
+    dispatchTask(task, length);
 
     return new StringArrayT<T>(*table, indexArray.get(), length, 1, indexArray, table);
 }
 
+template<class T>
+py::tuple
+StringArrayT<T>::toDictionary() const
+{
+    size_t length = len();
+
+    // number the strings the array uses, in table order
+    std::vector<int> remap(_table.size(), -1);
+    for (size_t i=0; i<length; ++i)
+        remap[(*this)[i].index()] = 0;
+
+    py::list strings;
+    size_t next = 0;
+    for (size_t j=0; j<remap.size(); ++j) {
+        if (remap[j] < 0)
+            continue;
+        if (next > size_t(std::numeric_limits<int>::max()))
+            throw IEX_NAMESPACE::ArgExc("Too many distinct strings for an IntArray of codes");
+        remap[j] = int(next++);
+        strings.append(_table.lookup(StringTableIndex(StringTableIndex::index_type(j))));
+    }
+
+    FixedArray<int> codes(length, UNINITIALIZED);
+    StringArray_Remap<StringTableIndex,int> task(*this, remap, length ? &codes.direct_index(0) : 0);
+    dispatchTask(task, length);
+
+    return py::make_tuple(strings, codes);
+}
+
+template<class T>
+StringArrayT<T>*
+StringArrayT<T>::concatenate(const StringArrayT<T> &other) const
+{
+    typedef boost::shared_array<StringTableIndex> StringTableIndexArrayPtr;
+    typedef boost::shared_ptr<StringTableT<T> > StringTablePtr;
+
+    size_t len0 = len();
+    size_t len1 = other.len();
+
+    StringTablePtr table(new StringTableT<T>(_table));
+    std::vector<StringTableIndex> remap = table->merge(&other._table == &_table ? *table : other._table);
+
+    StringTableIndexArrayPtr indexArray(reinterpret_cast<StringTableIndex*>(new char[sizeof(StringTableIndex)*(len0+len1)]));
+    for (size_t i=0; i<len0; ++i)
+        indexArray[i] = (*this)[i];
+
+    StringArray_Remap<StringTableIndex,StringTableIndex> task(other, remap, indexArray.get() + len0);
+    dispatchTask(task, len1);
+
+    return new StringArrayT<T>(*table, indexArray.get(), len0+len1, 1, indexArray, table);
+}
+
+// Split a buffer of separator terminated strings.  The last string
+// doesn't need a terminator.
+static StringArray*
+StringArray_createFromBuffer(const py::buffer &buffer, char separator)
+{
+    py::buffer_info info = buffer.request();
+    if (info.ndim > 1 || info.itemsize != 1)
+        throw IEX_NAMESPACE::ArgExc("StringArray.fromBuffer expects a one dimensional buffer of bytes");
+    if (info.ndim == 1 && info.strides[0] != 1)
+        throw IEX_NAMESPACE::ArgExc("StringArray.fromBuffer expects a contiguous buffer");
+
+    const char *data = static_cast<const char *>(info.ptr);
+    const char *end = data + info.size;
+
+    std::vector<std::string> values;
+    while (data < end)
+    {
+        const char *next = static_cast<const char *>(memchr(data, separator, end - data));
+        if (next == 0)
+            next = end;
+        values.push_back(std::string(data, next));
+        data = next + 1;
+    }
+
+    return StringArray::createFromRawArray(values.empty() ? 0 : &values[0], values.size());
+}
+
 template<class T>
 StringArrayT<T>::StringArrayT(StringTableT<T> &table, StringTableIndex *ptr, size_t length, size_t stride, boost::any tableHandle)
     : super(ptr,length,stride), _table(table), _tableHandle(tableHandle)
@@ -197,36 +346,154 @@ StringArrayT<T>::setitem_string_vector_mask(const FixedArray<int> &mask, const S
     }
 }
 
+//
+// Comparisons work on the interned indices rather than the strings.  A
+// scalar is looked up once, and an array with a different string table
+// is first translated into the other array's indices, so every compare
+// is between two StringTableIndex values.  Unmasked, unit stride arrays
+// go through a plain loop over the raw indices that compilers vectorize.
+//
+
+template <bool Equal>
+struct StringArray_CompareScalar : public Task
+{
+    const FixedArray<StringTableIndex> &a;
+    StringTableIndex v;
+    FixedArray<int> &result;
+
+    StringArray_CompareScalar(const FixedArray<StringTableIndex> &a_, StringTableIndex v_, FixedArray<int> &r)
+        : a(a_), v(v_), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        int *r = &result.direct_index(start);
+        if (!a.isMaskedReference() && a.stride() == 1)
+        {
+            const StringTableIndex *p = &a.direct_index(start);
+            for (size_t i = 0; i < end - start; ++i)
+                r[i] = (p[i] == v) == Equal;
+        }
+        else
+        {
+            for (size_t i = start; i < end; ++i)
+                r[i - start] = (a[i] == v) == Equal;
+        }
+    }
+};
+
+template <bool Equal>
+struct StringArray_CompareArrays : public Task
+{
+    const FixedArray<StringTableIndex> &a0;
+    const FixedArray<StringTableIndex> &a1;
+    FixedArray<int> &result;
+
+    StringArray_CompareArrays(const FixedArray<StringTableIndex> &x, const FixedArray<StringTableIndex> &y, FixedArray<int> &r)
+        : a0(x), a1(y), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        int *r = &result.direct_index(start);
+        if (!a0.isMaskedReference() && a0.stride() == 1 &&
+            !a1.isMaskedReference() && a1.stride() == 1)
+        {
+            const StringTableIndex *p0 = &a0.direct_index(start);
+            const StringTableIndex *p1 = &a1.direct_index(start);
+            for (size_t i = 0; i < end - start; ++i)
+                r[i] = (p0[i] == p1[i]) == Equal;
+        }
+        else
+        {
+            for (size_t i = start; i < end; ++i)
+                r[i - start] = (a0[i] == a1[i]) == Equal;
+        }
+    }
+};
+
+struct StringArray_Isin : public Task
+{
+    const FixedArray<StringTableIndex> &a;
+    const std::vector<char> &member;
+    FixedArray<int> &result;
+
+    StringArray_Isin(const FixedArray<StringTableIndex> &a_, const std::vector<char> &m, FixedArray<int> &r)
+        : a(a_), member(m), result(r) {}
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            result.direct_index(i) = member[a[i].index()];
+    }
+};
+
+// An index that no string table hands out, for strings a table lacks.
+static const StringTableIndex MissingIndex(~StringTableIndex::index_type(0));
+
+// a1's elements as indices into t0, or MissingIndex where t0 lacks the
+// string.  Each distinct index of a1 is looked up once.
 template<class T>
-FixedArray<int> operator == (const StringArrayT<T> &a0, const StringArrayT<T> &a1) {
-    size_t len = a0.match_dimension(a1);
-    FixedArray<int> f(len);
-    const StringTableT<T> &t0 = a0.stringTable();
+static FixedArray<StringTableIndex>
+translateIndices(const StringTableT<T> &t0, const StringArrayT<T> &a1)
+{
     const StringTableT<T> &t1 = a1.stringTable();
+    size_t len = a1.len();
+
+    FixedArray<StringTableIndex> result(len, UNINITIALIZED);
+    std::vector<StringTableIndex> cache(t1.size(), MissingIndex);
+    std::vector<char> cached(t1.size(), 0);
     for (size_t i=0;i<len;++i) {
-     f[i] = t0.lookup(a0[i])==t1.lookup(a1[i]); 
+        StringTableIndex::index_type j = a1[i].index();
+        if (!cached[j]) {
+            const T &s = t1.lookup(a1[i]);
+            if (t0.hasString(s))
+                cache[j] = t0.lookup(s);
+            cached[j] = 1;
+        }
+        result.direct_index(i) = cache[j];
+    }
+    return result;
+}
+
+template<class T, bool Equal>
+static FixedArray<int>
+compareArrays(const StringArrayT<T> &a0, const StringArrayT<T> &a1)
+{
+    size_t len = a0.match_dimension(a1);
+    FixedArray<int> f(len, UNINITIALIZED);
+    if (&a0.stringTable() == &a1.stringTable()) {
+        StringArray_CompareArrays<Equal> task(a0, a1, f);
+        dispatchTask(task, len);
+    } else {
+        FixedArray<StringTableIndex> b = translateIndices(a0.stringTable(), a1);
+        StringArray_CompareArrays<Equal> task(a0, b, f);
+        dispatchTask(task, len);
     }
     return f;
 }
 
-template<class T>
-FixedArray<int> operator == (const StringArrayT<T> &a0, const T &v1) {
+template<class T, bool Equal>
+static FixedArray<int>
+compareScalar(const StringArrayT<T> &a0, const T &v1)
+{
     size_t len = a0.len();
-    FixedArray<int> f(len);
+    FixedArray<int> f(len, UNINITIALIZED);
     const StringTableT<T> &t0 = a0.stringTable();
-    if (t0.hasString(v1)) {
-        StringTableIndex v1i = t0.lookup(v1);
-        for (size_t i=0;i<len;++i) {
-            f[i] = a0[i]==v1i;
-        }
-    } else {
-        for (size_t i=0;i<len;++i) {
-            f[i] = 0;
-        }
-    }
+    StringTableIndex v1i = t0.hasString(v1) ? t0.lookup(v1) : MissingIndex;
+    StringArray_CompareScalar<Equal> task(a0, v1i, f);
+    dispatchTask(task, len);
     return f;
 }
 
+template<class T>
+FixedArray<int> operator == (const StringArrayT<T> &a0, const StringArrayT<T> &a1) {
+    return compareArrays<T,true>(a0, a1);
+}
+
+template<class T>
+FixedArray<int> operator == (const StringArrayT<T> &a0, const T &v1) {
+    return compareScalar<T,true>(a0, v1);
+}
+
 template<class T>
 FixedArray<int> operator == (const T &v1,const StringArrayT<T> &a0) {
     return a0 == v1;
@@ -234,32 +501,12 @@ FixedArray<int> operator == (const T &v1,const StringArrayT<T> &a0) {
 
 template<class T>
 FixedArray<int> operator != (const StringArrayT<T> &a0, const StringArrayT<T> &a1) {
-    size_t len = a0.match_dimension(a1);
-    FixedArray<int> f(len);
-    const StringTableT<T> &t0 = a0.stringTable();
-    const StringTableT<T> &t1 = a1.stringTable();
-    for (size_t i=0;i<len;++i) {
-        f[i] = t0.lookup(a0[i])!=t1.lookup(a1[i]); 
-    }
-    return f;
+    return compareArrays<T,false>(a0, a1);
 }
 
 template<class T>
 FixedArray<int> operator != (const StringArrayT<T> &a0, const T &v1) {
-    size_t len = a0.len();
-    FixedArray<int> f(len);
-    const StringTableT<T> &t0 = a0.stringTable();
-    if (t0.hasString(v1)) {
-        StringTableIndex v1i = t0.lookup(v1);
-        for (size_t i=0;i<len;++i) {
-            f[i] = a0[i]!=v1i;
-        }
-    } else {
-        for (size_t i=0;i<len;++i) {
-            f[i] = 1;
-        }
-    }
-    return f;
+    return compareScalar<T,false>(a0, v1);
 }
 
 template<class T>
@@ -267,6 +514,40 @@ FixedArray<int> operator != (const T &v1,const StringArrayT<T> &a0) {
     return a0 != v1;
 }
 
+template<class T>
+FixedArray<int>
+StringArrayT<T>::isin(const StringArrayT<T> &strings) const
+{
+    std::vector<char> member(_table.size(), 0);
+    FixedArray<StringTableIndex> b = translateIndices(_table, strings);
+    for (size_t i=0;i<b.len();++i) {
+        if (b[i] != MissingIndex)
+            member[b[i].index()] = 1;
+    }
+
+    FixedArray<int> f(len(), UNINITIALIZED);
+    StringArray_Isin task(*this, member, f);
+    dispatchTask(task, len());
+    return f;
+}
+
+template<class T>
+FixedArray<int>
+StringArrayT<T>::isin(const py::iterable &strings) const
+{
+    std::vector<char> member(_table.size(), 0);
+    for (py::handle item : strings) {
+        T s = py::cast<T>(item);
+        if (_table.hasString(s))
+            member[_table.lookup(s).index()] = 1;
+    }
+
+    FixedArray<int> f(len(), UNINITIALIZED);
+    StringArray_Isin task(*this, member, f);
+    dispatchTask(task, len());
+    return f;
+}
+
 template<> PYIMATH_EXPORT StringTableIndex FixedArrayDefaultValue<StringTableIndex>::value() { return StringTableIndex(0); }
 template<> PYIMATH_EXPORT const char*      FixedArray<StringTableIndex>::name() { return "StringTableArray"; }
 
@@ -297,6 +578,13 @@ void register_StringArrays(py::module &m)
     string_array_class
         .def(py::init(&StringArray::createDefaultArray))
         .def(py::init(&StringArray::createUniformArray))
+        .def(py::init(&StringArray::createFromList),
+             "construct from a list of strings")
+        .def_static("fromDictionary", &StringArray::createFromDictionary,
+             "fromDictionary(strings, codes) -- construct from a list of strings and an IntArray of positions in that list")
+        .def_static("fromBuffer", &StringArray_createFromBuffer,
+             "fromBuffer(buffer, separator='\\0') -- construct from a buffer of bytes holding separator terminated strings",
+             py::arg("buffer"), py::arg("separator") = '\0')
         //.def("__getitem__", &StringArray::getslice_string, return_value_policy<manage_new_object>()) 
         .def("__getitem__", &StringArray::getitem_string) 
         .def("__setitem__", &StringArray::setitem_string_scalar)
@@ -305,11 +593,17 @@ void register_StringArrays(py::module &m)
         .def("__setitem__", &StringArray::setitem_string_vector_mask)
         .def("__len__",&StringArray::len)
         .def(py::self == py::self)
-        //.def(py::self == py::other<std::string>())
-        //.def(py::other<std::string>() == py::self)
+        .def(py::self == std::string())
         .def(py::self != py::self)
-        //.def(py::self != py::other<std::string>())
-        //.def(py::other<std::string>() != py::self)
+        .def(py::self != std::string())
+        .def("isin", (FixedArray<int> (StringArray::*)(const StringArray &) const) &StringArray::isin,
+             "isin(strings) -- an IntArray that is 1 for each element that is in the StringArray strings")
+        .def("isin", (FixedArray<int> (StringArray::*)(const py::iterable &) const) &StringArray::isin,
+             "isin(strings) -- an IntArray that is 1 for each element that is one of the given strings")
+        .def("toDictionary", &StringArray::toDictionary,
+             "toDictionary() -- a tuple of the distinct strings of the array and an IntArray of each element's position in them")
+        .def("concatenate", &StringArray::concatenate,
+             "concatenate(other) -- a new StringArray with the elements of this array followed by those of other")
         ;
 
     py::class_<WstringArray> wstring_array_class =
@@ -317,6 +611,10 @@ void register_StringArrays(py::module &m)
     wstring_array_class
         .def(py::init(&WstringArray::createDefaultArray))
         .def(py::init(&WstringArray::createUniformArray))
+        .def(py::init(&WstringArray::createFromList),
+             "construct from a list of strings")
+        .def_static("fromDictionary", &WstringArray::createFromDictionary,
+             "fromDictionary(strings, codes) -- construct from a list of strings and an IntArray of positions in that list")
         //.def("__getitem__", &WstringArray::getslice_string, return_value_policy<manage_new_object>()) 
         .def("__getitem__", &WstringArray::getitem_string) 
         .def("__setitem__", &WstringArray::setitem_string_scalar)
@@ -325,11 +623,17 @@ void register_StringArrays(py::module &m)
         .def("__setitem__", &WstringArray::setitem_string_vector_mask)
         .def("__len__",&WstringArray::len)
         .def(py::self == py::self)
-        //.def(py::self == other<std::wstring>())
-        //.def(other<std::wstring>() == self)
+        .def(py::self == std::wstring())
         .def(py::self != py::self)
-        //.def(self != other<std::wstring>())
-        //.def(other<std::wstring>() != self)
+        .def(py::self != std::wstring())
+        .def("isin", (FixedArray<int> (WstringArray::*)(const WstringArray &) const) &WstringArray::isin,
+             "isin(strings) -- an IntArray that is 1 for each element that is in the WstringArray strings")
+        .def("isin", (FixedArray<int> (WstringArray::*)(const py::iterable &) const) &WstringArray::isin,
+             "isin(strings) -- an IntArray that is 1 for each element that is one of the given strings")
+        .def("toDictionary", &WstringArray::toDictionary,
+             "toDictionary() -- a tuple of the distinct strings of the array and an IntArray of each element's position in them")
+        .def("concatenate", &WstringArray::concatenate,
+             "concatenate(other) -- a new WstringArray with the elements of this array followed by those of other")
         ;
 }
 
@@ -56,6 +56,8 @@ class StringArrayT : public FixedArray<StringTableIndex>
     static StringArrayT<T>* createDefaultArray(size_t length);
     static StringArrayT<T>* createUniformArray(const T& initialValue, size_t length);
     static StringArrayT<T>* createFromRawArray(const T* rawArray, size_t length);
+    static StringArrayT<T>* createFromList(const py::list &strings);
+    static StringArrayT<T>* createFromDictionary(const py::list &strings, const FixedArray<int> &codes);
 
     StringArrayT(StringTableT<T> &table, StringTableIndex *ptr, size_t length, size_t stride = 1, boost::any tableHandle = boost::any());
 
@@ -72,6 +74,18 @@ class StringArrayT : public FixedArray<StringTableIndex>
     void setitem_string_vector(py::object index, const StringArrayT<T> &data);
     void setitem_string_vector_mask(const FixedArray<int> &mask, const StringArrayT<T> &data);
 
+    // 1 for each element that is one of the given strings
+    FixedArray<int> isin(const StringArrayT<T> &strings) const;
+    FixedArray<int> isin(const py::iterable &strings) const;
+
+    // the distinct strings of the array in string table order, and the
+    // position of each element's string in that list
+    py::tuple toDictionary() const;
+
+    // a new array holding the elements of this array followed by those of
+    // other, with a string table merged from both
+    StringArrayT* concatenate(const StringArrayT<T> &other) const;
+
   private:
     typedef StringArrayT<T>     this_type;
 
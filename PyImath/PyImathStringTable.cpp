@@ -33,91 +33,361 @@
 ///////////////////////////////////////////////////////////////////////////
 
 #include <PyImathStringTable.h>
+#include <PyImathTask.h>
+#include <PyImathUtil.h>
 #include <Iex.h>
 #include <limits>
+#include <functional>
 #include <PyImathExport.h>
 
 namespace PyImath {
 
+static const size_t InitialSlots = 16;
+
+template<class T>
+StringTableT<T>::StringTableT()
+{
+    Slot empty = { 0, EmptySlot };
+    _slots.assign(InitialSlots, empty);
+}
+
+template<class T>
+size_t
+StringTableT<T>::hash(const T &s)
+{
+    return std::hash<T>()(s);
+}
+
+// The slot holding s, or the empty slot where it would go.
+template<class T>
+size_t
+StringTableT<T>::findSlot(const T &s, size_t h) const
+{
+    size_t mask = _slots.size() - 1;
+    for (size_t pos = h & mask; ; pos = (pos + 1) & mask)
+    {
+        const Slot &slot = _slots[pos];
+        if (slot.index == EmptySlot)
+            return pos;
+        if (slot.hash == h && _strings[slot.index] == s)
+            return pos;
+    }
+}
+
+// Make room for count entries while keeping the slots at most half full.
+template<class T>
+void
+StringTableT<T>::reserve(size_t count)
+{
+    size_t capacity = _slots.size();
+    while (capacity < 2 * count)
+        capacity *= 2;
+    if (capacity == _slots.size())
+        return;
+
+    Slot empty = { 0, EmptySlot };
+    std::vector<Slot> slots(capacity, empty);
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        const Slot &slot = _slots[i];
+        if (slot.index == EmptySlot)
+            continue;
+
+        size_t pos = slot.hash & mask;
+        while (slots[pos].index != EmptySlot)
+            pos = (pos + 1) & mask;
+        slots[pos] = slot;
+    }
+    _slots.swap(slots);
+}
+
+// Append s, which must not be in the table yet.
 template<class T>
 StringTableIndex
-StringTableT<T>::lookup(const T &s) const
+StringTableT<T>::insert(const T &s, size_t h)
 {
-    typedef typename Table::template nth_index<1>::type StringSet;
-    const StringSet &strings = _table.template get<1>();
+    size_t next_index = _strings.size();
+    if (next_index >= size_t(EmptySlot)) {
+        throw IEX_NAMESPACE::ArgExc("Unable to intern string - string table would exceed maximum size");
+    }
+
+    reserve(next_index + 1);
+    Slot &slot = _slots[findSlot(s, h)];
+    slot.hash = h;
+    slot.index = index_type(next_index);
+    _strings.push_back(s);
 
-    typename StringSet::const_iterator it = strings.find(s);
-    if (it == strings.end()) {
+    return StringTableIndex(index_type(next_index));
+}
+
+template<class T>
+StringTableIndex
+StringTableT<T>::lookup(const T &s) const
+{
+    const Slot &slot = _slots[findSlot(s, hash(s))];
+    if (slot.index == EmptySlot) {
         throw IEX_NAMESPACE::ArgExc("String table access out of bounds");
     }
 
-    return it->i;
+    return StringTableIndex(slot.index);
 }
 
 template<class T>
 const T &
 StringTableT<T>::lookup(StringTableIndex index) const
 {
-    typedef typename Table::template nth_index<0>::type IndexSet;
-    const IndexSet &indices = _table.template get<0>();
-
-    typename IndexSet::const_iterator it = indices.find(index);
-    if (it == indices.end()) {
+    if (index.index() >= _strings.size()) {
         throw IEX_NAMESPACE::ArgExc("String table access out of bounds");
     }
 
-    return it->s;
+    return _strings[index.index()];
 }
 
 template<class T>
 StringTableIndex
 StringTableT<T>::intern(const T &s)
 {
-    typedef typename Table::template nth_index<1>::type StringSet;
-    const StringSet &strings = _table.template get<1>();
+    size_t h = hash(s);
+    const Slot &slot = _slots[findSlot(s, h)];
+    if (slot.index == EmptySlot) {
+        return insert(s, h);
+    }
+
+    return StringTableIndex(slot.index);
+}
+
+//
+// Batch interning runs in four passes:
+//
+//  - in parallel, hash every string;
+//  - serially, look each one up in the table as it was before the call;
+//  - in parallel over shards of the hash space, find the first
+//    occurrence of every string that wasn't found;
+//  - serially, append those first occurrences in input order and copy
+//    their indices to the repeats.
+//
+// The parallel passes only read the input, so they may run without the
+// python lock; the table itself is only read and written with the lock
+// held, by the serial passes.
+//
+
+static const size_t NotPending = ~size_t(0);
+static const size_t ShardCount = 64;
+
+static inline size_t
+shardOf(size_t h)
+{
+    // the table's slots use the low bits of the hash
+    return (h >> 16) & (ShardCount - 1);
+}
+
+// Random access to the strings of a plain array.
+template<class T>
+struct StringTable_ArrayStrings
+{
+    const T *strings;
+    StringTable_ArrayStrings(const T *s) : strings(s) {}
+    const T & operator [] (size_t i) const { return strings[i]; }
+};
+
+// Random access to strings held elsewhere, through their addresses.
+template<class T>
+struct StringTable_PointerStrings
+{
+    std::vector<const T *> strings;
+    const T & operator [] (size_t i) const { return *strings[i]; }
+};
+
+template<class T, class Strings>
+struct StringTable_HashTask : public Task
+{
+    const Strings &strings;
+    std::vector<size_t> &hashes;
+
+    StringTable_HashTask(const Strings &s, std::vector<size_t> &h)
+        : strings(s), hashes(h) {}
+
+    size_t elementCost() const { return 32; }
+
+    void execute(size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+            hashes[i] = StringTableT<T>::hash(strings[i]);
+    }
+};
+
+template<class T, class Strings>
+struct StringTable_ShardTask : public Task
+{
+    const Strings &strings;
+    const std::vector<size_t> &hashes;
+    const std::vector<size_t> &pending;
+    const std::vector<size_t> &offsets;
+    std::vector<size_t> &first;
+
+    StringTable_ShardTask(const Strings &s, const std::vector<size_t> &h,
+                          const std::vector<size_t> &p, const std::vector<size_t> &o,
+                          std::vector<size_t> &f)
+        : strings(s), hashes(h), pending(p), offsets(o), first(f) {}
+
+    // each element is a whole shard
+    size_t elementCost() const { return 32 * (pending.size() / ShardCount + 1); }
+
+    void execute(size_t start, size_t end)
+    {
+        std::vector<size_t> slots;
+        for (size_t shard = start; shard < end; ++shard)
+        {
+            size_t begin = offsets[shard];
+            size_t count = offsets[shard + 1] - begin;
+            if (count == 0)
+                continue;
+
+            size_t capacity = InitialSlots;
+            while (capacity < 2 * count)
+                capacity *= 2;
+            size_t mask = capacity - 1;
+            slots.assign(capacity, NotPending);
+
+            // pending is in input order within a shard, so the slot
+            // always holds the first occurrence
+            for (size_t j = begin; j < begin + count; ++j)
+            {
+                size_t i = pending[j];
+                size_t h = hashes[i];
+                for (size_t pos = h & mask; ; pos = (pos + 1) & mask)
+                {
+                    size_t k = slots[pos];
+                    if (k == NotPending)
+                    {
+                        slots[pos] = i;
+                        break;
+                    }
+                    if (hashes[k] == h && strings[k] == strings[i])
+                    {
+                        first[i] = k;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
+template<class T>
+template<class Strings>
+void
+StringTableT<T>::internStrings(const Strings &strings, size_t length, StringTableIndex *result)
+{
+    std::vector<size_t> hashes(length);
+    std::vector<size_t> first(length);
 
-    typename StringSet::const_iterator it = strings.find(s);
-    if (it == strings.end()) {
-        size_t next_index = _table.size();
-        if (next_index > std::numeric_limits<StringTableIndex::index_type>::max()) {
-            throw IEX_NAMESPACE::ArgExc("Unable to intern string - string table would exceed maximum size");
+    StringTable_HashTask<T,Strings> hashTask(strings, hashes);
+    dispatchTask(hashTask, length);
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        const Slot &slot = _slots[findSlot(strings[i], hashes[i])];
+        if (slot.index == EmptySlot)
+        {
+            first[i] = i;
+        }
+        else
+        {
+            first[i] = NotPending;
+            result[i] = StringTableIndex(slot.index);
         }
-        StringTableIndex index = StringTableIndex(StringTableIndex::index_type(next_index));
-        _table.insert(StringTableEntry<T>(index,s));
-        return index;
     }
 
-    return it->i;
+    std::vector<size_t> offsets(ShardCount + 1, 0);
+    for (size_t i = 0; i < length; ++i)
+        if (first[i] != NotPending)
+            ++offsets[shardOf(hashes[i]) + 1];
+    for (size_t s = 0; s < ShardCount; ++s)
+        offsets[s + 1] += offsets[s];
+
+    size_t numPending = offsets[ShardCount];
+    if (numPending == 0)
+        return;
+
+    std::vector<size_t> pending(numPending);
+    {
+        std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < length; ++i)
+            if (first[i] != NotPending)
+                pending[fill[shardOf(hashes[i])]++] = i;
+    }
+
+    StringTable_ShardTask<T,Strings> shardTask(strings, hashes, pending, offsets, first);
+    dispatchTask(shardTask, ShardCount);
+
+    size_t numNew = 0;
+    for (size_t i = 0; i < length; ++i)
+        numNew += first[i] == i;
+    reserve(_strings.size() + numNew);
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (first[i] == NotPending)
+            continue;
+
+        if (first[i] == i)
+            result[i] = insert(strings[i], hashes[i]);
+        else
+            result[i] = result[first[i]];
+    }
+}
+
+template<class T>
+void
+StringTableT<T>::intern(const T *strings, size_t length, StringTableIndex *result)
+{
+    internStrings(StringTable_ArrayStrings<T>(strings), length, result);
+}
+
+template<class T>
+std::vector<StringTableIndex>
+StringTableT<T>::merge(const StringTableT<T> &other)
+{
+    std::vector<StringTableIndex> remap(other.size());
+    if (&other == this) {
+        for (size_t i = 0; i < remap.size(); ++i)
+            remap[i] = StringTableIndex(index_type(i));
+        return remap;
+    }
+
+    // other may be changed by another python thread while the parallel
+    // passes run, so they work from the addresses of its strings, which
+    // stay put as it grows
+    StringTable_PointerStrings<T> strings;
+    strings.strings.reserve(remap.size());
+    for (size_t i = 0; i < remap.size(); ++i)
+        strings.strings.push_back(&other._strings[i]);
+
+    internStrings(strings, remap.size(), remap.empty() ? 0 : &remap[0]);
+    return remap;
 }
 
 template<class T>
 size_t
 StringTableT<T>::size() const
 {
-    return _table.size();
+    return _strings.size();
 }
 
 template<class T>
 bool
 StringTableT<T>::hasString(const T &s) const
 {
-    typedef typename Table::template nth_index<1>::type StringSet;
-    const StringSet &strings = _table.template get<1>();
-    return strings.find(s) != strings.end();
+    return _slots[findSlot(s, hash(s))].index != EmptySlot;
 }
 
 template<class T>
 bool
 StringTableT<T>::hasStringIndex(const StringTableIndex &s) const
 {
-    typedef typename Table::template nth_index<0>::type IndexSet;
-    const IndexSet &indices = _table.template get<0>();
-    return indices.find(s) != indices.end();
-}
-
-namespace {
-template class PYIMATH_EXPORT StringTableDetailT<std::string>;
-template class PYIMATH_EXPORT StringTableDetailT<std::wstring>;
+    return s.index() < _strings.size();
 }
 
 template class PYIMATH_EXPORT StringTableT<std::string>;
@@ -36,11 +36,10 @@
 #define _PyImathStringTable_h_
 
 #include <string>
+#include <deque>
+#include <vector>
 #include <stdint.h>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/identity.hpp>
-#include <boost/multi_index/member.hpp>
+#include <boost/type_traits/is_pod.hpp>
 
 namespace PyImath {
 
@@ -100,51 +99,26 @@ namespace boost {
 
 namespace PyImath {
 
-//
-// A string table entry containing a unique index and string
-template<class T>
-struct StringTableEntry
-{
-    StringTableEntry(StringTableIndex ii,const T &ss) : i(ii), s(ss) {}
-    StringTableIndex i;
-    T                s;
-};
-
-namespace {
-
-using boost::multi_index_container;
-using namespace boost::multi_index;
-
-//
-// A map data structure for string strings.
-// It exposes two index types : StringTableIndex and string
-//
-template<class T>
-class StringTableDetailT {
-    public:
-    typedef boost::multi_index_container<
-        StringTableEntry<T>,
-        indexed_by<
-            ordered_unique<member<StringTableEntry<T>,StringTableIndex,&StringTableEntry<T>::i> >,
-            ordered_unique<member<StringTableEntry<T>,T,&StringTableEntry<T>::s> >
-        > 
-    > StringTableContainer;
-};
-
-} // namespace
-
-typedef StringTableDetailT<std::string> StringTableDetail;
-typedef StringTableDetailT<std::wstring> WStringTableDetail;
-
 //
 // Storage class for storing unique string elements.
 //
+// The strings live in a deque, which keeps their addresses stable and
+// gives constant time lookup by index.  Lookup by value goes through an
+// open addressing hash table of indices that also caches each string's
+// hash, so a probe only compares strings whose hashes match.
+//
+// The table is not safe to modify from several threads.  The array form
+// of intern() hashes and de-duplicates its input in parallel, in shards
+// by hash, and only looks up and appends strings serially, with the
+// python lock held.
 //
 template<class T>
 class StringTableT
 {
   public:
 
+    StringTableT();
+
     // look up a string table entry either by value or index
     StringTableIndex    lookup(const T &s) const;
     const T &           lookup(StringTableIndex index) const;
@@ -152,14 +126,46 @@ class StringTableT
     // return the index to a string table entry, adding if not found
     StringTableIndex    intern(const T &i);
 
+    // intern length strings and write their indices to result.  New
+    // strings are numbered in the order they first appear, the same as
+    // interning them one at a time.
+    void                intern(const T *strings, size_t length, StringTableIndex *result);
+
+    // intern every string of other and return, for each of other's
+    // indices, the index of the same string in this table
+    std::vector<StringTableIndex> merge(const StringTableT<T> &other);
+
     size_t              size() const;
     bool                hasString(const T &s) const;
     bool                hasStringIndex(const StringTableIndex &s) const;
     
   private:
 
-    typedef typename StringTableDetailT<T>::StringTableContainer Table;
-    Table _table;
+    typedef StringTableIndex::index_type index_type;
+
+    struct Slot
+    {
+        size_t      hash;
+        index_type  index;
+    };
+
+    // index_type's maximum marks an empty slot, so it is never handed out
+    static const index_type EmptySlot = ~index_type(0);
+
+    static size_t       hash(const T &s);
+
+    size_t              findSlot(const T &s, size_t h) const;
+    StringTableIndex    insert(const T &s, size_t h);
+    void                reserve(size_t count);
+
+    template <class Strings>
+    void                internStrings(const Strings &strings, size_t length, StringTableIndex *result);
+
+    std::deque<T>       _strings;
+    std::vector<Slot>   _slots;
+
+    template <class S, class Strings> friend struct StringTable_HashTask;
+    template <class S, class Strings> friend struct StringTable_ShardTask;
 };
 
 typedef StringTableT<std::string> StringTable;
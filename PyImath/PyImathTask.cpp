@@ -32,12 +32,18 @@
 //
 ///////////////////////////////////////////////////////////////////////////
 
+#include "python_include.h"
 #include <PyImathTask.h>
+#include <PyImathUtil.h>
+#include <algorithm>
 
 namespace PyImath {
 
 static WorkerPool *_currentPool = 0;
 
+static size_t _serialThreshold = 32768;
+static size_t _minChunkCost = 8192;
+
 WorkerPool *
 WorkerPool::currentPool()
 {
@@ -50,13 +56,108 @@ WorkerPool::setCurrentPool(WorkerPool *pool)
     _currentPool = pool;
 }
 
+size_t
+serialThreshold()
+{
+    return _serialThreshold;
+}
+
+void
+setSerialThreshold(size_t cost)
+{
+    _serialThreshold = cost;
+}
+
+size_t
+minChunkCost()
+{
+    return _minChunkCost;
+}
+
+void
+setMinChunkCost(size_t cost)
+{
+    _minChunkCost = cost > 0 ? cost : 1;
+}
+
+size_t
+chooseGrain(const Task &task,size_t length,size_t numWorkers)
+{
+    size_t cost = task.elementCost();
+    if (cost < 1) cost = 1;
+
+    if (numWorkers < 2 || length < 2 || length * cost < _serialThreshold)
+        return length;
+
+    // enough chunks to keep every worker busy, but none cheaper
+    // than the minimum chunk cost or smaller than the task allows
+    size_t grain = (length + numWorkers * chunksPerWorker - 1) / (numWorkers * chunksPerWorker);
+
+    size_t minElements = (_minChunkCost + cost - 1) / cost;
+    if (grain < minElements) grain = minElements;
+    if (grain < task.minGrain()) grain = task.minGrain();
+
+    return grain;
+}
+
+bool
+worthReleasingLock(size_t cost)
+{
+    return cost >= _serialThreshold;
+}
+
+namespace {
+
+// Runs a task in chunks of grain elements, one chunk per element of the
+// range it is dispatched over.
+struct GrainedTask : public Task
+{
+    Task &task;
+    size_t length;
+    size_t grain;
+
+    GrainedTask(Task &t,size_t l,size_t g) : task(t), length(l), grain(g) {}
+
+    void execute(size_t start,size_t end) { execute(start,end,0); }
+
+    void execute(size_t start,size_t end,int tid)
+    {
+        for (size_t c = start; c < end; ++c)
+            task.execute(c*grain,std::min(length,(c+1)*grain),tid);
+    }
+
+    size_t elementCost() const { return task.elementCost() * grain; }
+};
+
+} // namespace
+
+void
+WorkerPool::dispatch(Task &task,size_t length,size_t grain)
+{
+    if (grain < 1) grain = 1;
+    GrainedTask chunks(task,length,grain);
+    dispatch(chunks,(length + grain - 1) / grain);
+}
+
 void
 dispatchTask(Task &task,size_t length)
 {
-    if (WorkerPool::currentPool() && !WorkerPool::currentPool()->inWorkerThread())
-        WorkerPool::currentPool()->dispatch(task,length);
-    else
-        task.execute(0,length,0);
+    // tasks only touch c++ data, so let other python threads run
+    // while a large enough one executes
+    PyReleaseLock pyunlock(worthReleasingLock(length * task.elementCost()));
+
+    WorkerPool *pool = WorkerPool::currentPool();
+    if (pool && !pool->inWorkerThread())
+    {
+        size_t grain = chooseGrain(task,length,pool->workers());
+        if (grain < length)
+        {
+            pool->dispatch(task,length,grain);
+            return;
+        }
+    }
+
+    task.execute(0,length,0);
 }
 
 
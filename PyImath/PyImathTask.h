@@ -45,6 +45,15 @@ struct PYIMATH_EXPORT Task
     virtual ~Task() {}
     virtual void execute(size_t start,size_t end) = 0;
     virtual void execute(size_t start,size_t end, int tid) {execute(start,end);}
+
+    // Rough cost of processing one element, relative to a single
+    // arithmetic op on a scalar.  dispatchTask() uses this to decide
+    // whether a range is worth splitting and how big each chunk is.
+    virtual size_t elementCost() const {return 1;}
+
+    // Smallest number of elements a chunk may hold, for tasks whose
+    // per-chunk setup is expensive.  0 leaves it to the scheduler.
+    virtual size_t minGrain() const {return 0;}
 };
 
 struct PYIMATH_EXPORT WorkerPool
@@ -54,13 +63,44 @@ struct PYIMATH_EXPORT WorkerPool
     virtual void dispatch(Task &task,size_t length) = 0;
     virtual bool inWorkerThread() const = 0;
 
+    // Dispatch in chunks of grain elements, as chosen by the caller.
+    // The default hands the chunks to dispatch(task,length) as units
+    // of work; pools that split ranges themselves override it.
+    virtual void dispatch(Task &task,size_t length,size_t grain);
+
     static WorkerPool *currentPool();
     static void setCurrentPool(WorkerPool *pool);
 };
 
 PYIMATH_EXPORT void dispatchTask(Task &task,size_t length);
+
+// Chunks dealt out per worker, so that a worker that falls behind
+// leaves enough work behind for the others to take over.
+static const size_t chunksPerWorker = 8;
+
 PYIMATH_EXPORT size_t workers();
 
+//
+// Scheduling parameters for dispatchTask(), both in units of
+// Task::elementCost().  A range whose total cost is below the serial
+// threshold runs on the calling thread; otherwise it is cut into
+// chunks of at least the minimum chunk cost, and into enough chunks
+// that each worker gets several.
+//
+PYIMATH_EXPORT size_t serialThreshold();
+PYIMATH_EXPORT void setSerialThreshold(size_t cost);
+PYIMATH_EXPORT size_t minChunkCost();
+PYIMATH_EXPORT void setMinChunkCost(size_t cost);
+
+// The chunk size dispatchTask() would use for task over length
+// elements on numWorkers workers; length or more means run serially.
+PYIMATH_EXPORT size_t chooseGrain(const Task &task,size_t length,size_t numWorkers);
+
+// Whether work of the given cost is big enough to be worth releasing
+// the python lock for.  dispatchTask() releases it around every task
+// that passes this test, using the serial threshold as the cut off.
+PYIMATH_EXPORT bool worthReleasingLock(size_t cost);
+
 }
 
 #endif
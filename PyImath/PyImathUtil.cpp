@@ -49,29 +49,23 @@ PyAcquireLock::~PyAcquireLock()
     PyGILState_Release(_gstate);
 }
 
-#ifdef PLATFORM_LINUX
-// On Windows, this extern is not needed and produces a symbol mismatch at link time.
-// We should verify that it's still needed on Linux for Python 2.6.
-extern "C" PyThreadState *_PyThreadState_Current;
-#endif
-
 static bool
 pyHaveLock()
 {
-    // This is very much dependent on the current Python
-    // implementation of this functionality.  If we switch versions of
-    // Python and the implementation changes, we'll have to change
-    // this code as well and introduce a #define for the Python
-    // version.
-    
     if (!Py_IsInitialized())
 	throw IEX_NAMESPACE::LogicExc("PyReleaseLock called without the interpreter initialized");
 
+#if PY_VERSION_HEX >= 0x03040000
+    // PyGILState_Check is the supported way to ask this question, and
+    // doesn't depend on the interpreter's private thread state symbols.
+    return PyGILState_Check() != 0;
+#else
     PyThreadState *myThreadState = PyGILState_GetThisThreadState();
 
     // If the interpreter is initialized the gil is held if the
     // current thread's thread state is the current thread state
     return myThreadState != 0 && myThreadState == _PyThreadState_Current;
+#endif
 }
 
 PyReleaseLock::PyReleaseLock()
@@ -84,6 +78,16 @@ PyReleaseLock::PyReleaseLock()
         _save = 0;
 }
 
+PyReleaseLock::PyReleaseLock(bool release)
+{
+    // as above, but also a no-op when not asked to release or when
+    // called from c++ without an interpreter at all
+    if (release && Py_IsInitialized() && pyHaveLock())
+        _save = PyEval_SaveThread();
+    else
+        _save = 0;
+}
+
 PyReleaseLock::~PyReleaseLock()
 {
     if (_save != 0)
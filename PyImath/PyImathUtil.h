@@ -78,11 +78,15 @@ class PYIMATH_EXPORT PyAcquireLock
  * safe c++ functions called from python.  This call is designed to be
  * instantiated while an AcquireLock is in effect (nested).
  *
+ * The bool constructor only releases the lock if asked to, so that callers
+ * can skip the release and re-acquire for small amounts of work.
+ *
  */
 class PYIMATH_EXPORT PyReleaseLock
 {
   public:
     PyReleaseLock();
+    explicit PyReleaseLock(bool release);
     ~PyReleaseLock();
   private:
     PyThreadState *_save;
@@ -48,6 +48,7 @@ typedef FixedArray<IMATH_NAMESPACE::V2s>  V2sArray;
 typedef FixedArray<IMATH_NAMESPACE::V2i>  V2iArray;
 typedef FixedArray<IMATH_NAMESPACE::V2f>  V2fArray;
 typedef FixedArray<IMATH_NAMESPACE::V2d>  V2dArray;
+typedef FixedVArray<IMATH_NAMESPACE::V2f>  VV2fArray;
 
 // TODO: template <class T> class Vec2Array : public FixedArray<IMATH_NAMESPACE::Vec2<T> >
 
@@ -57,14 +58,14 @@ typedef FixedArray<IMATH_NAMESPACE::V2d>  V2dArray;
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator * (T v0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a1) { return a1*v0; }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator * (const PyImath::FixedArray<T> &a0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a1) {
@@ -75,12 +76,12 @@ static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator * (const PyImath:
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec2<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
 }
 
 
@@ -93,6 +94,7 @@ typedef FixedArray<IMATH_NAMESPACE::V3s>  V3sArray;
 typedef FixedArray<IMATH_NAMESPACE::V3i>  V3iArray;
 typedef FixedArray<IMATH_NAMESPACE::V3f>  V3fArray;
 typedef FixedArray<IMATH_NAMESPACE::V3d>  V3dArray;
+typedef FixedVArray<IMATH_NAMESPACE::V3f>  VV3fArray;
 
 // TODO: template <class T> class Vec3Array : public FixedArray<IMATH_NAMESPACE::Vec3<T> >
 }
@@ -101,14 +103,14 @@ typedef FixedArray<IMATH_NAMESPACE::V3d>  V3dArray;
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (T v0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a1) { return a1*v0; }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath::FixedArray<T> &a0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a1) {
@@ -117,25 +119,25 @@ static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath:
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &va, const IMATH_NAMESPACE::M44f &m) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
+    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
 }
 
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &va, const IMATH_NAMESPACE::M44d &m) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
+    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
 }
 
 // define vector/float array division
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
 }
 
 namespace PyImath {
@@ -155,14 +157,14 @@ typedef FixedArray<IMATH_NAMESPACE::V4d>  V4dArray;
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (T v0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a1) { return a1*v0; }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]*a1[i]; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath::FixedArray<T> &a0, const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a1) {
@@ -171,25 +173,25 @@ static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath:
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &va, const IMATH_NAMESPACE::M44f &m) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
+    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
 }
 
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator * (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &va, const IMATH_NAMESPACE::M44d &m) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
+    size_t len = va.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i = 0; i < len; ++i) f[i] = va[i] * m; return f;
 }
 
 // define vector/float array division
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a0, T v1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
+    size_t len = a0.len(); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/v1; return f;
 }
 template <class T>
 static PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > operator / (const PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > &a0, const PyImath::FixedArray<T> &a1) {
     PY_IMATH_LEAVE_PYTHON;
-    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
+    size_t len = a0.match_dimension(a1); PyImath::FixedArray<IMATH_NAMESPACE::Vec4<T> > f(len, PyImath::UNINITIALIZED); for (size_t i=0;i<len;++i) f[i]=a0[i]/a1[i]; return f;
 }
 
 
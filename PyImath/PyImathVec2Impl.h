@@ -54,6 +54,8 @@
 #include <boost/cast.hpp>
 #include <PyImathOperators.h>
 #include <PyImathVecOperators.h>
+#include <PyImathFixedArrayExpr.h>
+#include <PyImathFixedArraySoA.h>
 
 namespace PyImath {
 
@@ -173,7 +175,7 @@ Vec2_cross_Vec2Array(const IMATH_NAMESPACE::Vec2<T> &va, const FixedArray<IMATH_
 { 
     PY_IMATH_LEAVE_PYTHON;
     size_t len = vb.len(); 
-    FixedArray<T> f(len); 
+    FixedArray<T> f(len, UNINITIALIZED); 
     for (size_t i = 0; i < len; ++i) 
         f[i] = va.cross(vb[i]); 
     return f; 
@@ -193,7 +195,7 @@ Vec2_dot_Vec2Array(const IMATH_NAMESPACE::Vec2<T> &va, const FixedArray<IMATH_NA
 { 
     PY_IMATH_LEAVE_PYTHON;
     size_t len = vb.len(); 
-    FixedArray<T> f(len); 
+    FixedArray<T> f(len, UNINITIALIZED); 
     for (size_t i = 0; i < len; ++i) 
         f[i] = va.dot(vb[i]); 
     return f; 
@@ -358,7 +360,7 @@ Vec2_mulTArray (const Vec2<T> &v, const FixedArray<T> &t)
 {
     PY_IMATH_LEAVE_PYTHON;
     size_t len = t.len();
-    FixedArray<IMATH_NAMESPACE::Vec2<T> > retval(len);
+    FixedArray<IMATH_NAMESPACE::Vec2<T> > retval(len, UNINITIALIZED);
     for (size_t i=0; i<len; ++i) retval[i] = v*t[i];
     return retval;
 }
@@ -1078,47 +1080,24 @@ template <class T>
 static IMATH_NAMESPACE::Vec2<T>
 Vec2Array_min(const FixedArray<IMATH_NAMESPACE::Vec2<T> > &a)
 {
-    Vec2<T> tmp(Vec2<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x < tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y < tmp.y)
-            tmp.y = a[i].y;
-    }
-    return tmp;
+    return fa_min(a);
 }
 
 template <class T>
 static IMATH_NAMESPACE::Vec2<T>
 Vec2Array_max(const FixedArray<IMATH_NAMESPACE::Vec2<T> > &a)
 {
-    Vec2<T> tmp(Vec2<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x > tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y > tmp.y)
-            tmp.y = a[i].y;
-    }
-    return tmp;
+    return fa_max(a);
 }
 
 template <class T>
 static IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec2<T> >
 Vec2Array_bounds(const FixedArray<IMATH_NAMESPACE::Vec2<T> > &a)
 {
-    Box<Vec2<T> > tmp;
-    size_t len = a.len();
-    for (size_t i=0; i < len; ++i)
-        tmp.extendBy(a[i]);
-    return tmp;
+    ArrayReduction<Vec2<T> > r = reduceArray<REDUCE_MIN|REDUCE_MAX>(a);
+    if (r.count == 0)
+        return Box<Vec2<T> >();
+    return Box<Vec2<T> >(r.min, r.max);
 }
 
 template <class T>
@@ -1142,21 +1121,28 @@ register_Vec2Array(py::module &m)
     add_arithmetic_math_functions(vec2Array_class);
     add_comparison_functions(vec2Array_class);
 
-    generate_member_bindings(vec2Array_class, &op_vecLength<IMATH_NAMESPACE::Vec2<T>>::apply, "length","");
-    generate_member_bindings(vec2Array_class, &op_vecLength2<IMATH_NAMESPACE::Vec2<T>>::apply, "length2","");
-    generate_member_bindings(vec2Array_class, &op_vecNormalize<IMATH_NAMESPACE::Vec2<T>>::apply, "normalize","");
-    generate_member_bindings(vec2Array_class, &op_vecNormalized<IMATH_NAMESPACE::Vec2<T>>::apply, "normalized","");
-
-    generate_member_bindings(vec2Array_class, &op_vec2Cross<T>::apply, "cross","return the cross product of (self,x)");
-    generate_member_bindings(vec2Array_class, &op_vecDot<IMATH_NAMESPACE::Vec2<T>>::apply, "dot","return the inner product of (self,x)");
-
-    generate_member_bindings(vec2Array_class, &op_mul<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__mul__" ,"self*x");
-    generate_member_bindings(vec2Array_class, &op_mul<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__rmul__","x*self");
-    generate_member_bindings(vec2Array_class, &op_imul<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__imul__","self*=x");
-    generate_member_bindings(vec2Array_class, &op_div<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__div__" ,"self/x");
-    generate_member_bindings(vec2Array_class, &op_div<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__truediv__" ,"self/x");
-    generate_member_bindings(vec2Array_class, &op_idiv<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__idiv__","self/=x");
-    generate_member_bindings(vec2Array_class, &op_idiv<IMATH_NAMESPACE::Vec2<T>,T>::apply, "__itruediv__","self/=x");
+    generate_member_bindings<op_vecLength<IMATH_NAMESPACE::Vec2<T> > >(vec2Array_class,"length","");
+    generate_member_bindings<op_vecLength2<IMATH_NAMESPACE::Vec2<T> > >(vec2Array_class,"length2","");
+    generate_member_bindings<op_vecNormalize<IMATH_NAMESPACE::Vec2<T> > >(vec2Array_class,"normalize","");
+    generate_member_bindings<op_vecNormalized<IMATH_NAMESPACE::Vec2<T> > >(vec2Array_class,"normalized","");
+
+    generate_member_bindings<op_vec2Cross<T>,true_>(vec2Array_class,"cross","return the cross product of (self,x)",args("x"));
+    generate_member_bindings<op_vecDot<IMATH_NAMESPACE::Vec2<T> >,true_>(vec2Array_class,"dot","return the inner product of (self,x)",args("x"));
+
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__mul__","self*x",args("x"));
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__rmul__","x*self",args("x"));
+    generate_member_bindings<op_imul<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__imul__","self*=x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__div__","self/x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__truediv__","self/x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__idiv__","self/=x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec2<T>,T>,true_>(vec2Array_class,"__itruediv__","self/=x",args("x"));
+
+    py::class_<FixedArrayExpr<IMATH_NAMESPACE::Vec2<T> > > vec2Expr_class = add_lazy_arithmetic_functions(m, vec2Array_class);
+    add_lazy_vec_functions(vec2Expr_class);
+
+    py::class_<FixedArraySoA<IMATH_NAMESPACE::Vec2<T> > > vec2SoA_class = add_soa_functions(m, vec2Array_class);
+    add_soa_vec_functions(vec2SoA_class);
+    add_soa_bounds_functions(vec2SoA_class);
 
     decoratecopy(vec2Array_class);
 
@@ -39,6 +39,7 @@
 namespace PyImath {
 template <> const char *PyImath::V2fArray::name() { return "V2fArray"; }
 template <> const char *PyImath::V2dArray::name() { return "V2dArray"; }
+template <> const char *PyImath::VV2fArray::name() { return "VV2fArray"; }
 
 
 using namespace IMATH_NAMESPACE;
@@ -53,6 +53,9 @@
 #include <PyImathMathExc.h>
 #include <PyImathOperators.h>
 #include <PyImathVecOperators.h>
+#include <PyImathFixedArrayExpr.h>
+#include <PyImathFixedArraySoA.h>
+#include <PyImathVec3Simd.h>
 
 namespace PyImath {
 
@@ -88,51 +91,24 @@ template <class T>
 static IMATH_NAMESPACE::Vec3<T>
 Vec3Array_min(const FixedArray<IMATH_NAMESPACE::Vec3<T> > &a)
 {
-    Vec3<T> tmp(Vec3<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x < tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y < tmp.y)
-            tmp.y = a[i].y;
-        if (a[i].z < tmp.z)
-            tmp.z = a[i].z;
-    }
-    return tmp;
+    return fa_min(a);
 }
 
 template <class T>
 static IMATH_NAMESPACE::Vec3<T>
 Vec3Array_max(const FixedArray<IMATH_NAMESPACE::Vec3<T> > &a)
 {
-    Vec3<T> tmp(Vec3<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x > tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y > tmp.y)
-            tmp.y = a[i].y;
-        if (a[i].z > tmp.z)
-            tmp.z = a[i].z;
-    }
-    return tmp;
+    return fa_max(a);
 }
 
 template <class T>
 static IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> >
 Vec3Array_bounds(const FixedArray<IMATH_NAMESPACE::Vec3<T> > &a)
 {
-    Box<Vec3<T> > tmp;
-    size_t len = a.len();
-    for (size_t i=0; i < len; ++i)
-        tmp.extendBy(a[i]);
-    return tmp;
+    ArrayReduction<Vec3<T> > r = reduceArray<REDUCE_MIN|REDUCE_MAX>(a);
+    if (r.count == 0)
+        return Box<Vec3<T> >();
+    return Box<Vec3<T> >(r.min, r.max);
 }
 
 template <class T>
@@ -156,24 +132,33 @@ register_Vec3Array(py::module &m)
     add_arithmetic_math_functions(vec3Array_class);
     add_comparison_functions(vec3Array_class);
 
-    generate_member_bindings(vec3Array_class, &op_vecLength<IMATH_NAMESPACE::Vec3<T> >::apply,"length","");
-    generate_member_bindings(vec3Array_class, &op_vecLength2<IMATH_NAMESPACE::Vec3<T> >::apply,"length2","");
-    generate_member_bindings(vec3Array_class, &op_vecNormalize<IMATH_NAMESPACE::Vec3<T> >::apply,"normalize","");
-    generate_member_bindings(vec3Array_class, &op_vecNormalized<IMATH_NAMESPACE::Vec3<T> >::apply,"normalized","");
-
-    generate_member_bindings(vec3Array_class, &op_vec3Cross<T>::apply,"cross","return the cross product of (self,x)");
-    generate_member_bindings(vec3Array_class, &op_vecDot<IMATH_NAMESPACE::Vec3<T> >::apply,"dot","return the inner product of (self,x)");
-
-    generate_member_bindings(vec3Array_class, &op_mul<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__mul__" ,"self*x");
-    generate_member_bindings(vec3Array_class, &op_mul<IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::M44f>::apply,"__mul__" ,"self*x");
-    generate_member_bindings(vec3Array_class, &op_mul<IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::M44d>::apply,"__mul__" ,"self*x");
-
-    generate_member_bindings(vec3Array_class, &op_mul<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__rmul__","x*self");
-    generate_member_bindings(vec3Array_class, &op_imul<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__imul__","self*=x");
-    generate_member_bindings(vec3Array_class, &op_div<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__div__" ,"self/x");
-    generate_member_bindings(vec3Array_class, &op_div<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__truediv__" ,"self/x");
-    generate_member_bindings(vec3Array_class, &op_idiv<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__idiv__","self/=x");
-    generate_member_bindings(vec3Array_class, &op_idiv<IMATH_NAMESPACE::Vec3<T>,T>::apply,"__itruediv__","self/=x");
+    generate_member_bindings<op_vecLength<IMATH_NAMESPACE::Vec3<T> > >(vec3Array_class,"length","");
+    generate_member_bindings<op_vecLength2<IMATH_NAMESPACE::Vec3<T> > >(vec3Array_class,"length2","");
+    generate_member_bindings<op_vecNormalize<IMATH_NAMESPACE::Vec3<T> > >(vec3Array_class,"normalize","");
+    generate_member_bindings<op_vecNormalized<IMATH_NAMESPACE::Vec3<T> > >(vec3Array_class,"normalized","");
+
+    generate_member_bindings<op_vec3Cross<T>,true_>(vec3Array_class,"cross","return the cross product of (self,x)",args("x"));
+    generate_member_bindings<op_vecDot<IMATH_NAMESPACE::Vec3<T> >,true_>(vec3Array_class,"dot","return the inner product of (self,x)",args("x"));
+
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__mul__","self*x",args("x"));
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::M44f>,false_>(vec3Array_class,"__mul__","self*x",args("x"));
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec3<T>,IMATH_NAMESPACE::M44d>,false_>(vec3Array_class,"__mul__","self*x",args("x"));
+
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__rmul__","x*self",args("x"));
+    generate_member_bindings<op_imul<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__imul__","self*=x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__div__","self/x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__truediv__","self/x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__idiv__","self/=x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec3<T>,T>,true_>(vec3Array_class,"__itruediv__","self/=x",args("x"));
+
+    py::class_<FixedArrayExpr<IMATH_NAMESPACE::Vec3<T> > > vec3Expr_class = add_lazy_arithmetic_functions(m, vec3Array_class);
+    add_lazy_vec_functions(vec3Expr_class);
+    add_lazy_vec3_functions(vec3Expr_class);
+
+    py::class_<FixedArraySoA<IMATH_NAMESPACE::Vec3<T> > > vec3SoA_class = add_soa_functions(m, vec3Array_class);
+    add_soa_vec_functions(vec3SoA_class);
+    add_soa_vec3_functions(vec3SoA_class);
+    add_soa_bounds_functions(vec3SoA_class);
 
     decoratecopy(vec3Array_class);
 
@@ -163,7 +163,7 @@ Vec3_cross_Vec3Array(const IMATH_NAMESPACE::Vec3<T> &va, const FixedArray<IMATH_
 { 
     MATH_EXC_ON;
     size_t len = vb.len(); 
-    FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len); 
+    FixedArray<IMATH_NAMESPACE::Vec3<T> > f(len, UNINITIALIZED); 
     for (size_t i = 0; i < len; ++i) 
         f[i] = va.cross(vb[i]); 
     return f; 
@@ -183,7 +183,7 @@ Vec3_dot_Vec3Array(const IMATH_NAMESPACE::Vec3<T> &va, const FixedArray<IMATH_NA
 { 
     MATH_EXC_ON;
     size_t len = vb.len(); 
-    FixedArray<T> f(len); 
+    FixedArray<T> f(len, UNINITIALIZED); 
     for (size_t i = 0; i < len; ++i) 
         f[i] = va.dot(vb[i]); 
     return f; 
@@ -349,7 +349,7 @@ Vec3_mulTArray (const Vec3<T> &v, const FixedArray<T> &t)
 {
     MATH_EXC_ON;
     size_t len = t.len();
-    FixedArray<IMATH_NAMESPACE::Vec3<T> > retval(len);
+    FixedArray<IMATH_NAMESPACE::Vec3<T> > retval(len, UNINITIALIZED);
     for (size_t i=0; i<len; ++i) retval[i] = v*t[i];
     return retval;
 }
@@ -0,0 +1,399 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "python_include.h"
+#include <PyImathVec3Simd.h>
+#include <ImathVec.h>
+#include <limits>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PYIMATH_VEC3_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace PyImath {
+
+namespace {
+
+using IMATH_NAMESPACE::Vec3;
+
+//
+// Scalar versions of the kernels, used for the lanes the simd kernels
+// leave over and on cpus without a supported instruction set.
+//
+
+template <class T>
+void
+lengthScalar(const T *x, const T *y, const T *z, T *r, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; ++i)
+        r[i] = Vec3<T>(x[i],y[i],z[i]).length();
+}
+
+template <class T>
+void
+normalizeScalar(T *x, T *y, T *z, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; ++i)
+    {
+        Vec3<T> v(x[i],y[i],z[i]);
+        v.normalize();
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+}
+
+template <class T>
+void
+dotScalar(const T *x, const T *y, const T *z, const T *x2, const T *y2, const T *z2,
+          T *r, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; ++i)
+        r[i] = Vec3<T>(x[i],y[i],z[i]).dot(Vec3<T>(x2[i],y2[i],z2[i]));
+}
+
+template <class T>
+void
+crossScalar(const T *x, const T *y, const T *z, const T *x2, const T *y2, const T *z2,
+            T *rx, T *ry, T *rz, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; ++i)
+    {
+        // the result may overwrite either argument
+        Vec3<T> v = Vec3<T>(x[i],y[i],z[i]).cross(Vec3<T>(x2[i],y2[i],z2[i]));
+        rx[i] = v.x;
+        ry[i] = v.y;
+        rz[i] = v.z;
+    }
+}
+
+namespace scalar {
+
+template <class T>
+Vec3Kernels<T>
+kernels()
+{
+    struct K
+    {
+        static void length(const T *x, const T *y, const T *z, T *r, size_t n)
+            { lengthScalar(x,y,z,r,0,n); }
+        static void normalize(T *x, T *y, T *z, size_t n)
+            { normalizeScalar(x,y,z,0,n); }
+        static void dot(const T *x, const T *y, const T *z, const T *x2, const T *y2, const T *z2, T *r, size_t n)
+            { dotScalar(x,y,z,x2,y2,z2,r,0,n); }
+        static void cross(const T *x, const T *y, const T *z, const T *x2, const T *y2, const T *z2,
+                          T *rx, T *ry, T *rz, size_t n)
+            { crossScalar(x,y,z,x2,y2,z2,rx,ry,rz,0,n); }
+    };
+    Vec3Kernels<T> k = { &K::length, &K::normalize, &K::dot, &K::cross };
+    return k;
+}
+
+} // namespace scalar
+
+#ifdef PYIMATH_VEC3_SIMD_X86
+
+//
+// Each instruction set's packs and kernels are compiled with that
+// instruction set enabled, and only called once the cpu is known to
+// support it.  MSVC makes all the intrinsics available regardless.
+// Contraction into fused multiply-adds is turned off (avx512f implies
+// fma in gcc) so that the results stay identical to the scalar code.
+//
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace sse2 {
+
+struct PackF
+{
+    typedef float Scalar;
+    enum { width = 4 };
+    __m128 v;
+
+    PackF(__m128 a) : v(a) {}
+    static PackF load(const float *p) { return _mm_loadu_ps(p); }
+    static PackF set1(float s) { return _mm_set1_ps(s); }
+    void store(float *p) const { _mm_storeu_ps(p,v); }
+};
+
+inline PackF operator + (PackF a, PackF b) { return _mm_add_ps(a.v,b.v); }
+inline PackF operator - (PackF a, PackF b) { return _mm_sub_ps(a.v,b.v); }
+inline PackF operator * (PackF a, PackF b) { return _mm_mul_ps(a.v,b.v); }
+inline PackF operator / (PackF a, PackF b) { return _mm_div_ps(a.v,b.v); }
+inline PackF sqrt(PackF a) { return _mm_sqrt_ps(a.v); }
+inline bool anyLess(PackF a, PackF b) { return _mm_movemask_ps(_mm_cmplt_ps(a.v,b.v)) != 0; }
+
+struct PackD
+{
+    typedef double Scalar;
+    enum { width = 2 };
+    __m128d v;
+
+    PackD(__m128d a) : v(a) {}
+    static PackD load(const double *p) { return _mm_loadu_pd(p); }
+    static PackD set1(double s) { return _mm_set1_pd(s); }
+    void store(double *p) const { _mm_storeu_pd(p,v); }
+};
+
+inline PackD operator + (PackD a, PackD b) { return _mm_add_pd(a.v,b.v); }
+inline PackD operator - (PackD a, PackD b) { return _mm_sub_pd(a.v,b.v); }
+inline PackD operator * (PackD a, PackD b) { return _mm_mul_pd(a.v,b.v); }
+inline PackD operator / (PackD a, PackD b) { return _mm_div_pd(a.v,b.v); }
+inline PackD sqrt(PackD a) { return _mm_sqrt_pd(a.v); }
+inline bool anyLess(PackD a, PackD b) { return _mm_movemask_pd(_mm_cmplt_pd(a.v,b.v)) != 0; }
+
+#include "PyImathVec3SimdKernels.h"
+
+} // namespace sse2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace avx2 {
+
+struct PackF
+{
+    typedef float Scalar;
+    enum { width = 8 };
+    __m256 v;
+
+    PackF(__m256 a) : v(a) {}
+    static PackF load(const float *p) { return _mm256_loadu_ps(p); }
+    static PackF set1(float s) { return _mm256_set1_ps(s); }
+    void store(float *p) const { _mm256_storeu_ps(p,v); }
+};
+
+inline PackF operator + (PackF a, PackF b) { return _mm256_add_ps(a.v,b.v); }
+inline PackF operator - (PackF a, PackF b) { return _mm256_sub_ps(a.v,b.v); }
+inline PackF operator * (PackF a, PackF b) { return _mm256_mul_ps(a.v,b.v); }
+inline PackF operator / (PackF a, PackF b) { return _mm256_div_ps(a.v,b.v); }
+inline PackF sqrt(PackF a) { return _mm256_sqrt_ps(a.v); }
+inline bool anyLess(PackF a, PackF b) { return _mm256_movemask_ps(_mm256_cmp_ps(a.v,b.v,_CMP_LT_OQ)) != 0; }
+
+struct PackD
+{
+    typedef double Scalar;
+    enum { width = 4 };
+    __m256d v;
+
+    PackD(__m256d a) : v(a) {}
+    static PackD load(const double *p) { return _mm256_loadu_pd(p); }
+    static PackD set1(double s) { return _mm256_set1_pd(s); }
+    void store(double *p) const { _mm256_storeu_pd(p,v); }
+};
+
+inline PackD operator + (PackD a, PackD b) { return _mm256_add_pd(a.v,b.v); }
+inline PackD operator - (PackD a, PackD b) { return _mm256_sub_pd(a.v,b.v); }
+inline PackD operator * (PackD a, PackD b) { return _mm256_mul_pd(a.v,b.v); }
+inline PackD operator / (PackD a, PackD b) { return _mm256_div_pd(a.v,b.v); }
+inline PackD sqrt(PackD a) { return _mm256_sqrt_pd(a.v); }
+inline bool anyLess(PackD a, PackD b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v,b.v,_CMP_LT_OQ)) != 0; }
+
+#include "PyImathVec3SimdKernels.h"
+
+} // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace avx512 {
+
+struct PackF
+{
+    typedef float Scalar;
+    enum { width = 16 };
+    __m512 v;
+
+    PackF(__m512 a) : v(a) {}
+    static PackF load(const float *p) { return _mm512_loadu_ps(p); }
+    static PackF set1(float s) { return _mm512_set1_ps(s); }
+    void store(float *p) const { _mm512_storeu_ps(p,v); }
+};
+
+inline PackF operator + (PackF a, PackF b) { return _mm512_add_ps(a.v,b.v); }
+inline PackF operator - (PackF a, PackF b) { return _mm512_sub_ps(a.v,b.v); }
+inline PackF operator * (PackF a, PackF b) { return _mm512_mul_ps(a.v,b.v); }
+inline PackF operator / (PackF a, PackF b) { return _mm512_div_ps(a.v,b.v); }
+inline PackF sqrt(PackF a) { return _mm512_sqrt_ps(a.v); }
+inline bool anyLess(PackF a, PackF b) { return _mm512_cmp_ps_mask(a.v,b.v,_CMP_LT_OQ) != 0; }
+
+struct PackD
+{
+    typedef double Scalar;
+    enum { width = 8 };
+    __m512d v;
+
+    PackD(__m512d a) : v(a) {}
+    static PackD load(const double *p) { return _mm512_loadu_pd(p); }
+    static PackD set1(double s) { return _mm512_set1_pd(s); }
+    void store(double *p) const { _mm512_storeu_pd(p,v); }
+};
+
+inline PackD operator + (PackD a, PackD b) { return _mm512_add_pd(a.v,b.v); }
+inline PackD operator - (PackD a, PackD b) { return _mm512_sub_pd(a.v,b.v); }
+inline PackD operator * (PackD a, PackD b) { return _mm512_mul_pd(a.v,b.v); }
+inline PackD operator / (PackD a, PackD b) { return _mm512_div_pd(a.v,b.v); }
+inline PackD sqrt(PackD a) { return _mm512_sqrt_pd(a.v); }
+inline bool anyLess(PackD a, PackD b) { return _mm512_cmp_pd_mask(a.v,b.v,_CMP_LT_OQ) != 0; }
+
+#include "PyImathVec3SimdKernels.h"
+
+} // namespace avx512
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+enum SimdLevel { SIMD_NONE, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 };
+
+SimdLevel
+detectSimdLevel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!sse2)
+        return SIMD_NONE;
+    if (!osxsave || !avx || maxLeaf < 7)
+        return SIMD_SSE2;
+
+    // the os has to save the ymm (and for avx512 the zmm and opmask) state
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    const bool avx512f = (info[1] & (1 << 16)) != 0;
+    if (avx512f && (xcr0 & 0xe6) == 0xe6)
+        return SIMD_AVX512;
+    if (avx2 && (xcr0 & 0x6) == 0x6)
+        return SIMD_AVX2;
+    return SIMD_SSE2;
+#else
+    // these also check that the os saves the extended register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SIMD_SSE2;
+    return SIMD_NONE;
+#endif
+}
+
+#endif // PYIMATH_VEC3_SIMD_X86
+
+template <class T, class SseP, class Avx2P, class Avx512P>
+Vec3Kernels<T>
+selectKernels()
+{
+#ifdef PYIMATH_VEC3_SIMD_X86
+    switch (detectSimdLevel())
+    {
+      case SIMD_AVX512: return avx512::kernels<Avx512P>();
+      case SIMD_AVX2:   return avx2::kernels<Avx2P>();
+      case SIMD_SSE2:   return sse2::kernels<SseP>();
+      default:          break;
+    }
+#endif
+    return scalar::kernels<T>();
+}
+
+} // namespace
+
+#ifdef PYIMATH_VEC3_SIMD_X86
+#define PYIMATH_VEC3_PACKS(S) sse2::Pack##S, avx2::Pack##S, avx512::Pack##S
+#else
+#define PYIMATH_VEC3_PACKS(S) void, void, void
+#endif
+
+template <>
+const Vec3Kernels<float> &
+vec3Kernels<float>()
+{
+    static const Vec3Kernels<float> k = selectKernels<float, PYIMATH_VEC3_PACKS(F)>();
+    return k;
+}
+
+template <>
+const Vec3Kernels<double> &
+vec3Kernels<double>()
+{
+    static const Vec3Kernels<double> k = selectKernels<double, PYIMATH_VEC3_PACKS(D)>();
+    return k;
+}
+
+} // namespace PyImath
@@ -0,0 +1,389 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathVec3Simd_h_
+#define _PyImathVec3Simd_h_
+
+#include <PyImathExport.h>
+#include <PyImathAutovectorize.h>
+#include <PyImathVecOperators.h>
+#include <ImathVec.h>
+#include <algorithm>
+
+namespace PyImath {
+
+//
+// SIMD kernels for the hot V3fArray/V3dArray operations.  The kernels
+// work on structure-of-arrays blocks: the tasks below gather a block of
+// vectors out of the (possibly strided or masked) arrays into separate
+// x, y and z buffers, run the kernel over them, and scatter the result.
+// The kernel set is picked once, at load time, for the best instruction
+// set the cpu supports, and gives the same results as the Imath methods.
+//
+template <class T>
+struct Vec3Kernels
+{
+    void (*length)    (const T *x, const T *y, const T *z, T *r, size_t n);
+    void (*normalize) (T *x, T *y, T *z, size_t n);
+    void (*dot)       (const T *x, const T *y, const T *z,
+                       const T *x2, const T *y2, const T *z2, T *r, size_t n);
+    void (*cross)     (const T *x, const T *y, const T *z,
+                       const T *x2, const T *y2, const T *z2,
+                       T *rx, T *ry, T *rz, size_t n);
+};
+
+template <class T> const Vec3Kernels<T> & vec3Kernels();
+template <> PYIMATH_EXPORT const Vec3Kernels<float>  & vec3Kernels<float>();
+template <> PYIMATH_EXPORT const Vec3Kernels<double> & vec3Kernels<double>();
+
+namespace detail {
+
+static const size_t vec3SimdBlockSize = 256;
+
+//
+// direct_sequential_access steps through an unmasked argument the same
+// way sequential_access steps through a masked one, so that the tasks
+// below can run one block loop over either.
+//
+template <class T>
+struct direct_sequential_access
+{
+    T &arg;
+    direct_sequential_access(T &a, size_t start) : arg(a) {}
+    inline T & next() { return arg; }
+};
+
+template <class T>
+struct direct_sequential_access<T &>
+{
+    T &arg;
+    direct_sequential_access(T &a, size_t start) : arg(a) {}
+    inline T & next() { return arg; }
+};
+
+template <class T>
+struct direct_sequential_access<PyImath::FixedArray<T> &>
+{
+    PyImath::FixedArray<T> &arg;
+    size_t index;
+    direct_sequential_access(PyImath::FixedArray<T> &a, size_t start) : arg(a), index(start) {}
+    inline T & next() { return arg.direct_index(index++); }
+};
+
+template <class T>
+struct direct_sequential_access<const PyImath::FixedArray<T> &>
+{
+    const PyImath::FixedArray<T> &arg;
+    size_t index;
+    direct_sequential_access(const PyImath::FixedArray<T> &a, size_t start) : arg(a), index(start) {}
+    inline const T & next() { return arg.direct_index(index++); }
+};
+
+template <class T, class access_type>
+inline void
+gather_vec3_block(access_type &arg, size_t n, T *x, T *y, T *z)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        const IMATH_NAMESPACE::Vec3<T> &v = arg.next();
+        x[k] = v.x;
+        y[k] = v.y;
+        z[k] = v.z;
+    }
+}
+
+template <class T, class access_type>
+inline void
+scatter_block(access_type &result, size_t n, const T *r)
+{
+    for (size_t k = 0; k < n; ++k)
+        result.next() = r[k];
+}
+
+template <class T, class access_type>
+inline void
+scatter_vec3_block(access_type &result, size_t n, const T *x, const T *y, const T *z)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        IMATH_NAMESPACE::Vec3<T> &v = result.next();
+        v.x = x[k];
+        v.y = y[k];
+        v.z = z[k];
+    }
+}
+
+struct Vec3BlockTask : public Task
+{
+    size_t minGrain() const { return vec3SimdBlockSize; }
+};
+
+template <class T, class result_type, class arg1_type>
+struct Vec3LengthOperation : public Vec3BlockTask
+{
+    result_type &retval;
+    arg1_type arg1;
+
+    Vec3LengthOperation(result_type &r, arg1_type a1) : retval(r), arg1(a1) {}
+
+    void execute(size_t start, size_t end)
+    {
+        if (any_masked(retval,arg1)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            run(r,a1,start,end);
+        } else {
+            direct_sequential_access<result_type &> r(retval,start);
+            direct_sequential_access<arg1_type> a1(arg1,start);
+            run(r,a1,start,end);
+        }
+    }
+
+    template <class R, class A1>
+    void run(R &ret, A1 &a1, size_t start, size_t end)
+    {
+        T x[vec3SimdBlockSize], y[vec3SimdBlockSize], z[vec3SimdBlockSize], r[vec3SimdBlockSize];
+        for (size_t s = start; s < end; s += vec3SimdBlockSize)
+        {
+            size_t n = std::min(vec3SimdBlockSize, end - s);
+            gather_vec3_block<T>(a1,n,x,y,z);
+            vec3Kernels<T>().length(x,y,z,r,n);
+            scatter_block<T>(ret,n,r);
+        }
+    }
+};
+
+template <class T, class result_type, class arg1_type>
+struct Vec3NormalizedOperation : public Vec3BlockTask
+{
+    result_type &retval;
+    arg1_type arg1;
+
+    Vec3NormalizedOperation(result_type &r, arg1_type a1) : retval(r), arg1(a1) {}
+
+    void execute(size_t start, size_t end)
+    {
+        if (any_masked(retval,arg1)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            run(r,a1,start,end);
+        } else {
+            direct_sequential_access<result_type &> r(retval,start);
+            direct_sequential_access<arg1_type> a1(arg1,start);
+            run(r,a1,start,end);
+        }
+    }
+
+    template <class R, class A1>
+    void run(R &ret, A1 &a1, size_t start, size_t end)
+    {
+        T x[vec3SimdBlockSize], y[vec3SimdBlockSize], z[vec3SimdBlockSize];
+        for (size_t s = start; s < end; s += vec3SimdBlockSize)
+        {
+            size_t n = std::min(vec3SimdBlockSize, end - s);
+            gather_vec3_block<T>(a1,n,x,y,z);
+            vec3Kernels<T>().normalize(x,y,z,n);
+            scatter_vec3_block<T>(ret,n,x,y,z);
+        }
+    }
+};
+
+template <class T, class class_type>
+struct Vec3NormalizeOperation : public Vec3BlockTask
+{
+    class_type cls;
+
+    Vec3NormalizeOperation(class_type c) : cls(c) {}
+
+    void execute(size_t start, size_t end)
+    {
+        // separate cursors for reading a block and writing it back
+        if (any_masked(cls)) {
+            sequential_access<class_type> in(cls,start), out(cls,start);
+            run(in,out,start,end);
+        } else {
+            direct_sequential_access<class_type> in(cls,start), out(cls,start);
+            run(in,out,start,end);
+        }
+    }
+
+    template <class C>
+    void run(C &in, C &out, size_t start, size_t end)
+    {
+        T x[vec3SimdBlockSize], y[vec3SimdBlockSize], z[vec3SimdBlockSize];
+        for (size_t s = start; s < end; s += vec3SimdBlockSize)
+        {
+            size_t n = std::min(vec3SimdBlockSize, end - s);
+            gather_vec3_block<T>(in,n,x,y,z);
+            vec3Kernels<T>().normalize(x,y,z,n);
+            scatter_vec3_block<T>(out,n,x,y,z);
+        }
+    }
+};
+
+template <class T, class result_type, class arg1_type, class arg2_type>
+struct Vec3DotOperation : public Vec3BlockTask
+{
+    result_type &retval;
+    arg1_type arg1;
+    arg2_type arg2;
+
+    Vec3DotOperation(result_type &r, arg1_type a1, arg2_type a2) : retval(r), arg1(a1), arg2(a2) {}
+
+    void execute(size_t start, size_t end)
+    {
+        if (any_masked(retval,arg1,arg2)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            sequential_access<arg2_type> a2(arg2,start);
+            run(r,a1,a2,start,end);
+        } else {
+            direct_sequential_access<result_type &> r(retval,start);
+            direct_sequential_access<arg1_type> a1(arg1,start);
+            direct_sequential_access<arg2_type> a2(arg2,start);
+            run(r,a1,a2,start,end);
+        }
+    }
+
+    template <class R, class A1, class A2>
+    void run(R &ret, A1 &a1, A2 &a2, size_t start, size_t end)
+    {
+        T x[vec3SimdBlockSize], y[vec3SimdBlockSize], z[vec3SimdBlockSize];
+        T x2[vec3SimdBlockSize], y2[vec3SimdBlockSize], z2[vec3SimdBlockSize], r[vec3SimdBlockSize];
+        for (size_t s = start; s < end; s += vec3SimdBlockSize)
+        {
+            size_t n = std::min(vec3SimdBlockSize, end - s);
+            gather_vec3_block<T>(a1,n,x,y,z);
+            gather_vec3_block<T>(a2,n,x2,y2,z2);
+            vec3Kernels<T>().dot(x,y,z,x2,y2,z2,r,n);
+            scatter_block<T>(ret,n,r);
+        }
+    }
+};
+
+template <class T, class result_type, class arg1_type, class arg2_type>
+struct Vec3CrossOperation : public Vec3BlockTask
+{
+    result_type &retval;
+    arg1_type arg1;
+    arg2_type arg2;
+
+    Vec3CrossOperation(result_type &r, arg1_type a1, arg2_type a2) : retval(r), arg1(a1), arg2(a2) {}
+
+    void execute(size_t start, size_t end)
+    {
+        if (any_masked(retval,arg1,arg2)) {
+            sequential_access<result_type &> r(retval,start);
+            sequential_access<arg1_type> a1(arg1,start);
+            sequential_access<arg2_type> a2(arg2,start);
+            run(r,a1,a2,start,end);
+        } else {
+            direct_sequential_access<result_type &> r(retval,start);
+            direct_sequential_access<arg1_type> a1(arg1,start);
+            direct_sequential_access<arg2_type> a2(arg2,start);
+            run(r,a1,a2,start,end);
+        }
+    }
+
+    template <class R, class A1, class A2>
+    void run(R &ret, A1 &a1, A2 &a2, size_t start, size_t end)
+    {
+        T x[vec3SimdBlockSize], y[vec3SimdBlockSize], z[vec3SimdBlockSize];
+        T x2[vec3SimdBlockSize], y2[vec3SimdBlockSize], z2[vec3SimdBlockSize];
+        for (size_t s = start; s < end; s += vec3SimdBlockSize)
+        {
+            size_t n = std::min(vec3SimdBlockSize, end - s);
+            gather_vec3_block<T>(a1,n,x,y,z);
+            gather_vec3_block<T>(a2,n,x2,y2,z2);
+            vec3Kernels<T>().cross(x,y,z,x2,y2,z2,x,y,z,n);
+            scatter_vec3_block<T>(ret,n,x,y,z);
+        }
+    }
+};
+
+//
+// Route the vectorized V3f/V3d ops through the kernels above.
+//
+#define PYIMATH_VEC3_SIMD_OPERATIONS(T)                                                              \
+template <class result_type, class arg1_type>                                                        \
+struct VectorizedOperation1<op_vecLength<IMATH_NAMESPACE::Vec3<T> >,result_type,arg1_type>           \
+    : public Vec3LengthOperation<T,result_type,arg1_type>                                            \
+{                                                                                                    \
+    VectorizedOperation1(result_type &r, arg1_type a1)                                               \
+        : Vec3LengthOperation<T,result_type,arg1_type>(r,a1) {}                                      \
+};                                                                                                   \
+                                                                                                     \
+template <class result_type, class arg1_type>                                                        \
+struct VectorizedOperation1<op_vecNormalized<IMATH_NAMESPACE::Vec3<T> >,result_type,arg1_type>       \
+    : public Vec3NormalizedOperation<T,result_type,arg1_type>                                        \
+{                                                                                                    \
+    VectorizedOperation1(result_type &r, arg1_type a1)                                               \
+        : Vec3NormalizedOperation<T,result_type,arg1_type>(r,a1) {}                                  \
+};                                                                                                   \
+                                                                                                     \
+template <class class_type>                                                                          \
+struct VectorizedVoidOperation0<op_vecNormalize<IMATH_NAMESPACE::Vec3<T> >,class_type>               \
+    : public Vec3NormalizeOperation<T,class_type>                                                    \
+{                                                                                                    \
+    VectorizedVoidOperation0(class_type c)                                                           \
+        : Vec3NormalizeOperation<T,class_type>(c) {}                                                 \
+};                                                                                                   \
+                                                                                                     \
+template <class result_type, class arg1_type, class arg2_type>                                       \
+struct VectorizedOperation2<op_vecDot<IMATH_NAMESPACE::Vec3<T> >,result_type,arg1_type,arg2_type>    \
+    : public Vec3DotOperation<T,result_type,arg1_type,arg2_type>                                     \
+{                                                                                                    \
+    VectorizedOperation2(result_type &r, arg1_type a1, arg2_type a2)                                 \
+        : Vec3DotOperation<T,result_type,arg1_type,arg2_type>(r,a1,a2) {}                            \
+};                                                                                                   \
+                                                                                                     \
+template <class result_type, class arg1_type, class arg2_type>                                       \
+struct VectorizedOperation2<op_vec3Cross<T>,result_type,arg1_type,arg2_type>                         \
+    : public Vec3CrossOperation<T,result_type,arg1_type,arg2_type>                                   \
+{                                                                                                    \
+    VectorizedOperation2(result_type &r, arg1_type a1, arg2_type a2)                                 \
+        : Vec3CrossOperation<T,result_type,arg1_type,arg2_type>(r,a1,a2) {}                          \
+};
+
+PYIMATH_VEC3_SIMD_OPERATIONS(float)
+PYIMATH_VEC3_SIMD_OPERATIONS(double)
+
+#undef PYIMATH_VEC3_SIMD_OPERATIONS
+
+} // namespace detail
+
+} // namespace PyImath
+
+#endif // _PyImathVec3Simd_h_
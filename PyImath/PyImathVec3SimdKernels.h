@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+//
+// The Vec3 kernels, written against a small "pack" type that wraps one
+// register's worth of floats or doubles:
+//
+//     P::Scalar, P::width, P::load(ptr), P::set1(s), p.store(ptr),
+//     and the free functions + - * /, sqrt(p) and anyLess(a,b)
+//
+// PyImathVec3Simd.cpp includes this file once per instruction set,
+// inside a namespace compiled for that instruction set, so there is
+// deliberately no include guard.  Chunks holding a vector small enough
+// that Imath would take the lengthTiny() path, and the lanes left over
+// at the end, are handed to the scalar versions so that the results
+// match the Imath methods exactly.
+//
+
+template <class P>
+void
+length(const typename P::Scalar *x, const typename P::Scalar *y, const typename P::Scalar *z,
+       typename P::Scalar *r, size_t n)
+{
+    typedef typename P::Scalar T;
+    const P tiny = P::set1(2 * std::numeric_limits<T>::min());
+
+    size_t i = 0;
+    for (; i + P::width <= n; i += P::width)
+    {
+        P vx = P::load(x+i), vy = P::load(y+i), vz = P::load(z+i);
+        P l2 = vx*vx + vy*vy + vz*vz;
+        if (anyLess(l2, tiny))
+            lengthScalar(x,y,z,r,i,i+P::width);
+        else
+            sqrt(l2).store(r+i);
+    }
+    lengthScalar(x,y,z,r,i,n);
+}
+
+template <class P>
+void
+normalize(typename P::Scalar *x, typename P::Scalar *y, typename P::Scalar *z, size_t n)
+{
+    typedef typename P::Scalar T;
+    const P tiny = P::set1(2 * std::numeric_limits<T>::min());
+
+    size_t i = 0;
+    for (; i + P::width <= n; i += P::width)
+    {
+        P vx = P::load(x+i), vy = P::load(y+i), vz = P::load(z+i);
+        P l2 = vx*vx + vy*vy + vz*vz;
+        if (anyLess(l2, tiny))
+        {
+            normalizeScalar(x,y,z,i,i+P::width);
+        }
+        else
+        {
+            P l = sqrt(l2);
+            (vx / l).store(x+i);
+            (vy / l).store(y+i);
+            (vz / l).store(z+i);
+        }
+    }
+    normalizeScalar(x,y,z,i,n);
+}
+
+template <class P>
+void
+dot(const typename P::Scalar *x, const typename P::Scalar *y, const typename P::Scalar *z,
+    const typename P::Scalar *x2, const typename P::Scalar *y2, const typename P::Scalar *z2,
+    typename P::Scalar *r, size_t n)
+{
+    size_t i = 0;
+    for (; i + P::width <= n; i += P::width)
+    {
+        P ax = P::load(x+i), ay = P::load(y+i), az = P::load(z+i);
+        P bx = P::load(x2+i), by = P::load(y2+i), bz = P::load(z2+i);
+        (ax*bx + ay*by + az*bz).store(r+i);
+    }
+    dotScalar(x,y,z,x2,y2,z2,r,i,n);
+}
+
+template <class P>
+void
+cross(const typename P::Scalar *x, const typename P::Scalar *y, const typename P::Scalar *z,
+      const typename P::Scalar *x2, const typename P::Scalar *y2, const typename P::Scalar *z2,
+      typename P::Scalar *rx, typename P::Scalar *ry, typename P::Scalar *rz, size_t n)
+{
+    size_t i = 0;
+    for (; i + P::width <= n; i += P::width)
+    {
+        P ax = P::load(x+i), ay = P::load(y+i), az = P::load(z+i);
+        P bx = P::load(x2+i), by = P::load(y2+i), bz = P::load(z2+i);
+        P cx = ay*bz - az*by;
+        P cy = az*bx - ax*bz;
+        P cz = ax*by - ay*bx;
+        cx.store(rx+i);
+        cy.store(ry+i);
+        cz.store(rz+i);
+    }
+    crossScalar(x,y,z,x2,y2,z2,rx,ry,rz,i,n);
+}
+
+template <class P>
+Vec3Kernels<typename P::Scalar>
+kernels()
+{
+    Vec3Kernels<typename P::Scalar> k = { &length<P>, &normalize<P>, &dot<P>, &cross<P> };
+    return k;
+}
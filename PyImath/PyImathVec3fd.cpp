@@ -40,6 +40,7 @@
 namespace PyImath {
 template <> const char *PyImath::V3fArray::name() { return "V3fArray"; }
 template <> const char *PyImath::V3dArray::name() { return "V3dArray"; }
+template <> const char *PyImath::VV3fArray::name() { return "VV3fArray"; }
 
 
 using namespace IMATH_NAMESPACE;
@@ -52,6 +52,8 @@
 #include <PyImathMathExc.h>
 #include <PyImathOperators.h>
 #include <PyImathVecOperators.h>
+#include <PyImathFixedArrayExpr.h>
+#include <PyImathFixedArraySoA.h>
 
 namespace PyImath {
 
@@ -87,45 +89,16 @@ setItemTuple(FixedArray<IMATH_NAMESPACE::Vec4<T> > &va, Py_ssize_t index, const
 
 template <class T>
 static IMATH_NAMESPACE::Vec4<T>
-Vec4Array_min(const FixedArray<IMATH_NAMESPACE::Vec4<T> > &a) {
-    Vec4<T> tmp(Vec4<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x < tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y < tmp.y)
-            tmp.y = a[i].y;
-        if (a[i].z < tmp.z)
-            tmp.z = a[i].z;
-        if (a[i].w < tmp.w)
-            tmp.w = a[i].w;
-    }
-    return tmp;
+Vec4Array_min(const FixedArray<IMATH_NAMESPACE::Vec4<T> > &a)
+{
+    return fa_min(a);
 }
 
 template <class T>
 static IMATH_NAMESPACE::Vec4<T>
 Vec4Array_max(const FixedArray<IMATH_NAMESPACE::Vec4<T> > &a)
 {
-    Vec4<T> tmp(Vec4<T>(0));
-    size_t len = a.len();
-    if (len > 0)
-        tmp = a[0];
-    for (size_t i=1; i < len; ++i)
-    {
-        if (a[i].x > tmp.x)
-            tmp.x = a[i].x;
-        if (a[i].y > tmp.y)
-            tmp.y = a[i].y;
-        if (a[i].z > tmp.z)
-            tmp.z = a[i].z;
-        if (a[i].w > tmp.w)
-            tmp.w = a[i].w;
-    }
-    return tmp;
+    return fa_max(a);
 }
 
 template <class T>
@@ -143,24 +116,31 @@ register_Vec4Array(py::module &m)
         .def("__setitem__", &setItemTuple<T>)
         .def("min", &Vec4Array_min<T>)
         .def("max", &Vec4Array_max<T>)
+        .def("bounds", &fa_minmax<IMATH_NAMESPACE::Vec4<T> >)
         ;
 
     add_arithmetic_math_functions(vec4Array_class);
     add_comparison_functions(vec4Array_class);
 
-    generate_member_bindings(vec4Array_class, &op_vecLength<IMATH_NAMESPACE::Vec4<T> >::apply,"length","");
-    generate_member_bindings(vec4Array_class, &op_vecLength2<IMATH_NAMESPACE::Vec4<T> >::apply,"length2","");
-    generate_member_bindings(vec4Array_class, &op_vecNormalize<IMATH_NAMESPACE::Vec4<T> >::apply,"normalize","");
-    generate_member_bindings(vec4Array_class, &op_vecNormalized<IMATH_NAMESPACE::Vec4<T> >::apply,"normalized","");
-
-    generate_member_bindings(vec4Array_class, &op_vecDot<IMATH_NAMESPACE::Vec4<T> >::apply,"dot","return the inner product of (self,x)");
-    generate_member_bindings(vec4Array_class, &op_mul<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__mul__" ,"self*x");
-    generate_member_bindings(vec4Array_class, &op_mul<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__rmul__","x*self");
-    generate_member_bindings(vec4Array_class, &op_imul<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__imul__","self*=x");
-    generate_member_bindings(vec4Array_class, &op_div<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__div__" ,"self/x");
-    generate_member_bindings(vec4Array_class, &op_div<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__truediv__" ,"self/x");
-    generate_member_bindings(vec4Array_class, &op_idiv<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__idiv__","self/=x");
-    generate_member_bindings(vec4Array_class, &op_idiv<IMATH_NAMESPACE::Vec4<T>,T>::apply,"__itruediv__","self/=x");
+    generate_member_bindings<op_vecLength<IMATH_NAMESPACE::Vec4<T> > >(vec4Array_class,"length","");
+    generate_member_bindings<op_vecLength2<IMATH_NAMESPACE::Vec4<T> > >(vec4Array_class,"length2","");
+    generate_member_bindings<op_vecNormalize<IMATH_NAMESPACE::Vec4<T> > >(vec4Array_class,"normalize","");
+    generate_member_bindings<op_vecNormalized<IMATH_NAMESPACE::Vec4<T> > >(vec4Array_class,"normalized","");
+
+    generate_member_bindings<op_vecDot<IMATH_NAMESPACE::Vec4<T> >,true_>(vec4Array_class,"dot","return the inner product of (self,x)",args("x"));
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__mul__","self*x",args("x"));
+    generate_member_bindings<op_mul<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__rmul__","x*self",args("x"));
+    generate_member_bindings<op_imul<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__imul__","self*=x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__div__","self/x",args("x"));
+    generate_member_bindings<op_div<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__truediv__","self/x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__idiv__","self/=x",args("x"));
+    generate_member_bindings<op_idiv<IMATH_NAMESPACE::Vec4<T>,T>,true_>(vec4Array_class,"__itruediv__","self/=x",args("x"));
+
+    py::class_<FixedArrayExpr<IMATH_NAMESPACE::Vec4<T> > > vec4Expr_class = add_lazy_arithmetic_functions(m, vec4Array_class);
+    add_lazy_vec_functions(vec4Expr_class);
+
+    py::class_<FixedArraySoA<IMATH_NAMESPACE::Vec4<T> > > vec4SoA_class = add_soa_functions(m, vec4Array_class);
+    add_soa_vec_functions(vec4SoA_class);
 
     decoratecopy(vec4Array_class);
 
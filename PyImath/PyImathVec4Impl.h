@@ -170,7 +170,7 @@ Vec4_dot_Vec4Array(const IMATH_NAMESPACE::Vec4<T> &va, const FixedArray<IMATH_NA
 { 
     PY_IMATH_LEAVE_PYTHON;
     size_t len = vb.len(); 
-    FixedArray<T> f(len); 
+    FixedArray<T> f(len, UNINITIALIZED); 
     for (size_t i = 0; i < len; ++i) 
         f[i] = va.dot(vb[i]); 
     return f; 
@@ -329,7 +329,7 @@ Vec4_mulTArray (const Vec4<T> &v, const FixedArray<T> &t)
 {
     PY_IMATH_LEAVE_PYTHON;
     size_t len = t.len();
-    FixedArray<IMATH_NAMESPACE::Vec4<T> > retval(len);
+    FixedArray<IMATH_NAMESPACE::Vec4<T> > retval(len, UNINITIALIZED);
     for (size_t i=0; i<len; ++i) retval[i] = v*t[i];
     return retval;
 }
@@ -0,0 +1,408 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2010-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#include "python_include.h"
+#include <PyImathAllocator.h>
+#include <PyImathWorkerPool.h>
+#include <PyImathExport.h>
+#include <Iex.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PyImath {
+
+namespace {
+
+// true while the current thread is executing chunks for a pool, so
+// that a nested dispatchTask() runs serially instead of re-entering.
+thread_local bool inPoolTask = false;
+
+} // namespace
+
+struct WorkStealingPool::Data
+{
+    //
+    // A participant's run of chunk indices [next,end).  The owner and the
+    // thieves all claim chunks with fetch_add, so an index is handed out
+    // exactly once and overshooting end is harmless.  Padded out to a
+    // cache line so that neighbouring counters don't share one.
+    //
+    struct ChunkRun
+    {
+        std::atomic<size_t> next;
+        size_t              end;
+        char                pad[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    };
+
+    size_t                      numWorkers;
+    std::vector<std::thread>    threads;
+    ChunkRun *                  runs;
+
+    std::mutex                  mutex;      // guards generation, stopping and the waits below
+    std::condition_variable     wake;       // signalled when a job is published or on stop
+    std::condition_variable     done;       // signalled when the last thread leaves a job
+    size_t                      generation;
+    bool                        stopping;
+
+    std::atomic<bool>           busy;       // a dispatch is in flight
+    std::atomic<size_t>         active;     // background threads still inside the job
+
+    Task *                      task;
+    size_t                      length;
+    size_t                      chunkSize;
+
+    std::mutex                  errorMutex;
+    std::exception_ptr          error;
+
+    Data () : numWorkers (0), runs (0), generation (0), stopping (false),
+              busy (false), active (0), task (0), length (0), chunkSize (0) {}
+
+    void start (size_t n);
+    void stop ();
+    void workerLoop (size_t id, size_t seen);
+    void runChunks (size_t id);
+    void runChunk (size_t chunk, size_t id);
+    bool acquire (bool wait);
+    void release () { busy.store (false, std::memory_order_release); }
+};
+
+void
+WorkStealingPool::Data::start (size_t n)
+{
+    numWorkers = n < 1 ? 1 : n;
+    runs = new ChunkRun[numWorkers];
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        runs[i].next = 0;
+        runs[i].end = 0;
+    }
+
+    // new threads must not pick up a job published before they existed
+    stopping = false;
+    threads.reserve (numWorkers-1);
+    for (size_t i = 1; i < numWorkers; ++i)
+        threads.push_back (std::thread (&Data::workerLoop, this, i, generation));
+}
+
+void
+WorkStealingPool::Data::stop ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+    threads.clear();
+
+    delete [] runs;
+    runs = 0;
+    numWorkers = 0;
+}
+
+bool
+WorkStealingPool::Data::acquire (bool wait)
+{
+    bool expected = false;
+    while (!busy.compare_exchange_weak (expected, true, std::memory_order_acquire))
+    {
+        if (!wait && expected)
+            return false;
+        expected = false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void
+WorkStealingPool::Data::workerLoop (size_t id, size_t seen)
+{
+    inPoolTask = true;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            wake.wait (lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        runChunks (id);
+
+        if (active.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            done.notify_all();
+        }
+    }
+}
+
+void
+WorkStealingPool::Data::runChunks (size_t id)
+{
+    // drain our own run first, then steal from the others in turn
+    for (size_t k = 0; k < numWorkers; ++k)
+    {
+        ChunkRun &run = runs[(id + k) % numWorkers];
+        for (size_t c = run.next.fetch_add (1); c < run.end; c = run.next.fetch_add (1))
+            runChunk (c, id);
+    }
+}
+
+void
+WorkStealingPool::Data::runChunk (size_t chunk, size_t id)
+{
+    size_t start = chunk * chunkSize;
+    size_t end = start + chunkSize < length ? start + chunkSize : length;
+
+    try
+    {
+        task->execute (start, end, int(id));
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock (errorMutex);
+        if (!error)
+            error = std::current_exception();
+    }
+}
+
+WorkStealingPool::WorkStealingPool (size_t numWorkers)
+    : _data (new Data)
+{
+    _data->start (numWorkers);
+}
+
+WorkStealingPool::~WorkStealingPool ()
+{
+    _data->acquire (true);
+    _data->stop();
+    delete _data;
+}
+
+size_t
+WorkStealingPool::workers () const
+{
+    return _data->numWorkers;
+}
+
+bool
+WorkStealingPool::inWorkerThread () const
+{
+    return inPoolTask;
+}
+
+void
+WorkStealingPool::setWorkers (size_t numWorkers)
+{
+    if (numWorkers < 1)
+        throw IEX_NAMESPACE::ArgExc ("WorkStealingPool needs at least one worker");
+
+    _data->acquire (true);
+    if (numWorkers != _data->numWorkers)
+    {
+        _data->stop();
+        _data->start (numWorkers);
+    }
+    _data->release();
+}
+
+size_t
+WorkStealingPool::defaultWorkers ()
+{
+    size_t n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+void
+WorkStealingPool::dispatch (Task &task, size_t length)
+{
+    size_t numChunks = _data->numWorkers * chunksPerWorker;
+    dispatch (task, length, (length + numChunks - 1) / numChunks);
+}
+
+void
+WorkStealingPool::dispatch (Task &task, size_t length, size_t grain)
+{
+    if (length == 0)
+        return;
+
+    Data *d = _data;
+
+    if (grain >= length || inPoolTask || !d->acquire (false))
+    {
+        task.execute (0, length, 0);
+        return;
+    }
+
+    if (d->numWorkers == 1)
+    {
+        d->release();
+        task.execute (0, length, 0);
+        return;
+    }
+
+    d->task = &task;
+    d->length = length;
+    d->chunkSize = grain < 1 ? 1 : grain;
+    d->error = std::exception_ptr();
+
+    size_t numChunks = (length + d->chunkSize - 1) / d->chunkSize;
+    for (size_t i = 0; i < d->numWorkers; ++i)
+    {
+        d->runs[i].next.store (i * numChunks / d->numWorkers, std::memory_order_relaxed);
+        d->runs[i].end = (i+1) * numChunks / d->numWorkers;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (d->mutex);
+        d->active.store (d->threads.size(), std::memory_order_relaxed);
+        ++d->generation;
+    }
+    d->wake.notify_all();
+
+    // the dispatching thread takes part as worker 0
+    inPoolTask = true;
+    d->runChunks (0);
+    inPoolTask = false;
+
+    {
+        std::unique_lock<std::mutex> lock (d->mutex);
+        d->done.wait (lock, [&] { return d->active.load (std::memory_order_acquire) == 0; });
+    }
+
+    std::exception_ptr error = d->error;
+    d->task = 0;
+    d->error = std::exception_ptr();
+    d->release();
+
+    if (error)
+        std::rethrow_exception (error);
+}
+
+namespace {
+
+WorkStealingPool *pool = 0;
+bool threadingEnabled = false;
+
+void
+shutdownPool ()
+{
+    WorkerPool::setCurrentPool (0);
+    delete pool;
+    pool = 0;
+    threadingEnabled = false;
+}
+
+size_t
+pool_workers ()
+{
+    return pool ? pool->workers() : 1;
+}
+
+void
+pool_setWorkers (size_t numWorkers)
+{
+    if (pool)
+        pool->setWorkers (numWorkers);
+}
+
+bool
+pool_threadingEnabled ()
+{
+    return threadingEnabled;
+}
+
+void
+pool_setThreadingEnabled (bool enabled)
+{
+    threadingEnabled = enabled && pool != 0;
+    WorkerPool::setCurrentPool (threadingEnabled ? pool : 0);
+}
+
+} // namespace
+
+void
+register_WorkerPool (py::module &m)
+{
+    if (!pool)
+    {
+        pool = new WorkStealingPool;
+        pool_setThreadingEnabled (true);
+
+        // join the worker threads while the interpreter is still
+        // intact rather than from a static destructor at unload time
+        py::module::import ("atexit").attr ("register") (py::cpp_function (&shutdownPool));
+    }
+
+    m.def ("workers", &pool_workers,
+        "workers() - return the number of threads (including the calling thread) "
+        "that array operations are split across when threading is enabled");
+    m.def ("setWorkers", &pool_setWorkers,
+        "setWorkers(n) - set the number of threads (including the calling thread) "
+        "that array operations are split across",
+        py::arg ("numWorkers"));
+    m.def ("threadingEnabled", &pool_threadingEnabled,
+        "threadingEnabled() - return True if array operations are run on the worker pool");
+    m.def ("setThreadingEnabled", &pool_setThreadingEnabled,
+        "setThreadingEnabled(b) - turn running array operations on the worker pool on or off",
+        py::arg ("enabled"));
+
+    m.def ("serialThreshold", &serialThreshold,
+        "serialThreshold() - return the cost below which array operations run on the calling thread");
+    m.def ("setSerialThreshold", &setSerialThreshold,
+        "setSerialThreshold(cost) - set the cost (array length times the per-element cost "
+        "of the operation) below which array operations run on the calling thread",
+        py::arg ("cost"));
+    m.def ("minChunkCost", &minChunkCost,
+        "minChunkCost() - return the smallest cost an array operation is split into");
+    m.def ("setMinChunkCost", &setMinChunkCost,
+        "setMinChunkCost(cost) - set the smallest cost an array operation is split into",
+        py::arg ("cost"));
+
+    m.def ("releaseArrayMemoryCache", &releaseArrayMemoryCache,
+        "releaseArrayMemoryCache() - return the array buffers the calling thread keeps "
+        "for reuse to the system");
+}
+
+} // namespace PyImath
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2010-2011, Industrial Light & Magic, a division of Lucas
+// Digital Ltd. LLC
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Industrial Light & Magic nor the names of
+// its contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission. 
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PyImathWorkerPool_h_
+#define _PyImathWorkerPool_h_
+
+#include "python_include.h"
+#include <PyImathExport.h>
+#include <PyImathTask.h>
+
+namespace PyImath {
+
+//
+// WorkStealingPool -- the WorkerPool installed by the imath module.
+//
+// A dispatched range is cut into chunks which are dealt out to the
+// participants (the dispatching thread plus numWorkers-1 background
+// threads) as contiguous runs.  Each participant claims chunks from
+// its own run with an atomic increment, and when that is exhausted
+// steals chunks from the runs of the other participants the same way,
+// so no locks are taken while a task is executing.
+//
+// Only one dispatch runs on the pool at a time; a dispatch issued
+// while the pool is busy (from another thread, or from inside a
+// task) executes serially on the calling thread.
+//
+class PYIMATH_EXPORT WorkStealingPool : public WorkerPool
+{
+  public:
+
+    explicit WorkStealingPool (size_t numWorkers = defaultWorkers());
+    virtual ~WorkStealingPool ();
+
+    virtual size_t workers () const;
+    virtual void   dispatch (Task &task, size_t length);
+    virtual void   dispatch (Task &task, size_t length, size_t grain);
+    virtual bool   inWorkerThread () const;
+
+    // Stop the background threads and restart with numWorkers
+    // participants.  Waits for any dispatch in flight to finish.
+    void           setWorkers (size_t numWorkers);
+
+    // The number of hardware threads, or 1 if that can't be determined.
+    static size_t  defaultWorkers ();
+
+  private:
+
+    WorkStealingPool (const WorkStealingPool &);
+    WorkStealingPool & operator = (const WorkStealingPool &);
+
+    struct Data;
+    Data *         _data;
+};
+
+PYIMATH_EXPORT void register_WorkerPool (py::module &m);
+
+}
+
+#endif
@@ -39,6 +39,7 @@
 #include <ImathFun.h>
 #include <ImathMatrixAlgo.h>
 #include <PyImathFixedArray.h>
+#include <PyImathFixedArrayReduce.h>
 #include <PyImath.h>
 #include <PyImathExport.h>
 #include <PyImathBasicTypes.h>
@@ -50,12 +51,15 @@
 #include <PyImathEuler.h>
 #include <PyImathColor.h>
 #include <PyImathFrustum.h>
+#include <PyImathBVH.h>
 #include <PyImathPlane.h>
 #include <PyImathLine.h>
 #include <PyImathRandom.h>
 #include <PyImathShear.h>
 #include <PyImathMathExc.h>
 #include <PyImathStringArrayRegister.h>
+#include <PyImathTask.h>
+#include <PyImathWorkerPool.h>
 
 
 using namespace PyImath;
@@ -66,11 +70,11 @@ template <typename T>
 IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> >
 computeBoundingBox(const PyImath::FixedArray<IMATH_NAMESPACE::Vec3<T> >& position)
 {
-    IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> > bounds;
-    int len = position.len();
-    for (int i = 0; i < len; ++i)
-        bounds.extendBy(position[i]);
-    return bounds;
+    PyImath::ArrayReduction<IMATH_NAMESPACE::Vec3<T> > r =
+        PyImath::reduceArray<PyImath::REDUCE_MIN|PyImath::REDUCE_MAX>(position);
+    if (r.count == 0)
+        return IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> >();
+    return IMATH_NAMESPACE::Box<IMATH_NAMESPACE::Vec3<T> >(r.min, r.max);
 }
 
 IMATH_NAMESPACE::M44d
@@ -163,6 +167,11 @@ PYBIND11_MODULE(imath, m)
 
     m.doc() = "Imath module";
 
+    //
+    // Worker pool for the dispatched array operations
+    //
+    register_WorkerPool(m);
+
     register_basicTypes(m);
 
     auto iclass2D = IntArray2D::register_(m, "IntArray2D", "Fixed length array of ints");
@@ -361,6 +370,12 @@ PYBIND11_MODULE(imath, m)
     register_FrustumTest<float>(m);
     register_FrustumTest<double>(m);
 
+    //
+    // BVH
+    //
+    register_BVH<float>(m);
+    register_BVH<double>(m);
+
     //
     // Plane
     //
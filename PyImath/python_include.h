@@ -71,21 +71,3 @@ boost::is_class<T>,
     py::return_value_policy<py::copy_const_reference>,
     py::default_call_policies>::type const_call_policy;
 */
-
-#if 1
-namespace PyImath {
-
-    template<typename F>
-    void generate_bindings(py::module &m, F f, const char *name, const char *doc)
-    {
-        m.def(name, f, doc);
-    }
-
-    template<typename C, typename F>
-    void generate_member_bindings(py::class_<C> &c, F f, const char *name, const char *doc)
-    {
-    }
-}
-#else
-#include "PyImathAutovectorize.h"
-#endif
@@ -36,10 +36,13 @@ imath = Extension('imath',
                 sources = [
                     'PyImath/imathmodule.cpp',
                     'PyImath/PyImath.cpp',
+                    'PyImath/PyImathAllocator.cpp',
+                    'PyImath/PyImathAutovectorize.cpp',
                     'PyImath/PyImathBasicTypes.cpp',
                     'PyImath/PyImathBox.cpp',
                     'PyImath/PyImathBox2Array.cpp',
                     'PyImath/PyImathBox3Array.cpp',
+                    'PyImath/PyImathBVH.cpp',
                     'PyImath/PyImathColor3.cpp',
                     'PyImath/PyImathColor4.cpp',
                     'PyImath/PyImathEuler.cpp',
@@ -61,11 +64,13 @@ imath = Extension('imath',
                     'PyImath/PyImathVec2fd.cpp',
                     'PyImath/PyImathVec2si.cpp',
                     'PyImath/PyImathVec3fd.cpp',
+                    'PyImath/PyImathVec3Simd.cpp',
                     'PyImath/PyImathVec3si.cpp',
                     'PyImath/PyImathVec3siArray.cpp',
                     'PyImath/PyImathVec4fd.cpp',
                     'PyImath/PyImathVec4si.cpp',
                     'PyImath/PyImathVec4siArray.cpp',
+                    'PyImath/PyImathWorkerPool.cpp',
                     ],
                 include_dirs = INCLUDE_DIRS+['PyImath'],
                 library_dirs= LIBRARY_DIRS,
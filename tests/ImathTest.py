@@ -169,32 +169,32 @@ def testVectorScalarArithmeticOps(f1, v):
 def testVectorVectorInPlaceArithmeticOps(f1, f2):
     return # ToDo
 
-    f = f1[:]
+    f = f1.copy()
     f += f2
 
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] + f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f -= f2
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] - f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f *= f2
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] * f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f /= f2
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(equalWithAbsError(f[i], f1[i] / f2[i], eps))
 
-    f = f1[:]
+    f = f1.copy()
     f = -f;
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
@@ -203,25 +203,25 @@ def testVectorVectorInPlaceArithmeticOps(f1, f2):
 def testVectorScalarInPlaceArithmeticOps(f1, v):
     return # ToDo
 
-    f = f1[:]
+    f = f1.copy()
     f += v
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] + v)
 
-    f = f1[:]
+    f = f1.copy()
     f -= v
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] - v)
 
-    f = f1[:]
+    f = f1.copy()
     f *= v
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(f[i] == f1[i] * v)
 
-    f = f1[:]
+    f = f1.copy()
     f /= v
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
@@ -250,14 +250,14 @@ def testPowFunctions(f1, f2):
         assert(equalWithRelError(f[i], pow(f1[i], v), eps))
 
     # in-place vector-vector pow
-    f = f1[:]
+    f = f1.copy()
     f **= f2
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
         assert(equalWithRelError(f[i], pow(f1[i], f2[i]), eps))
 
     # in-place vector-scalar pow
-    f = f1[:]
+    f = f1.copy()
     v = f2[0]
     f **= v
     assert(len(f) == len(f1))
@@ -278,7 +278,7 @@ def testModOps(f1, f2):
     for i in range(0, len(f)):
         assert(f[i] == f1[i] %v)
 
-    f = f1[:]
+    f = f1.copy()
     f %= f2
     assert(len(f) == len(f1))
     for i in range(0, len(f)):
@@ -442,27 +442,27 @@ def testVectorVectorMaskedInPlaceArithmeticOps(f1, f2, m):
 
     assert(len(f1) == len(f2))
 
-    f = f1[:]
+    f = f1.copy()
     f[m] += f2
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] + f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] -= f2
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] - f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] *= f2
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] * f2[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] /= f2
     for i in range(0, len(m)):
         if m[i]: assert(equalWithAbsError(f[i], f1[i] / f2[i], eps))
 
-    f = f1[:]
+    f = f1.copy()
     f[m] = -f
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == -f1[i])
@@ -473,7 +473,7 @@ def testVectorVectorMaskedInPlaceArithmeticOps2(f1, f2, m):
     return # ToDo
 
     assert(len(f1[m]) == len(f2))
-    f = f1[:]
+    f = f1.copy()
     f1m = f1[m]
     f[m] += f2
     fm = f[m]
@@ -485,7 +485,7 @@ def testVectorVectorMaskedInPlaceArithmeticOps2(f1, f2, m):
         if m[i] == 0:
             assert(f[i] == f1[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] -= f2
     fm = f[m]
 
@@ -496,7 +496,7 @@ def testVectorVectorMaskedInPlaceArithmeticOps2(f1, f2, m):
         if m[i] == 0:
             assert(f[i] == f1[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] *= f2
     fm = f[m]
 
@@ -507,7 +507,7 @@ def testVectorVectorMaskedInPlaceArithmeticOps2(f1, f2, m):
         if m[i] == 0:
             assert(f[i] == f1[i])
 
-    f = f1[:]
+    f = f1.copy()
     f[m] /= f2
     fm = f[m]
 
@@ -520,25 +520,25 @@ def testVectorVectorMaskedInPlaceArithmeticOps2(f1, f2, m):
 
 def testVectorVectorMaskedArithmeticOps(f1, f2, f3, m):
     return # ToDo
-    f = f3[:]
+    f = f3.copy()
     f[m] = f1[m] + f2[m]
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] + f2[i])
         else:    assert(f[i] == f3[i])
 
-    f = f3[:]
+    f = f3.copy()
     f[m] = f1[m] - f2[m]
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] - f2[i])
         else:    assert(f[i] == f3[i])
 
-    f = f3[:]
+    f = f3.copy()
     f[m] = f1[m] * f2[m]
     for i in range(0, len(m)):
         if m[i]: assert(f[i] == f1[i] * f2[i])
         else:    assert(f[i] == f3[i])
 
-    f = f3[:]
+    f = f3.copy()
     f[m] = f1[m] / f2[m]
     for i in range(0, len(m)):
         if m[i]: assert(equalWithRelError(f[i], f1[i] / f2[i], eps))
@@ -559,7 +559,7 @@ def testUnaryVecMethods(f):
 
     # Normalization only makes sense for these types
     if type(f) in [V2fArray, V2dArray, V3fArray, V3dArray]:
-        g = f[:]
+        g = f.copy()
         g.normalize()
         assert(len(g) == len(f))
         for i in range(0, len(f)):
@@ -790,7 +790,7 @@ def testNonMaskedFloatTypeArray(FloatTypeArray):
     # Test slice operations
 
     # Copy contents of f1
-    f3 = f1[:]
+    f3 = f1.copy()
     assert(len(f3) == len(f1))
 
     for i in range(0, len(f1)):
@@ -895,7 +895,7 @@ def testNonMaskedIntTypeArray(IntTypeArray):
     # Test slice operations
 
     # Copy contents of f1
-    f3 = f1[:]
+    f3 = f1.copy()
     assert(len(f3) == len(f1))
 
     for i in range(0, len(f1)):
@@ -1017,8 +1017,8 @@ def testMaskedFloatTypeArray(FloatTypeArray):
     assert(mf[-1] == mf[len(mf)-1])
     assert(mf[-2] == mf[len(mf)-2])
 
-    # Check that slices copy (not reference) array data
-    s = mf[:]
+    # Check that copies don't reference the array data
+    s = mf.copy()
     assert(len(s) == len(mf))
     for i in range(0, len(mf)):
         assert(s[i] == mf[i])
@@ -1164,8 +1164,8 @@ def testMaskedIntTypeArray(IntTypeArray):
     assert(mf[-1] == mf[len(mf)-1])
     assert(mf[-2] == mf[len(mf)-2])
 
-    # Check that slices copy (not reference) array data
-    s = mf[:]
+    # Check that copies don't reference the array data
+    s = mf.copy()
     assert(len(s) == len(mf))
     for i in range(0, len(mf)):
         assert(s[i] == mf[i])
@@ -1331,7 +1331,7 @@ def testNonMaskedVecTypeArray(VecTypeArray):
     # Test slice operations
 
     # Copy contents of f1
-    f3 = f1[:]
+    f3 = f1.copy()
     assert(len(f3) == len(f1))
 
     for i in range(0, len(f1)):
@@ -1532,8 +1532,8 @@ def testMaskedVecTypeArray(VecTypeArray):
     assert(mf[-1] == mf[len(mf)-1])
     assert(mf[-2] == mf[len(mf)-2])
 
-    # Check that slices copy (not reference) array data
-    s = mf[:]
+    # Check that copies don't reference the array data
+    s = mf.copy()
     assert(len(s) == len(mf))
     for i in range(0, len(mf)):
         assert(s[i] == mf[i])
@@ -8526,6 +8526,1342 @@ def testWstringArray():
 
 testList.append(("testWstringArray",testWstringArray))
 
+def testWorkerPool():
+
+    assert threadingEnabled()
+    assert workers() >= 1
+    numWorkers = workers()
+
+    num = 10000
+    a = V3fArray(num)
+    for i in range(0,num):
+        a[i] = V3f(i, 2*i, 3*i)
+
+    m = M44f().translate(V3f(1, 2, 3))
+
+    setWorkers(4)
+    assert workers() == 4
+    b = m.multVecMatrix(a)
+
+    setThreadingEnabled(False)
+    assert not threadingEnabled()
+    c = m.multVecMatrix(a)
+    setThreadingEnabled(True)
+
+    for i in range(0,num):
+        assert b[i] == c[i]
+        assert b[i] == V3f(i+1, 2*i+2, 3*i+3)
+
+    try:
+        setWorkers(0)   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0        # We shouldn't get here.
+
+    setWorkers(1)
+    d = m.multVecMatrix(a)
+    for i in range(0,num):
+        assert d[i] == c[i]
+
+    setWorkers(numWorkers)
+
+    # force even tiny arrays to be split into single element chunks
+    threshold = serialThreshold()
+    chunkCost = minChunkCost()
+    setSerialThreshold(0)
+    setMinChunkCost(1)
+
+    e = m.multVecMatrix(a[0:7])
+    for i in range(0,7):
+        assert e[i] == c[i]
+
+    setSerialThreshold(threshold)
+    setMinChunkCost(chunkCost)
+    assert serialThreshold() == threshold
+    assert minChunkCost() == chunkCost
+
+    # arrays freed before the cache is dropped don't affect later ones
+    del b, d, e
+    releaseArrayMemoryCache()
+    releaseArrayMemoryCache()
+    f = m.multVecMatrix(a)
+    for i in range(0,num):
+        assert f[i] == c[i]
+
+testList.append(("testWorkerPool",testWorkerPool))
+
+# -------------------------------------------------------------------------
+# Tests for deferred array expressions
+
+def testLazyExpression():
+
+    num = 1000
+    a = V3fArray(num)
+    b = V3fArray(num)
+    s = FloatArray(num)
+    for i in range(0,num):
+        a[i] = V3f(i, 1, 2)
+        b[i] = V3f(1, i % 7, 3)
+        s[i] = i + 1
+
+    e = (a.lazy()*2.0 + b).normalized()
+    assert len(e) == num
+    assert e[-1] == (a[num-1]*2.0 + b[num-1]).normalized()
+
+    r = e.eval()
+    l = (a.lazy()*2.0 + b).length().eval()
+    for i in range(0,num):
+        v = a[i]*2.0 + b[i]
+        assert r[i] == v.normalized()
+        assert equal(l[i], v.length(), 1e-5 * v.length())
+
+    t = ((s.lazy() - 1) * 3 / s).eval()
+    for i in range(0,num):
+        assert equal(t[i], (s[i] - 1) * 3 / s[i], 1e-6)
+
+    # expressions are accepted wherever the array type is
+    c = V3fArray(a.lazy() + b)
+    for i in range(0,num):
+        assert c[i] == a[i] + b[i]
+
+    # deep chains evaluate without growing the stack per level
+    d = s.lazy()
+    for i in range(0,2000):
+        d = d + 1
+    d = d.eval()
+    for i in range(0,num):
+        assert d[i] == s[i] + 2000
+
+    try:
+        a.lazy() + V3fArray(num-1)   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0                   # We shouldn't get here.
+
+testList.append(("testLazyExpression",testLazyExpression))
+
+# -------------------------------------------------------------------------
+# Tests for deferred expressions whose results have an integer type
+
+def testLazyIntegerExpression():
+
+    num = 300
+    c = UnsignedCharArray(num)
+    for i in range(0,num):
+        c[i] = i % 100
+
+    t = (c.lazy() * 2 + 1).eval()
+    for i in range(0,num):
+        assert t[i] == (i % 100) * 2 + 1
+
+    a = V3iArray(num)
+    b = V3sArray(num)
+    for i in range(0,num):
+        a[i] = V3i(i, 1, 2)
+        b[i] = V3s(1, i % 7, 3)
+
+    d = (a.lazy() + a).dot(a).eval()
+    l = (b.lazy() * 2).length2().eval()
+    for i in range(0,num):
+        v = a[i] + a[i]
+        assert d[i] == v.dot(a[i])
+        w = b[i] * 2
+        assert l[i] == w.length2()
+
+testList.append(("testLazyIntegerExpression",testLazyIntegerExpression))
+
+# -------------------------------------------------------------------------
+# Tests for the buffer protocol
+
+def testBufferProtocol():
+
+    num = 10
+    a = V3fArray(num)
+    for i in range(0,num):
+        a[i] = V3f(i, i+1, i+2)
+
+    m = memoryview(a)
+    assert m.format == 'f'
+    assert m.shape == (num, 3)
+    assert m[4,1] == 5
+
+    # the exported buffer shares the array's memory
+    m[4,1] = 100
+    assert a[4] == V3f(4, 100, 6)
+
+    # and so does an array constructed around a buffer
+    b = V3fArray(m)
+    b[2] = V3f(7, 8, 9)
+    assert a[2] == V3f(7, 8, 9)
+
+    # strided slices of the buffer are wrapped as strided arrays
+    c = V3fArray(m[::2])
+    assert len(c) == num//2
+    assert c[1] == a[2]
+
+    # buffers of the wrong type or shape fall back to conversion, or fail
+    d = FloatArray(IntArray(num))
+    assert len(d) == num
+    try:
+        V3fArray(memoryview(FloatArray(num)))   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0                   # We shouldn't get here.
+
+    # masked arrays refuse to export a buffer
+    mask = IntArray(num)
+    mask[1] = 1
+    try:
+        memoryview(a[mask])        # This should raise an exception.
+    except BufferError:
+        pass
+    else:
+        assert 0                   # We shouldn't get here.
+    e = V3fArray(a[mask])
+    assert len(e) == 1
+    assert e[0] == a[1]
+
+    n = M44dArray(2)
+    n[1] = M44d(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16)
+    mn = memoryview(n)
+    assert mn.shape == (2, 4, 4)
+    assert mn[1,2,3] == 12
+
+    g = FloatArray2D(5.0, 3, 2)
+    mg = memoryview(g)
+    assert mg.shape == (2, 3)
+    assert mg[1,2] == 5
+
+    try:
+        import numpy
+    except ImportError:
+        return
+
+    p = numpy.arange(30, dtype=numpy.float32).reshape(10, 3)
+    q = V3fArray(p)
+    q[0] = V3f(-1, -2, -3)
+    assert p[0,2] == -3
+
+    f = FloatArray(p[:,1])
+    assert len(f) == 10
+    assert f[3] == 10
+    assert (numpy.asarray(a)[:,1] == [a[i].y for i in range(0,num)]).all()
+
+testList.append(("testBufferProtocol",testBufferProtocol))
+
+# -------------------------------------------------------------------------
+# Tests for the simd V3fArray/V3dArray kernels
+
+def testVec3ArraySimd():
+
+    random.seed(7)
+    for (Vec, Array) in ((V3f, V3fArray), (V3d, V3dArray)):
+        num = 1003
+        a = Array(num)
+        b = Array(num)
+        for i in range(0,num):
+            a[i] = Vec(random.uniform(-10,10), random.uniform(-10,10), random.uniform(-10,10))
+            b[i] = Vec(random.uniform(-10,10), random.uniform(-10,10), random.uniform(-10,10))
+
+        # zero and tiny vectors take Imath's special cases
+        a[5] = Vec(0, 0, 0)
+        a[40] = Vec(1e-30, 0, 0)
+        a[41] = Vec(0, 1e-40, 0)
+
+        l = a.length()
+        n = a.normalized()
+        d = a.dot(b)
+        c = a.cross(b)
+        for i in range(0,num):
+            assert l[i] == a[i].length()
+            assert n[i] == a[i].normalized()
+            assert d[i] == a[i].dot(b[i])
+            assert c[i] == a[i].cross(b[i])
+
+        d = a.dot(b[7])
+        for i in range(0,num):
+            assert d[i] == a[i].dot(b[7])
+
+        # masked
+        mask = IntArray(num)
+        for i in range(0,num):
+            mask[i] = i % 3
+        m = a[mask]
+        lm = m.length()
+        assert len(lm) == len(m)
+        for i in range(0,len(m)):
+            assert lm[i] == m[i].length()
+        cm = m.cross(b[mask])
+        for i in range(0,len(m)):
+            assert cm[i] == m[i].cross(b[mask][i])
+
+        e = a.copy()
+        e[mask].normalize()
+        for i in range(0,num):
+            if i % 3:
+                assert e[i] == a[i].normalized()
+            else:
+                assert e[i] == a[i]
+
+        # strided
+        s = Array(memoryview(a)[::3])
+        ls = s.length()
+        for i in range(0,len(s)):
+            assert ls[i] == a[3*i].length()
+        f = a.copy()
+        s.normalize()
+        for i in range(0,num):
+            if i % 3:
+                assert a[i] == f[i]
+            else:
+                assert a[i] == f[i].normalized()
+
+testList.append(("testVec3ArraySimd",testVec3ArraySimd))
+
+# -------------------------------------------------------------------------
+# Tests for structure-of-arrays storage
+
+def testArraySoA():
+
+    num = 100
+    a = V3fArray(num)
+    b = V3fArray(num)
+    for i in range(0,num):
+        a[i] = V3f(i, 2*i+1, -i)
+        b[i] = V3f(1, i % 5, 3)
+
+    s = a.toSoA()
+    t = V3fArraySoA(b)
+    assert len(s) == num
+    assert s[7] == a[7]
+    assert s[-1] == a[-1]
+
+    # the component properties share the planes
+    y = s.y
+    assert y[7] == a[7].y
+    y[7] = 42
+    assert s[7].y == 42
+    s[7] = a[7]
+
+    r = (s + t) * 2.0 - V3f(1, 1, 1)
+    c = s * t
+    l = s.length()
+    n = s.normalized()
+    d = s.dot(t)
+    x = s.cross(t)
+    for i in range(0,num):
+        assert r[i] == (a[i] + b[i]) * 2.0 - V3f(1, 1, 1)
+        assert c[i] == a[i] * b[i]
+        assert l[i] == a[i].length()
+        assert n[i] == a[i].normalized()
+        assert d[i] == a[i].dot(b[i])
+        assert x[i] == a[i].cross(b[i])
+
+    s += t
+    s /= 2.0
+    for i in range(0,num):
+        assert s[i] == (a[i] + b[i]) / 2.0
+
+    assert s.min() == s.toAoS().min()
+    assert s.max() == s.toAoS().max()
+    assert s.bounds() == s.toAoS().bounds()
+
+    # an SoA array converts back, and is accepted wherever the
+    # interleaved type is
+    u = V3fArray(s)
+    for i in range(0,num):
+        assert u[i] == s[i]
+    assert (a + s)[3] == a[3] + s[3]
+
+    q = QuatfArray(3)
+    q[1] = Quatf(1, 2, 3, 4)
+    qs = q.toSoA()
+    assert qs.r[1] == 1 and qs.z[1] == 4
+    assert (qs * 2.0)[1] == q[1] * 2.0
+
+    try:
+        s + V3fArraySoA(num-1)   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0                   # We shouldn't get here.
+
+testList.append(("testArraySoA",testArraySoA))
+
+# -------------------------------------------------------------------------
+# Tests for uninitialized array allocation
+
+def testEmptyArray():
+
+    num = 1000
+    a = V3fArray.empty(num)
+    assert len(a) == num
+    a[:] = V3f(1, 2, 3)
+    assert a[num-1] == V3f(1, 2, 3)
+
+    f = FloatArray.empty(0)
+    assert len(f) == 0
+
+    i = IntArray.empty(num)
+    i[:] = 7
+    assert i[num//2] == 7
+
+    c = Color4fArray2D.empty(3, 4)
+    assert c.size() == (3, 4)
+
+    # results built on uninitialized storage must still be complete
+    b = V3fArray(num)
+    for j in range(0,num):
+        b[j] = V3f(j, 0, 0)
+    choice = IntArray(num)
+    choice[0:num:2] = 1
+    r = b.ifelse(choice, a)
+    for j in range(0,num):
+        assert r[j] == (b[j] if j % 2 == 0 else a[j])
+    assert b[10:20][5] == b[15]
+
+    m = M44f().translate(V3f(1, 0, 0))
+    p = m.multVecMatrix(b)
+    for j in range(0,num):
+        assert p[j] == m.multVecMatrix(b[j])
+
+    try:
+        FloatArray.empty(-1)   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0                   # We shouldn't get here.
+
+testList.append(("testEmptyArray",testEmptyArray))
+
+# -------------------------------------------------------------------------
+# Tests for slice views
+
+def testSliceView():
+
+    num = 20
+    a = FloatArray(num)
+    for i in range(0,num):
+        a[i] = i
+
+    # basic slices share the storage of the sliced array
+    s = a[2:12:3]
+    assert len(s) == 4
+    assert s[1] == 5
+    s[1] = 100
+    assert a[5] == 100
+    s[:] = -1
+    assert a[2] == -1 and a[11] == -1 and a[3] == 3
+
+    # slices of slices compose
+    t = a[1:19][::2]
+    assert len(t) == 9
+    assert t[2] == a[5]
+
+    # the view keeps the storage alive
+    v = V3fArray(num)
+    v[7] = V3f(1, 2, 3)
+    w = v[5:10]
+    del v
+    assert w[2] == V3f(1, 2, 3)
+
+    # copy() detaches, as do reversed slices
+    c = a[0:5].copy()
+    c[0] = 42
+    assert a[0] == 0
+    r = a[::-1]
+    r[0] = 42
+    assert a[num-1] == num-1 and r[num-1] == a[0]
+
+    # overlapping assignments read every element before writing
+    b = FloatArray(5)
+    for i in range(0,5):
+        b[i] = i + 1
+    b[1:] = b[:-1]
+    assert [b[i] for i in range(0,5)] == [1, 1, 2, 3, 4]
+    b[1:] += b[:-1]
+    assert [b[i] for i in range(0,5)] == [1, 2, 3, 5, 7]
+
+    # slices of masked references are masked references
+    m = IntArray(num)
+    m[0:num:2] = 1
+    mf = a[m]
+    ms = mf[1:3]
+    ms[0] = 77
+    assert a[2] == 77
+
+testList.append(("testSliceView",testSliceView))
+
+# -------------------------------------------------------------------------
+# Tests for nested masked references
+
+def testNestedMask():
+
+    num = 1000
+    a = IntArray(num)
+    for i in range(0,num):
+        a[i] = i
+
+    # a mask of two long runs
+    m = IntArray(num)
+    m[100:400] = 1
+    m[600:700] = 1
+    ma = a[m]
+    assert len(ma) == 400
+    assert ma[299] == 399 and ma[300] == 600
+
+    # masking a masked reference by its own length selects among its elements
+    m2 = IntArray(len(ma))
+    m2[::100] = 1
+    mb = ma[m2]
+    assert len(mb) == 4
+    assert [mb[i] for i in range(0,4)] == [100, 200, 300, 600]
+
+    # ... and by the unmasked length selects among the storage
+    m3 = a % 3 == 0
+    mc = ma[m3]
+    assert len(mc) == 134
+    for i in range(0,len(mc)):
+        assert mc[i] % 3 == 0 and m[mc[i]]
+
+    # nested references still write through to the storage
+    mb[:] = -1
+    assert a[100] == -1 and a[600] == -1 and a[101] == 101
+    mc[0] = -2
+    assert a[102] == -2
+
+    b = FloatArray(num)
+    for i in range(0,num):
+        b[i] = i
+    mb = b[m][m2]
+    mb *= 2
+    assert b[200] == 400 and b[201] == 201
+
+testList.append(("testNestedMask",testNestedMask))
+
+# -------------------------------------------------------------------------
+# Tests for array reductions
+
+def testArrayReduce():
+
+    num = 100003
+    a = FloatArray(num)
+    for i in range(0,num):
+        a[i] = (i * 7919) % 1000 - 300
+    assert a.min() == -300 and a.max() == 699
+    assert a.bounds() == (-300, 699)
+    assert a.sum() == a.reduce()
+    assert equalWithRelError(a.mean(), a.sum() / num, 1e-5)
+
+    v = V3fArray(num)
+    for i in range(0,num):
+        v[i] = V3f(i % 17 - 3, -(i % 101), i % 5)
+    assert v.min() == V3f(-3, -100, 0)
+    assert v.max() == V3f(13, 0, 4)
+    b = v.bounds()
+    assert b.min() == v.min() and b.max() == v.max()
+    assert v.sum() == V3f(v.x.sum(), v.y.sum(), v.z.sum())
+
+    # strided and masked arrays
+    assert v.y.min() == -100 and v.y.max() == 0
+    m = IntArray(num)
+    m[::2] = 1
+    assert v[m].min() == V3f(-3, -100, 0)
+    assert len(v[m]) == 50002
+
+    # integer means are computed in double
+    vi = V2iArray(5)
+    for i in range(0,5):
+        vi[i] = V2i(i, -i)
+    assert vi.mean() == V2d(2, -2)
+
+    i = IntArray(4)
+    i[0] = 1
+    assert i.mean() == 0.25
+
+    # small integer types are summed without wrapping
+    uc = UnsignedCharArray(2)
+    uc[0] = 200
+    uc[1] = 200
+    assert uc.sum() == 400
+    assert uc.mean() == 200
+    sh = ShortArray(100)
+    sh[:] = 30000
+    assert sh.sum() == 3000000
+    assert sh.mean() == 30000
+
+    # as are integer vectors, whose sums come back as double vectors
+    vs = V3sArray(200)
+    for j in range(0,200):
+        vs[j] = V3s(1000, -1000, 1)
+    assert vs.sum() == V3d(200000, -200000, 200)
+    vi3 = V3iArray(2)
+    vi3[0] = V3i(2000000000, -2000000000, 7)
+    vi3[1] = V3i(2000000000, -2000000000, 7)
+    assert vi3.sum() == V3d(4000000000, -4000000000, 14)
+
+    v4 = V4fArray(3)
+    for j in range(0,3):
+        v4[j] = V4f(j, -j, 2*j, 1)
+    assert v4.bounds() == (V4f(0, -2, 0, 1), V4f(2, 0, 4, 1))
+
+    # empty arrays keep their old min/max/bounds values
+    e = V3fArray(0)
+    assert e.min() == V3f(0) and e.bounds().isEmpty()
+    try:
+        FloatArray(0).mean()
+    except:
+        pass
+    else:
+        assert 0
+
+testList.append(("testArrayReduce",testArrayReduce))
+
+# -------------------------------------------------------------------------
+# Tests for per-element matrix transforms
+
+def testM44ArrayTransform():
+
+    for (MArray, M, VArray, V) in ((M44fArray, M44f, V3fArray, V3f),
+                                   (M44dArray, M44d, V3dArray, V3d),
+                                   (M44fArray, M44f, V3dArray, V3d)):
+        mats = MArray(3)
+        for i in range(0,3):
+            m = M()
+            m.setTranslation(V(10*i, 0, 0))
+            m.scale(V(1, i+1, 1))
+            mats[i] = m
+
+        p = VArray(3)
+        for i in range(0,3):
+            p[i] = V(1, 2, 3)
+        r = mats.multVecMatrix(p)
+        for i in range(0,3):
+            assert r[i] == mats[i].multVecMatrix(p[i])
+        r = mats.multDirMatrix(p)
+        for i in range(0,3):
+            assert r[i] == mats[i].multDirMatrix(p[i])
+
+        # one matrix per index, as in skinning or instancing
+        indices = IntArray(5)
+        indices[0] = 2
+        indices[1] = 0
+        indices[2] = 1
+        indices[3] = 2
+        indices[4] = 2
+        q = VArray(5)
+        for i in range(0,5):
+            q[i] = V(i, 1, 0)
+        r = mats.multVecMatrix(q, indices)
+        for i in range(0,5):
+            assert r[i] == mats[indices[i]].multVecMatrix(q[i])
+        r = mats.multDirMatrix(q, indices)
+        for i in range(0,5):
+            assert r[i] == mats[indices[i]].multDirMatrix(q[i])
+
+        try:
+            mats.multVecMatrix(q)
+        except:
+            pass
+        else:
+            assert 0
+
+        indices[4] = 3
+        try:
+            mats.multVecMatrix(q, indices)
+        except:
+            pass
+        else:
+            assert 0
+
+testList.append(("testM44ArrayTransform",testM44ArrayTransform))
+
+# -------------------------------------------------------------------------
+# Tests for matrix array algebra
+
+def testMatrixArrayAlgebra():
+
+    def M44(M, V, i):
+        m = M()
+        m.rotate(V(0.1*i, 0.2, 0.3*i))
+        m.scale(V(i+1, 1, 2))
+        m.setTranslation(V(i, i+1, i+2))
+        return m
+
+    def M33(M, V, i):
+        m = M()
+        m.rotate(0.1*i)
+        m.scale(V(i+1, 2))
+        m.setTranslation(V(i, i+1))
+        return m
+
+    for (MArray, M, V, FArray, make) in ((M44fArray, M44f, V3f, FloatArray, M44),
+                                         (M44dArray, M44d, V3d, DoubleArray, M44),
+                                         (M33fArray, M33f, V2f, FloatArray, M33),
+                                         (M33dArray, M33d, V2d, DoubleArray, M33)):
+        num = 5
+        a = MArray(num)
+        b = MArray(num)
+        for i in range(0,num):
+            a[i] = make(M, V, i)
+            b[i] = make(M, V, num-i)
+
+        p = a * b
+        for i in range(0,num):
+            assert p[i] == a[i] * b[i]
+        p = a * b[2]
+        for i in range(0,num):
+            assert p[i] == a[i] * b[2]
+        p = b[2] * a
+        for i in range(0,num):
+            assert p[i] == b[2] * a[i]
+
+        c = a.copy()
+        c *= b
+        for i in range(0,num):
+            assert c[i] == a[i] * b[i]
+
+        inv = a.inverse()
+        gj = a.gjInverse()
+        t = a.transposed()
+        d = a.determinant()
+        assert isinstance(d, FArray)
+        for i in range(0,num):
+            assert inv[i] == a[i].inverse()
+            assert gj[i] == a[i].gjInverse()
+            assert t[i] == a[i].transposed()
+            assert d[i] == a[i].determinant()
+            assert (a[i] * inv[i]).equalWithAbsError(M(), 1e-4)
+
+        # singular elements invert to the identity
+        z = M()
+        z.scale(V(0))
+        a[0] = z
+        assert a.inverse()[0] == M()
+
+testList.append(("testMatrixArrayAlgebra",testMatrixArrayAlgebra))
+
+# -------------------------------------------------------------------------
+# Tests for batched matrix decomposition
+
+def testM44ArrayDecompose():
+
+    for (MArray, M, V, EArray) in ((M44fArray, M44f, V3f, EulerfArray),
+                                   (M44dArray, M44d, V3d, EulerdArray)):
+        num = 4
+        mats = MArray(num)
+        for i in range(0,num):
+            m = M()
+            m.translate(V(i, 2*i, 3))
+            m.rotate(V(0.1*i, 0.2, 0.3))
+            m.shear(V(0.1, 0.2*i, 0.3))
+            m.scale(V(1+i, 2, 3))
+            mats[i] = m
+
+        # a singular matrix is reported, not raised
+        z = M()
+        z.scale(V(0, 1, 1))
+        mats[2] = z
+
+        (s, h, r, t, ok) = mats.extractSHRT()
+        assert isinstance(r, EArray)
+        assert list(ok) == [1, 1, 0, 1]
+        for i in (0, 1, 3):
+            sInq = V()
+            hInq = V()
+            rInq = V()
+            tInq = V()
+            mats[i].extractSHRT(sInq, hInq, rInq, tInq)
+            assert s[i] == sInq and h[i] == hInq and t[i] == tInq
+            assert r[i].toXYZVector() == rInq
+            assert r[i].order() == EULER_XYZ
+        assert s[2] == V(0) and h[2] == V(0) and t[2] == V(0)
+
+        (s, ok) = mats.extractScaling()
+        assert list(ok) == [1, 1, 0, 1]
+        for i in (0, 1, 3):
+            sInq = V()
+            mats[i].extractScaling(sInq)
+            assert s[i] == sInq
+
+        (s, h, ok) = mats.extractScalingAndShear()
+        assert list(ok) == [1, 1, 0, 1]
+        for i in (0, 1, 3):
+            sInq = V()
+            hInq = V()
+            mats[i].extractScalingAndShear(sInq, hInq)
+            assert s[i] == sInq and h[i] == hInq
+
+        r = mats.extractEuler(EULER_ZYX)
+        assert isinstance(r, EArray)
+        for i in range(0,num):
+            assert r[i].order() == EULER_ZYX
+        r = mats.extractEuler()
+        assert r[0].order() == EULER_XYZ
+
+        for bad in [lambda: mats.extractEuler(12345),
+                    lambda: mats.extractSHRT(-1),
+                    lambda: EArray(mats, 12345)]:
+            try:
+                bad()   # This should raise an exception.
+            except ValueError:
+                pass
+            else:
+                assert 0   # We shouldn't get here.
+
+testList.append(("testM44ArrayDecompose",testM44ArrayDecompose))
+
+# -------------------------------------------------------------------------
+# Tests for quat array interpolation
+
+def testQuatArrayInterpolation():
+
+    for (QArray, Q, V, FArray) in ((QuatfArray, Quatf, V3f, FloatArray),
+                                   (QuatdArray, Quatd, V3d, DoubleArray)):
+        num = 5
+        a = QArray(num)
+        b = QArray(num)
+        t = FArray(num)
+        for i in range(0,num):
+            q = Q()
+            q.setAxisAngle(V(1, 0, 0), 0.2*i)
+            a[i] = q
+            q = Q()
+            q.setAxisAngle(V(0, 1, 0), 0.3*i + 0.1)
+            b[i] = q
+            t[i] = 0.2*i
+
+        r = a.slerp(b, t)
+        for i in range(0,num):
+            assert r[i] == a[i].slerp(b[i], t[i])
+        r = a.slerp(b[1], 0.25)
+        for i in range(0,num):
+            assert r[i] == a[i].slerp(b[1], 0.25)
+        r = a.slerpShortestArc(b, 0.5)
+        assert len(r) == num
+
+        c = QArray(num)
+        for i in range(0,num):
+            c[i] = a[i] * 2
+        n = c.normalized()
+        for i in range(0,num):
+            assert n[i] == c[i].normalized()
+        c.normalize()
+        for i in range(0,num):
+            assert c[i] == n[i]
+
+        # keys are hit at whole t and t is clamped to the keys
+        s = FArray(6)
+        s[0] = -1
+        s[1] = 0
+        s[2] = 1.5
+        s[3] = 2
+        s[4] = 3.75
+        s[5] = 10
+        r = a.squad(s)
+        assert r[0] == a[0] and r[1] == a[0] and r[5] == a[num-1]
+        assert abs((r[3] ^ a[2]) - 1) < 1e-5
+        for i in range(0,len(s)):
+            assert abs((r[i] ^ a.squad(s[i])) - 1) < 1e-5
+            assert equalWithAbsError(r[i].length(), 1, 1e-5)
+
+        # fractional t against squad computed by hand, on keys that
+        # don't share an axis
+        k = QArray(num)
+        for i in range(0,num):
+            q = Q()
+            q.setAxisAngle(V(1, i, 0.5*i*i).normalized(), 0.4*i + 0.1)
+            k[i] = q
+
+        def intermediate(q0, q1, q2):
+            q1inv = q1.inverse()
+            c = -0.25 * ((q1inv * q0).log() + (q1inv * q2).log())
+            return (q1 * c.exp()).normalized()
+
+        def squad(t):
+            i = int(t)
+            u = t - i
+            qa = intermediate(k[max(i-1, 0)], k[i], k[i+1])
+            qb = intermediate(k[i], k[i+1], k[min(i+2, num-1)])
+            return k[i].slerp(k[i+1], u).slerp(qa.slerp(qb, u), 2*u*(1-u))
+
+        f = FArray(4)
+        f[0] = 0.3
+        f[1] = 1.5
+        f[2] = 2.25
+        f[3] = 3.8
+        r = k.squad(f)
+        for i in range(0,len(f)):
+            assert abs(abs(r[i] ^ squad(f[i])) - 1) < 1e-5
+            assert abs(abs(k.squad(f[i]) ^ squad(f[i])) - 1) < 1e-5
+
+        # the spline is continuous through each key
+        eps = 1e-3
+        for i in range(1,num-1):
+            before = k.squad(i - eps)
+            after = k.squad(i + eps)
+            assert abs(abs(before ^ k[i]) - 1) < 1e-5
+            assert abs(abs(after ^ k[i]) - 1) < 1e-5
+
+testList.append(("testQuatArrayInterpolation",testQuatArrayInterpolation))
+
+# -------------------------------------------------------------------------
+# Tests for rotation array conversions
+
+def testRotationArrayConversions():
+
+    for (QArray, Q, EArray, E, V) in ((QuatfArray, Quatf, EulerfArray, Eulerf, V3f),
+                                      (QuatdArray, Quatd, EulerdArray, Eulerd, V3d)):
+        num = 4
+        q = QArray(num)
+        for i in range(0,num):
+            r = Q()
+            r.setAxisAngle(V(1, 2, 3).normalized(), 0.3*i + 0.1)
+            q[i] = r
+
+        m33 = q.toMatrix33()
+        m44 = q.toMatrix44()
+        for i in range(0,num):
+            assert m33[i] == q[i].toMatrix33()
+            assert m44[i] == q[i].toMatrix44()
+
+        q44 = QArray(m44)
+        q33 = QArray(m33)
+        for i in range(0,num):
+            assert abs(abs(q44[i] ^ q[i]) - 1) < 1e-5
+            assert abs(abs(q33[i] ^ q[i]) - 1) < 1e-5
+
+        for order in (EULER_XYZ, EULER_ZYX, EULER_YZX, EULER_XZY):
+            e = EArray(q, order)
+            em = EArray(m44, order)
+            e3 = EArray(m33, order)
+            for i in range(0,num):
+                assert e[i].order() == order and em[i].order() == order and e3[i].order() == order
+                x = E(q[i], order)
+                assert e[i] == x
+                assert em[i].toXYZVector().equalWithAbsError(x.toXYZVector(), 1e-5)
+                assert e3[i].toXYZVector().equalWithAbsError(x.toXYZVector(), 1e-5)
+
+            eq = e.toQuat()
+            e44 = e.toMatrix44()
+            e33 = e.toMatrix33()
+            for i in range(0,num):
+                assert eq[i] == e[i].toQuat()
+                assert e44[i] == e[i].toMatrix44()
+                assert e33[i] == e[i].toMatrix33()
+                assert e44[i].equalWithAbsError(m44[i], 1e-5)
+
+        # the default order is still XYZ
+        e = EArray(m44)
+        assert e[0].order() == EULER_XYZ
+
+testList.append(("testRotationArrayConversions",testRotationArrayConversions))
+
+# -------------------------------------------------------------------------
+# Tests for batched frustum culling
+
+def testFrustumCulling():
+
+    for (FrustumTest, Frustum, M, V, B, BArray, VArray, FArray) in \
+            ((FrustumTestf, Frustumf, M44f, V3f, Box3f, Box3fArray, V3fArray, FloatArray),
+             (FrustumTestd, Frustumd, M44d, V3d, Box3d, Box3dArray, V3dArray, DoubleArray)):
+        # the default frustum looks down -z
+        ft = FrustumTest(Frustum(), M())
+
+        num = 6
+        boxes = BArray(num)
+        centers = VArray(num)
+        radii = FArray(num)
+        z = (-10, 10, -10, -2000, -10, 5)
+        x = (0, 0, 500, 0, 3, 0)
+        for i in range(0,num):
+            centers[i] = V(x[i], 0, z[i])
+            radii[i] = 0.5
+            boxes[i] = B(V(x[i]-0.5, -0.5, z[i]-0.5), V(x[i]+0.5, 0.5, z[i]+0.5))
+        radii[5] = 6
+
+        m = ft.isVisible(boxes)
+        for i in range(0,num):
+            assert m[i] == ft.isVisible(boxes[i])
+        assert list(m) == [1, 0, 0, 0, 1, 0]
+        assert list(ft.visibleIndices(boxes)) == [0, 4]
+
+        m = ft.isVisible(centers, radii)
+        assert list(m) == [1, 0, 0, 0, 1, 1]
+        assert list(ft.visibleIndices(centers, radii)) == [0, 4, 5]
+
+        points = V3fArray(num)
+        for i in range(0,num):
+            points[i] = V3f(centers[i])
+        assert list(ft.visibleIndices(points)) == [i for i in range(0,num) if ft.isVisible(points)[i]]
+
+        try:
+            ft.isVisible(centers, FArray(num-1))
+        except:
+            pass
+        else:
+            assert 0
+
+testList.append(("testFrustumCulling",testFrustumCulling))
+
+# -------------------------------------------------------------------------
+# Tests for the bounding volume hierarchy
+
+def testBVH():
+
+    for (BVH, FrustumTest, Frustum, M, V, B, L, BArray, VArray) in \
+            ((BVHf, FrustumTestf, Frustumf, M44f, V3f, Box3f, Line3f, Box3fArray, V3fArray),
+             (BVHd, FrustumTestd, Frustumd, M44d, V3d, Box3d, Line3d, Box3dArray, V3dArray)):
+        num = 300
+        boxes = BArray(num)
+        for i in range(0,num):
+            c = V(random.uniform(-50,50), random.uniform(-50,50), random.uniform(-50,50))
+            boxes[i] = B(c - V(0.5), c + V(0.5))
+
+        bvh = BVH(boxes)
+        assert len(bvh) == num
+        assert bvh.nodeCount() > 0
+        bounds = bvh.bounds()
+        for i in range(0,num):
+            assert bounds.intersects(boxes[i])
+
+        # box overlap matches brute force
+        for q in range(0,10):
+            c = V(random.uniform(-50,50), random.uniform(-50,50), random.uniform(-50,50))
+            query = B(c - V(10), c + V(10))
+            expected = [i for i in range(0,num) if query.intersects(boxes[i])]
+            assert list(bvh.intersect(query)) == expected
+
+        # a ray along x through the middle of the first box
+        c = boxes[0].center()
+        ray = L(V(-100, c.y, c.z), V(100, c.y, c.z))
+        hits = list(bvh.intersectRay(ray))
+        assert 0 in hits
+        for i in hits:
+            assert boxes[i].min.y <= c.y <= boxes[i].max.y
+            assert boxes[i].min.z <= c.z <= boxes[i].max.z
+
+        # frustum queries match the per box test
+        ft = FrustumTest(Frustum(), M())
+        expected = [i for i in range(0,num) if ft.isVisible(boxes[i])]
+        assert list(bvh.visible(ft)) == expected
+
+        # refit after moving everything
+        for i in range(0,num):
+            boxes[i] = B(boxes[i].min + V(1000,0,0), boxes[i].max + V(1000,0,0))
+        bvh.refit(boxes)
+        assert bvh.bounds().min.x > 900
+        assert len(bvh.intersect(B(V(900,-100,-100), V(1100,100,100)))) == num
+        assert len(bvh.intersect(B(V(-100), V(100)))) == 0
+
+        try:
+            bvh.refit(BArray(num-1))
+        except:
+            pass
+        else:
+            assert 0
+
+        # points are degenerate boxes
+        points = VArray(10)
+        for i in range(0,10):
+            points[i] = V(i, 0, 0)
+        bvh = BVH(points)
+        assert list(bvh.intersect(B(V(2.5,-1,-1), V(5,1,1)))) == [3, 4, 5]
+
+        assert len(BVH(BArray(0)).intersect(B(V(0), V(1)))) == 0
+
+testList.append(("testBVH",testBVH))
+
+# -------------------------------------------------------------------------
+# Tests for bulk StringArray construction, comparison and isin
+
+def testStringArrayBulk():
+
+    names = ['body', 'arm', 'leg', 'arm', 'head', 'leg', 'arm']
+    s = StringArray(names)
+    assert len(s) == len(names)
+    for i in range(0,len(names)):
+        assert s[i] == names[i]
+
+    assert list(s == 'arm') == [1 if n == 'arm' else 0 for n in names]
+    assert list(s != 'arm') == [0 if n == 'arm' else 1 for n in names]
+    assert list(s == 'missing') == [0] * len(names)
+    assert list(s != 'missing') == [1] * len(names)
+
+    # arrays with different string tables compare by value
+    other = StringArray(['body', 'leg', 'leg', 'arm', 'tail', 'leg', 'head'])
+    assert list(s == other) == [1, 0, 1, 1, 0, 1, 0]
+    assert list(s != other) == [0, 1, 0, 0, 1, 0, 1]
+    assert list(s == s) == [1] * len(names)
+
+    assert list(s.isin(set(['arm', 'head', 'tail']))) == [0, 1, 0, 1, 1, 0, 1]
+    assert list(s.isin(['nothing'])) == [0] * len(names)
+    assert list(s.isin(StringArray(['leg', 'tail']))) == [0, 0, 1, 0, 0, 1, 0]
+
+    b = StringArray.fromBuffer(b'/a/b\0/a/c\0/a/b\0')
+    assert len(b) == 3
+    assert b[0] == '/a/b' and b[1] == '/a/c' and b[2] == '/a/b'
+
+    b = StringArray.fromBuffer(b'x\ny\nz', '\n')
+    assert len(b) == 3
+    assert b[2] == 'z'
+
+    assert len(StringArray([])) == 0
+    assert len(StringArray.fromBuffer(b'')) == 0
+
+    try:
+        StringArray.fromBuffer(memoryview(b'a\0b\0c')[::2])   # This should raise an exception.
+    except:
+        pass
+    else:
+        assert 0   # We shouldn't get here.
+
+    w = WstringArray([u'a', u'b', u'a'])
+    assert list(w == u'a') == [1, 0, 1]
+    assert list(w.isin([u'b'])) == [0, 1, 0]
+
+testList.append(("testStringArrayBulk",testStringArrayBulk))
+
+# -------------------------------------------------------------------------
+# Tests for StringArray dictionary encoding and concatenation
+
+def testStringArrayDictionary():
+
+    s = StringArray(['/a', '/b', '/a', '/c', '/b'])
+    s[3] = '/a'
+    strings, codes = s.toDictionary()
+    # '/c' is no longer used, so it isn't exported
+    assert strings == ['/a', '/b']
+    assert list(codes) == [0, 1, 0, 0, 1]
+
+    t = StringArray.fromDictionary(strings, codes)
+    assert len(t) == len(s)
+    assert list(t == s) == [1] * len(s)
+
+    # repeated dictionary entries are folded together
+    t2 = StringArray.fromDictionary(['x', 'y', 'x'], codes)
+    assert [t2[i] for i in range(0,len(t2))] == ['y' if c == 1 else 'x' for c in codes]
+    assert list(t2 == 'x') == [1 if c != 1 else 0 for c in codes]
+
+    bad = IntArray(2)
+    bad[1] = 3
+    try:
+        StringArray.fromDictionary(['x', 'y'], bad)
+    except:
+        pass
+    else:
+        assert 0
+
+    a = StringArray(['/a', '/b'])
+    b = StringArray(['/c', '/a', '/d'])
+    c = a.concatenate(b)
+    assert [c[i] for i in range(0,len(c))] == ['/a', '/b', '/c', '/a', '/d']
+    assert list(c == '/a') == [1, 0, 0, 1, 0]
+
+    c = a.concatenate(a)
+    assert [c[i] for i in range(0,len(c))] == ['/a', '/b', '/a', '/b']
+
+    w = WstringArray([u'a', u'b'])
+    strings, codes = w.concatenate(WstringArray([u'c'])).toDictionary()
+    assert strings == [u'a', u'b', u'c']
+    assert list(codes) == [0, 1, 2]
+
+testList.append(("testStringArrayDictionary",testStringArrayDictionary))
+
+# -------------------------------------------------------------------------
+# Tests for the string table behind StringArray
+
+def testStringTableIntern():
+
+    # a batch is de-duplicated, and new strings are numbered in the order
+    # they are first seen
+    s = StringArray(['c', 'a', 'c', 'b', 'a', 'c'])
+    strings, codes = s.toDictionary()
+    assert strings == ['c', 'a', 'b']
+    assert list(codes) == [0, 1, 0, 2, 1, 0]
+
+    # interning more strings keeps the indices of the ones already there
+    s[1] = 'd'
+    s[3] = 'c'
+    strings, codes = s.toDictionary()
+    assert strings == ['c', 'a', 'd']
+    assert list(codes) == [0, 2, 0, 0, 1, 0]
+
+    # a large batch with repeats, big enough to be interned in parallel
+    # and to grow the hash table many times over
+    num = 20000
+    distinct = 3000
+    names = ['/root/node%d' % ((i * 7919) % distinct) for i in range(0,num)]
+    b = StringArray(names)
+    strings, codes = b.toDictionary()
+    assert len(strings) == distinct
+    first = []
+    seen = set()
+    for n in names:
+        if n not in seen:
+            seen.add(n)
+            first.append(n)
+    assert strings == first
+    for i in range(0,num,97):
+        assert b[i] == names[i]
+        assert strings[codes[i]] == names[i]
+
+    # lookups still find every string after the table has been rehashed
+    for n in ['/root/node0', '/root/node1234', '/root/node2999']:
+        assert list(b == n) == [1 if m == n else 0 for m in names]
+    assert list(b == '/root/node3000') == [0] * num
+    b[0] = '/root/node17'
+    assert b[0] == '/root/node17'
+    assert len(b.toDictionary()[0]) == distinct
+
+testList.append(("testStringTableIntern",testStringTableIntern))
+
+# -------------------------------------------------------------------------
+# Tests for VIntArray's flat storage
+
+def testVIntArrayStorage():
+
+    def intArray(values):
+        a = IntArray(len(values))
+        for i in range(0,len(values)):
+            a[i] = values[i]
+        return a
+
+    # face vertex counts and indices of a quad, a triangle and a quad
+    v = VIntArray(intArray([4, 3, 4]), intArray([0,1,2,3, 1,4,2, 4,5,6,2]))
+    assert len(v) == 3
+    assert list(v.counts()) == [4, 3, 4]
+    assert list(v.offsets()) == [0, 4, 7, 11]
+    assert list(v.values()) == [0,1,2,3, 1,4,2, 4,5,6,2]
+
+    # values() shares the storage
+    flat = v.values()
+    flat[0] = 10
+    assert v.values()[0] == 10
+
+    # offsets() is a copy, so changing it leaves the items alone
+    o = v.offsets()
+    o[1] = 0
+    o[3] = 100
+    assert list(v.offsets()) == [0, 4, 7, 11]
+    assert list(v.counts()) == [4, 3, 4]
+    assert list(v.values())[0:4] == [10, 1, 2, 3]
+
+    s = v[1:]
+    assert list(s.counts()) == [3, 4]
+    assert list(s.values()) == [1,4,2, 4,5,6,2]
+
+    # assignments that keep the item lengths and ones that don't
+    v[0:1] = VIntArray(intArray([4]), intArray([9,8,7,6]))
+    assert list(v.values()) == [9,8,7,6, 1,4,2, 4,5,6,2]
+    v[1:2] = VIntArray(intArray([1]), intArray([0]))
+    assert list(v.counts()) == [4, 1, 4]
+    assert list(v.values()) == [9,8,7,6, 0, 4,5,6,2]
+
+    mask = intArray([1, 0, 1])
+    v[mask] = VIntArray(intArray([2, 0]), intArray([3, 3]))
+    assert list(v.counts()) == [2, 1, 0]
+    assert list(v.values()) == [3, 3, 0]
+
+    w = VIntArray(5, 3)
+    assert list(w.counts()) == [1, 1, 1]
+    c = v.ifelse(intArray([0, 1, 0]), w)
+    assert list(c.counts()) == [1, 1, 1]
+    assert list(c.values()) == [5, 0, 5]
+
+    # masked references write through to the array they came from
+    m = v[intArray([0, 1, 1])]
+    assert list(m.counts()) == [1, 0]
+    m[0:2] = VIntArray(intArray([1, 1]), intArray([7, 8]))
+    assert list(v.counts()) == [2, 1, 1]
+    assert list(v.values()) == [3, 3, 7, 8]
+
+    try:
+        VIntArray(intArray([2, 2]), intArray([1, 2, 3]))
+    except:
+        pass
+    else:
+        assert 0
+
+    assert list(VIntArray(3).counts()) == [0, 0, 0]
+
+testList.append(("testVIntArrayStorage",testVIntArrayStorage))
+
+# -------------------------------------------------------------------------
+# Tests for segmented reductions, gather and scatterAdd on variable arrays
+
+def testVArraySegmentOps():
+
+    def intArray(values):
+        a = IntArray(len(values))
+        for i in range(0,len(values)):
+            a[i] = values[i]
+        return a
+
+    # two triangles, an empty face and a quad over five points
+    faces = VIntArray(intArray([3, 3, 0, 4]), intArray([0,1,2, 0,2,3, 1,2,3,4]))
+    assert list(faces.sum()) == [3, 5, 0, 10]
+    assert list(faces.min()) == [0, 0, 0, 1]
+    assert list(faces.max()) == [2, 3, 0, 4]
+    assert list(faces.mean()) == [1.0, 5.0/3.0, 0.0, 2.5]
+
+    P = V3fArray(5)
+    P[0] = V3f(0, 0, 0)
+    P[1] = V3f(1, 0, 0)
+    P[2] = V3f(1, 1, 0)
+    P[3] = V3f(0, 1, 0)
+    P[4] = V3f(0, 2, 0)
+
+    # face centroids
+    corners = faces.gather(P)
+    assert list(corners.counts()) == [3, 3, 0, 4]
+    centroids = corners.mean()
+    assert len(centroids) == 4
+    assert equalWithAbsError(centroids[0], V3f(2.0/3.0, 1.0/3.0, 0), 1e-6)
+    assert centroids[2] == V3f(0, 0, 0)
+    assert equalWithAbsError(centroids[3], V3f(0.5, 1, 0), 1e-6)
+    assert corners.max()[3] == V3f(1, 2, 0)
+
+    # area weighted vertex normals of the two triangles
+    tris = VIntArray(intArray([3, 3]), intArray([0,1,2, 0,2,3]))
+    tp = tris.gather(P).values()
+    a = tp[0::3]
+    b = tp[1::3]
+    c = tp[2::3]
+    fn = (b - a).cross(c - a)
+    N = tris.scatterAdd(fn, 5)
+    assert N[0] == V3f(0, 0, 2)
+    assert N[1] == V3f(0, 0, 1)
+    assert N[4] == V3f(0, 0, 0)
+
+    # per corner values
+    ones = VIntArray(intArray([3, 3, 0, 4]), intArray([1,1,1, 1,1,1, 1,1,1,1]))
+    assert list(faces.scatterAdd(ones, 5)) == [2, 2, 3, 2, 1]
+
+    F = VFloatArray(intArray([2, 1]), FloatArray(3))
+    assert list(F.sum()) == [0.0, 0.0]
+
+    # item sums are accumulated wide, like the sum of the flat values
+    big = VIntArray(intArray([2, 1]), intArray([2000000000, 2000000000, 5]))
+    assert isinstance(big.sum(), DoubleArray)
+    assert list(big.sum()) == [4000000000, 5]
+    assert big.sum()[0] + big.sum()[1] == big.values().sum()
+
+    for bad in [lambda: faces.gather(V3fArray(4)),
+                lambda: tris.scatterAdd(fn, 3),
+                lambda: faces.scatterAdd(tris, 5)]:
+        try:
+            bad()
+        except:
+            pass
+        else:
+            assert 0
+
+testList.append(("testVArraySegmentOps",testVArraySegmentOps))
+
 '''
 # -------------------------------------------------------------------------
 # Main loop
@@ -8602,6 +9938,28 @@ ImathTest=unittest.TestSuite([
     unittest.FunctionTestCase(testMatrixArray),
     unittest.FunctionTestCase(testStringArray),
     unittest.FunctionTestCase(testWstringArray),
+    unittest.FunctionTestCase(testWorkerPool),
+    unittest.FunctionTestCase(testLazyExpression),
+    unittest.FunctionTestCase(testLazyIntegerExpression),
+    unittest.FunctionTestCase(testBufferProtocol),
+    unittest.FunctionTestCase(testVec3ArraySimd),
+    unittest.FunctionTestCase(testArraySoA),
+    unittest.FunctionTestCase(testEmptyArray),
+    unittest.FunctionTestCase(testSliceView),
+    unittest.FunctionTestCase(testNestedMask),
+    unittest.FunctionTestCase(testArrayReduce),
+    unittest.FunctionTestCase(testM44ArrayTransform),
+    unittest.FunctionTestCase(testMatrixArrayAlgebra),
+    unittest.FunctionTestCase(testM44ArrayDecompose),
+    unittest.FunctionTestCase(testQuatArrayInterpolation),
+    unittest.FunctionTestCase(testRotationArrayConversions),
+    unittest.FunctionTestCase(testFrustumCulling),
+    unittest.FunctionTestCase(testBVH),
+    unittest.FunctionTestCase(testStringArrayBulk),
+    unittest.FunctionTestCase(testStringArrayDictionary),
+    unittest.FunctionTestCase(testStringTableIntern),
+    unittest.FunctionTestCase(testVIntArrayStorage),
+    unittest.FunctionTestCase(testVArraySegmentOps),
     ])
 
 if __name__ == '__main__':